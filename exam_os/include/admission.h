@@ -0,0 +1,15 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "shared.h"
+#include "histogram.h"
+#include "snapshot.h"
+
+void admission_init(SimContext *ctx);
+void admission_destroy(SimContext *ctx);
+void admission_tick(SimContext *ctx, int tick);   // generate this tick's logins + admit
+const Histogram *admission_wait_hist(SimContext *ctx);
+void admission_snapshot(SimContext *ctx, SnapWriter *w);
+void admission_restore(SimContext *ctx, SnapReader *r);
+
+#endif // ADMISSION_H
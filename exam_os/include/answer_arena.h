@@ -0,0 +1,19 @@
+#ifndef ANSWER_ARENA_H
+#define ANSWER_ARENA_H
+
+#include "shared.h"
+
+// Slab arena for answer text. Producers bump-allocate into the current
+// 64 KB slab with one atomic add and the ring carries only an
+// AnswerRef. The flusher releases answers in bulk once written; a
+// retired slab whose last answer is released goes back on the free
+// list whole, so there is no per-answer free.
+
+void        arena_init(AnswerArena *a);
+void        arena_destroy(AnswerArena *a);
+int         arena_put(AnswerArena *a, const char *text, AnswerRef *out);   // -1: exhausted
+const char *arena_get(const AnswerArena *a, AnswerRef ref);
+void        arena_release(AnswerArena *a, const int *slabs, int n);         // slab of each answer
+int         arena_slabs(const AnswerArena *a);                              // allocated so far
+
+#endif // ANSWER_ARENA_H
@@ -0,0 +1,10 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "shared.h"
+
+// Offline microbenchmarks, run via `./exam_os --bench NAME`.
+// Returns 0 on success, -1 if NAME is unknown.
+int bench_run(const char *name);
+
+#endif // BENCH_H
@@ -6,7 +6,9 @@
 // Parse config file + override with CLI args
 void config_load_defaults(Config *cfg);
 int  config_parse_file(Config *cfg, const char *filepath);
+int  config_set(Config *cfg, const char *key, const char *val);   // 0 if unknown
 void config_parse_args(Config *cfg, int argc, char *argv[]);
+int  config_check(const Config *cfg);   // -1, with a message, if a run would stall
 void config_print(Config *cfg);
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -3,8 +3,19 @@
 
 #include "shared.h"
 
-void  dashboard_init();
-void  dashboard_shutdown();
-void *dashboard_thread(void *arg);
+// ncurses owns the one terminal, so at most one context per process
+// runs a dashboard; the others run headless
+void  dashboard_init(SimContext *ctx);
+void  dashboard_shutdown(SimContext *ctx);
+void  dashboard_destroy(SimContext *ctx);
+void *dashboard_thread(void *arg);     // arg: the SimContext; RUNTIME = THREADS
 
-#endif // DASHBOARD_H
\ No newline at end of file
+// ─── Driven from an event loop ───────────────────────────
+// The reactor draws on its own timer and calls dashboard_input when
+// stdin is readable instead of running dashboard_thread
+int   dashboard_open(SimContext *ctx);     // 0, or -1 if the terminal can't
+void  dashboard_draw(SimContext *ctx);     // one refresh of every panel
+int   dashboard_input(SimContext *ctx);    // 1 once 'q' has ended the run
+void  dashboard_close(SimContext *ctx);
+
+#endif // DASHBOARD_H
@@ -0,0 +1,24 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Log-linear latency histogram: exact below 16, then 8 sub-buckets
+// per power of two (~12% resolution). Recording is lock-free so it
+// can sit on any hot path; readers get a slightly racy but
+// monotonic view, which is fine for dashboards and reports.
+
+#define HIST_BUCKETS 512
+
+typedef struct {
+    long counts[HIST_BUCKETS];
+    long count;
+    long sum;
+    long max;
+} Histogram;
+
+void hist_reset(Histogram *h);
+void hist_record(Histogram *h, long value);
+void hist_record_n(Histogram *h, long value, long n);   // n samples of value
+long hist_percentile(const Histogram *h, double pct);
+long hist_mean(const Histogram *h);
+
+#endif // HISTOGRAM_H
@@ -2,6 +2,8 @@
 #define INTERRUPT_H
 
 #include "shared.h"
+#include "histogram.h"
+#include "snapshot.h"
 
 // Interrupt IDs
 #define INT_EXAM_TIMEOUT    0
@@ -9,8 +11,35 @@
 #define INT_PAGE_FAULT      2
 #define INT_SUBMIT_COMPLETE 3
 
-void  interrupt_init();
-void  interrupt_raise(int interrupt_id, int pid);
-void *interrupt_thread(void *arg);
+// Priority levels (higher = more urgent, dispatched first)
+#define INT_PRIO_INFO       0
+#define INT_PRIO_NORMAL     1
+#define INT_PRIO_HIGH       2
+#define INT_PRIO_CRITICAL   3
+
+typedef struct {
+    int  priority;
+    long raised;
+    long handled;
+    long coalesced;
+    long overflows;
+} InterruptStats;
+
+void  interrupt_init(SimContext *ctx);        // also creates ctx->wheel
+void  interrupt_shutdown(SimContext *ctx);
+int   interrupt_raise(SimContext *ctx, int interrupt_id, int pid);
+void *interrupt_thread(void *arg);             // arg: the SimContext
+void  interrupt_step(SimContext *ctx, int tick);  // TICK_INTERRUPTS
+void  interrupt_mask_level(SimContext *ctx, int level);
+void  interrupt_unmask_level(SimContext *ctx, int level);
+void  interrupt_vector_stats(SimContext *ctx, int interrupt_id, InterruptStats *out);
+void  interrupt_snapshot(SimContext *ctx, SnapWriter *w);
+void  interrupt_restore(SimContext *ctx, SnapReader *r);
+
+// Latency in µs: raise → top half, raise → deferred bottom half done
+const Histogram *interrupt_dispatch_hist(SimContext *ctx, int interrupt_id);
+const Histogram *interrupt_bh_hist(SimContext *ctx, int interrupt_id);
+const Histogram *interrupt_timeout_batch_hist(SimContext *ctx);   // bulk timeout path, µs
+const char      *interrupt_name(SimContext *ctx, int interrupt_id);
 
 #endif // INTERRUPT_H
\ No newline at end of file
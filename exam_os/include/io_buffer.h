@@ -2,10 +2,98 @@
 #define IO_BUFFER_H
 
 #include "shared.h"
+#include "submission_store.h"
+#include "snapshot.h"
 
-void  io_buffer_init();
-void  io_buffer_shutdown();
-int   io_buffer_submit(int pid, int question_id, const char *answer, int is_partial);
-void *io_buffer_thread(void *arg);
+// Submit-path figures for the final report
+typedef struct {
+    long submitted;
+    long dropped;
+    long p50_ns, p99_ns;     // enqueue latency, all submits
+    long storm_count;        // demo storm: submissions attempted
+    long storm_ns;           //   wall time for the whole storm
+    long storm_p99_ns;       //   enqueue p99 during the storm
+    long delayed;            // BLOCK: submits that waited for a slot
+    long wait_p50_us, wait_p99_us, wait_max_us;   // their added latency
+    long coalesced;          // COALESCE: replaced a still-queued answer
+} IOSubmitStats;
 
-#endif // IO_BUFFER_H
\ No newline at end of file
+// Flush-path figures for the final report
+typedef struct {
+    long size_p50, size_p99, size_max;   // submissions per flush
+    long lat_p50_us, lat_p99_us;         // format + writev + sync
+    long sync_p99_us;                    // fdatasync alone
+    int  threshold_min_pct, threshold_max_pct;   // flush trigger range seen
+    long late_flushes;                   // oldest item missed flush_target_ms
+} IOFlushStats;
+
+// Durability phases of one submission: submit → dequeue (queue),
+// dequeue → writev start (format), writev (write), written → synced
+// (sync; absent under DURABILITY = NONE) and submit → durable (total)
+typedef enum {
+    PHASE_QUEUE, PHASE_FORMAT, PHASE_WRITE, PHASE_SYNC, PHASE_TOTAL,
+    IO_PHASES
+} IOPhase;
+
+typedef struct {
+    long count;
+    long p50_us, p99_us, max_us;
+} IOPhaseStats;
+
+// One submission for io_buffer_submit_batch(); answer is copied
+typedef struct {
+    int         pid;
+    int         question_id;
+    int         is_partial;
+    const char *answer;
+} SubmitRequest;
+
+// Answer arena figures, summed over shards
+typedef struct {
+    long slabs;              // allocated (ARENA_SLAB_BYTES each)
+    long recycled;           // slabs drained and reused
+    long truncated;          // answers cut at MAX_ANSWER_BYTES
+    long exhausted;          // submits dropped: arena full
+    long bytes;              // answer text stored
+} IOArenaStats;
+
+// Write-ahead log figures (WAL = ON), summed over shards
+typedef struct {
+    long records;            // submissions logged this run
+    long commits;            // group commits (write + fdatasync)
+    long bytes;
+    long commit_p99_us;      // worst shard
+    long failed;             // submissions refused: their commit failed
+    int  recovering;         // this run resumed a crashed one
+    long recovered;          // submissions replayed at startup
+    long recover_ms;
+} IOWalStats;
+
+void  io_buffer_init(SimContext *ctx);
+void  io_buffer_shutdown(SimContext *ctx);
+void  io_buffer_destroy(SimContext *ctx);      // after all threads are joined
+int   io_buffer_submit(SimContext *ctx, int pid, int question_id,
+                       const char *answer, int is_partial);
+int   io_buffer_submit_batch(SimContext *ctx, const SubmitRequest *reqs, int n);
+float io_buffer_fill(SimContext *ctx);         // fullest shard: queued / capacity
+float io_buffer_credit(SimContext *ctx);       // back-pressure: 1 = go, 0 = hold
+int   io_buffer_shards(SimContext *ctx);
+int   io_buffer_merge_segments(const char *out_dir, int shards);   // → submissions.txt; -1 on error
+void  io_buffer_submit_stats(SimContext *ctx, IOSubmitStats *out);
+void  io_buffer_flush_stats(SimContext *ctx, IOFlushStats *out);
+void  io_buffer_phase_stats(SimContext *ctx, IOPhaseStats out[IO_PHASES]);
+void  io_buffer_arena_stats(SimContext *ctx, IOArenaStats *out);
+void  io_buffer_store_stats(SimContext *ctx, StoreStats *out);   // summed over shards
+void  io_buffer_wal_stats(SimContext *ctx, IOWalStats *out);
+void  io_buffer_store_dir(const Config *cfg, int pid, char *out, size_t len);   // shard holding pid
+void *io_buffer_thread(void *arg);             // arg: the SimContext
+void  io_buffer_step(SimContext *ctx, int tick);  // TICK_IO
+
+// Snapshot: counters + queued submissions (world stopped), then each
+// segment's prefix (after); segments are restored before the queue
+void  io_buffer_snapshot(SimContext *ctx, SnapWriter *w);
+void  io_buffer_snapshot_segments(SimContext *ctx, SnapWriter *w);
+void  io_buffer_restore_segments(SimContext *ctx, SnapReader *r);
+void  io_buffer_restore(SimContext *ctx, SnapReader *r);
+
+#endif // IO_BUFFER_H
@@ -3,10 +3,13 @@
 
 #include "shared.h"
 
-void logger_init();
-void logger_shutdown();
-void log_event(const char *level, const char *subsystem, const char *message);
-void *logger_thread(void *arg);
-void logger_write_report();
+void logger_init(SimContext *ctx);
+void logger_shutdown(SimContext *ctx);
+void logger_destroy(SimContext *ctx);
+void log_event(SimContext *ctx, const char *level, const char *subsystem, const char *message);
+void *logger_thread(void *arg);              // arg: the SimContext
+void logger_notify_fd(SimContext *ctx, int fd);   // RUNTIME = REACTOR: eventfd per event
+void logger_drain(SimContext *ctx);          // RUNTIME = REACTOR: write out the queue
+void logger_write_report(SimContext *ctx);   // <output_dir>/summary.txt
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
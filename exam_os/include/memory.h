@@ -2,10 +2,16 @@
 #define MEMORY_H
 
 #include "shared.h"
+#include "snapshot.h"
 
-void  memory_init();
-void *memory_thread(void *arg);
-int   memory_access(int pid, int virtual_page);
-void  memory_free_process(int pid);
+void  memory_init(SimContext *ctx);
+void  memory_destroy(SimContext *ctx);
+void *memory_thread(void *arg);        // arg: the SimContext
+void  memory_step(SimContext *ctx, int tick);      // TICK_MEMORY
+int   memory_access(SimContext *ctx, int pid, int virtual_page, int write);
+void  memory_free_process(SimContext *ctx, int pid);
+void  memory_free_processes(SimContext *ctx, const int *pids, int n);
+void  memory_snapshot(SimContext *ctx, SnapWriter *w);
+void  memory_restore(SimContext *ctx, SnapReader *r);
 
-#endif // MEMORY_H
\ No newline at end of file
+#endif // MEMORY_H
@@ -0,0 +1,27 @@
+#ifndef PROC_TABLE_H
+#define PROC_TABLE_H
+
+#include "shared.h"
+#include "snapshot.h"
+
+// Structure-of-arrays process table. Per-tick passes only touch one
+// or two fields, so each field gets its own dense array: a state sweep
+// reads 1 byte per process instead of a whole PCB, and the loops below
+// are written so the compiler can vectorize them at -O2.
+
+void proc_table_init(ProcTable *t, int capacity);
+void proc_table_free(ProcTable *t);
+int  proc_table_append(ProcTable *t, const PCB *p);
+int  proc_table_find(const ProcTable *t, int pid);
+void proc_table_get(const ProcTable *t, int idx, PCB *out);
+
+// Bulk sweeps
+int  proc_table_count_state(const ProcTable *t, ProcessState state);
+int  proc_table_tick(ProcTable *t, int *expired_pids, int max_expired);
+int  proc_table_collect_active(const ProcTable *t, PCB *out, int max);
+
+// Snapshot: rows only, into a table initialised with enough capacity
+void proc_table_snapshot(const ProcTable *t, SnapWriter *w);
+void proc_table_restore(ProcTable *t, SnapReader *r);
+
+#endif // PROC_TABLE_H
@@ -0,0 +1,29 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include "shared.h"
+
+// RUNTIME = REACTOR: one epoll loop replaces the tick, logger,
+// scheduler, memory, interrupt and dashboard threads.
+//   timerfd  every TIME_TICK_MS  → one whole tick, phases run inline
+//   eventfd  per log_event       → write the log queue out
+//   timerfd  every 500 ms + stdin → dashboard refresh and 'q'
+//   eventfd  reactor_stop        → final log drain, leave the loop
+// Work that blocks on the disk (shard flushers, WAL committer, bottom
+// halves, compactor, snapshot writer) keeps its own threads.
+
+typedef struct {
+    long wakeups;             // epoll_wait returns
+    long tick_events;         // timerfd expirations handled
+    long missed_ticks;        // expirations folded into a late tick
+    long log_events;          // eventfd reads by the log drain
+} ReactorStats;
+
+int   reactor_init(SimContext *ctx);      // before any thread starts; -1 if unavailable
+void  reactor_stop(SimContext *ctx);      // after the last log_event
+void  reactor_destroy(SimContext *ctx);
+void *reactor_thread(void *arg);          // arg: the SimContext
+
+void  reactor_stats(SimContext *ctx, ReactorStats *out);
+
+#endif // REACTOR_H
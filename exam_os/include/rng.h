@@ -0,0 +1,32 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// xoshiro256** streams. Each subsystem owns its streams and only its
+// own phase draws from them, so there is no shared state and no lock;
+// the SEED fixes every stream, so one seed reproduces one workload.
+// A stream is picked by (seed, RngStream, index): index is 0 for a
+// subsystem-wide stream or the pid for a per-process one, so what a
+// student does never depends on how many draws anyone else made.
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+typedef enum {
+    RNG_ARRIVALS = 1,         // admission: Poisson logins, exam length jitter
+    RNG_MEMORY,               // per process: page accesses
+    RNG_SUBMIT,               // per process: whether, what and how long
+    RNG_STORM,                // demo storm
+    RNG_BENCH                 // offline benchmarks
+} RngStream;
+
+void     rng_seed(Rng *r, uint64_t seed, RngStream stream, uint64_t index);
+uint64_t rng_next(Rng *r);
+uint32_t rng_below(Rng *r, uint32_t n);   // uniform in [0, n), n > 0
+double   rng_unit(Rng *r);                // uniform in [0, 1)
+
+uint64_t rng_clock_seed(void);            // SEED = 0: a fresh nonzero seed
+
+#endif // RNG_H
@@ -2,10 +2,17 @@
 #define SCHEDULER_H
 
 #include "shared.h"
+#include "snapshot.h"
 
-void  scheduler_init();
-void *scheduler_thread(void *arg);
-void  scheduler_add_process(PCB process);
-void  scheduler_terminate_process(int pid);
+void  scheduler_init(SimContext *ctx);
+void  scheduler_destroy(SimContext *ctx);
+void *scheduler_thread(void *arg);     // arg: the SimContext
+void  scheduler_admit(SimContext *ctx, int tick);   // TICK_ARRIVALS
+void  scheduler_step(SimContext *ctx, int tick);    // TICK_SCHEDULE
+void  scheduler_add_process(SimContext *ctx, PCB process);
+void  scheduler_terminate_process(SimContext *ctx, int pid);
+void  scheduler_terminate_processes(SimContext *ctx, const int *pids, int n);
+void  scheduler_snapshot(SimContext *ctx, SnapWriter *w);
+void  scheduler_restore(SimContext *ctx, SnapReader *r);
 
-#endif // SCHEDULER_H
\ No newline at end of file
+#endif // SCHEDULER_H
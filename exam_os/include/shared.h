@@ -3,15 +3,22 @@
 
 #include <pthread.h>
 #include <semaphore.h>
+#include <stdint.h>
 #include <time.h>
 
 // ─── Constants ───────────────────────────────────────────
 #define MAX_STUDENTS     200
 #define MAX_FRAMES       256
 #define MAX_PAGES        64
-#define BUFFER_CAPACITY  256
+#define MAX_BUFFER_CAPACITY 65536   // ceiling for the runtime-sized I/O ring
+#define MAX_IO_SHARDS    8
+#define FLUSH_HISTORY    64         // dashboard samples of the flush threshold
+#define MAX_ANSWER_BYTES 8192       // essays beyond this are truncated
+#define ARENA_SLAB_BYTES (64 * 1024)
+#define ARENA_MAX_SLABS  256        // per shard: 16 MB of answer text
 #define MAX_LOG_QUEUE    512
 #define MAX_INTERRUPTS   8
+#define INT_LEVELS       4
 #define TIME_TICK_MS     100
 
 // ─── Enums ───────────────────────────────────────────────
@@ -27,6 +34,31 @@ typedef enum {
     LRU, FIFO
 } PageAlgo;
 
+typedef enum {
+    ARRIVAL_CONSTANT, ARRIVAL_POISSON, ARRIVAL_BURST
+} ArrivalModel;
+
+typedef enum {
+    SUBMIT_DROP,            // full buffer: drop and count (default)
+    SUBMIT_BLOCK            // full buffer: wait up to submit_wait_ms
+} SubmitPolicy;
+
+typedef enum {
+    DURABILITY_NONE,        // write() only, page cache decides
+    DURABILITY_FDATASYNC,   // fdatasync after every flush batch
+    DURABILITY_GROUP        // fdatasync at most every group_commit_ms
+} DurabilityMode;
+
+typedef enum {
+    FLUSH_FIXED,            // 80% full or every 15 ticks
+    FLUSH_ADAPTIVE          // AIMD threshold + deadline from flush_target_ms
+} FlushPolicy;
+
+typedef enum {
+    RUNTIME_THREADS,        // one thread per tick phase + tick thread
+    RUNTIME_REACTOR         // one epoll loop: timerfd ticks, phases inline
+} RuntimeMode;
+
 // ─── Process Control Block ───────────────────────────────
 typedef struct {
     int          pid;
@@ -34,11 +66,29 @@ typedef struct {
     int          priority;        // higher = more urgent
     int          total_time;      // total exam duration (ticks)
     int          remaining_time;  // ticks left
+    int          deadline_tick;   // absolute tick the exam expires at
     int          waiting_time;
     int          turnaround_time;
     int          pages_used;
 } PCB;
 
+// ─── Process Table (structure-of-arrays, see proc_table.h)
+typedef struct {
+    int            count;
+    int            capacity;
+    // hot: read or written by per-tick sweeps
+    unsigned char *state;          // ProcessState
+    int           *remaining_time;
+    int           *deadline_tick;
+    int           *priority;
+    // cold
+    int           *pid;
+    int           *total_time;
+    int           *waiting_time;
+    int           *turnaround_time;
+    int           *pages_used;
+} ProcTable;
+
 // ─── Page Table Entry ────────────────────────────────────
 typedef struct {
     int  virtual_page;
@@ -49,12 +99,21 @@ typedef struct {
     int  load_order;     // for FIFO
 } PageTableEntry;
 
+// ─── Answer text handle (see answer_arena.h) ─────────────
+typedef struct {
+    int  slab;
+    int  offset;
+    int  len;
+} AnswerRef;
+
 // ─── Submission (I/O Buffer item) ────────────────────────
 typedef struct {
     int  pid;
     int  question_id;
-    char answer[128];
+    AnswerRef answer;    // text lives in the shard's answer arena
     long timestamp;
+    long submit_us;      // monotonic submit time, for durability latency
+    long lsn;            // write-ahead log sequence number (0 = not logged)
     int  is_partial;     // 1 if from timeout interrupt
 } Submission;
 
@@ -75,8 +134,48 @@ typedef struct {
     int       exam_duration;
     SchedAlgo sched_algo;
     PageAlgo  page_algo;
-    int       buffer_capacity;
+    int       buffer_capacity;    // submission ring slots (rounded to 2^n)
+    int       buffer_max_capacity; // grow up to this under pressure (0 = fixed)
+    int       io_shards;          // submission buffers / flusher threads
+    SubmitPolicy submit_policy;
+    int       submit_wait_ms;     // BLOCK: give up after this (0 = never drop)
+    DurabilityMode durability;
+    int       group_commit_ms;    // GROUP: max time a flushed batch stays unsynced
+    FlushPolicy flush_policy;
+    int       flush_target_ms;    // ADAPTIVE: submit-to-disk latency target
+    int       store_enabled;      // also append to the indexed binary store
+    int       coalesce;           // newer answer replaces a still-queued one
+    int       wal_enabled;        // log accepted submissions, recover on start
+    int       wal_commit_ms;      // WAL group-commit window
+    int       store_segment_kb;   // store segment size before it is sealed
+    int       snapshot_ticks;     // snapshot every N ticks (0 = off)
     int       demo_mode;
+
+    // Login arrivals + token-bucket admission
+    ArrivalModel arrival_model;
+    float     arrival_rate;       // mean logins per tick
+    int       arrival_burst_tick; // BURST: everyone left logs in here
+    float     admit_rate;         // tokens per tick (0 = unlimited)
+    int       admit_burst;        // bucket depth
+
+    int       int_queue_capacity; // interrupt ring slots (rounded to 2^n)
+    int       bh_workers;         // bottom-half worker threads
+    int       storm_mask_threshold; // pending timeouts that mask low levels (0 = off)
+
+    char      bench[32];          // --bench NAME: run a benchmark and exit
+    int       merge_only;         // --merge: rebuild submissions.txt and exit
+    int       lookup_pid;         // --lookup PID QID: query the store and exit
+    int       lookup_qid;
+    char      restore_path[256];  // --restore FILE: resume from a snapshot
+    char      replay_path[256];   // --replay FILE: workload from a trace
+    char      trace_dump[256];    // --trace-dump FILE: print a trace and exit
+    int       trace_capture;      // write <output_dir>/trace.bin
+    char      output_dir[128];    // where this simulation writes its files
+    int       headless;           // no ncurses dashboard
+    RuntimeMode runtime;
+    char      sweep[128];         // --sweep FILE: run a parameter grid and exit
+    int       sweep_jobs;         // runs in parallel (0 = one per core)
+    uint64_t  seed;               // every random stream (0 = from the clock)
 } Config;
 
 // ─── System State (shared across all modules) ────────────
@@ -90,21 +189,50 @@ typedef struct {
     // Memory
     int   page_faults;
     int   page_hits;
+    int   dirty_evictions;      // written pages sent back to disk
     int   frames_used;
 
     // I/O Buffer
     int   buffer_count;
+    int   buffer_capacity;        // live ring size (may grow)
+    int   buffer_grows;
+    int   shard_fill[MAX_IO_SHARDS];  // percent, per shard
     int   total_submissions;
     int   dropped_submissions;
     int   flush_count;
+    int   sync_count;             // fdatasync calls
+    int   delayed_submissions;    // BLOCK: had to wait for a slot
+    int   throttled_submissions;  // skipped by credit back-pressure
+    int   throttled_logins;       // login-ticks held back by credits
+    float submit_rate;            // arrivals per tick (EWMA, all shards)
+    int   flush_threshold_pct;    // current trigger, mean over shards
+    int   flush_history[FLUSH_HISTORY];  // ring of per-tick thresholds
+    int   flush_history_len;      // samples written so far
+
+    // Logins / admission control
+    int   logins_arrived;
+    int   logins_admitted;
+    int   login_queue_len;
+    int   login_wait_max;     // ticks
 
     // Interrupts
     int   timeouts_fired;
+    int   timeout_batches;        // bulk timeout bottom halves run
+    int   timeout_batch_max;      // largest storm (exams in one batch)
+    long  timeout_batch_max_us;   // handling time of that storm
     int   overload_signals;
+    int   overload_active;        // back-pressure window open
+    int   int_queue_depth;
+    int   int_queue_capacity;
+    int   int_coalesced;          // raises folded into one already pending
+    int   int_overflows;          // raises lost to a full queue (all ids)
+    int   int_timeout_overflows;  // of which timeouts (re-armed, not lost)
+    int   int_level_depth[INT_LEVELS];
+    int   int_masked_levels;      // bit L set = level L masked
+    int   int_preemptions;        // dispatched ahead of lower pending work
 
     // Processes
-    PCB   processes[MAX_STUDENTS];
-    int   process_count;
+    ProcTable procs;
 
     // Simulation control
     int   simulation_running;
@@ -118,26 +246,139 @@ typedef struct {
 } SystemState;
 
 // ─── I/O Buffer ──────────────────────────────────────────
+// Bounded lock-free MPSC ring: each cell's sequence number says whether
+// it is free for producers (seq == pos) or ready for the flusher
+// (seq == pos + 1). Producers claim a slot with one CAS on enq_pos.
 typedef struct {
-    Submission      buffer[BUFFER_CAPACITY];
-    int             head, tail, count;
-    sem_t           empty_slots;
-    sem_t           filled_slots;
-    pthread_mutex_t lock;
+    long       seq;
+    Submission sub;
+} SubmitCell;
+
+// ─── Answer arena: slabs of answer text, recycled whole ──
+typedef struct {
+    char *data;          // ARENA_SLAB_BYTES, allocated on first use
+    long  used;          // bump offset (overshoots on the failing claim)
+    int   live;          // answers handed out and not yet released
+    int   state;         // SLAB_FREE / SLAB_ACTIVE / SLAB_RETIRED
+} ArenaSlab;
+
+typedef struct {
+    ArenaSlab       slabs[ARENA_MAX_SLABS];
+    int             nslabs;          // slabs allocated so far
+    int             current;         // slab producers bump into
+    int             free_list[ARENA_MAX_SLABS];
+    int             free_count;
+    pthread_mutex_t lock;            // slab switch and recycling only
+    long            recycled;        // slabs returned to the free list
+    long            truncated;       // answers cut at MAX_ANSWER_BYTES
+    long            exhausted;       // puts refused: every slab in use
+    long            bytes;           // answer bytes stored
+} AnswerArena;
+
+// COALESCE index entry: the queued slot holding a (pid, question) answer
+typedef struct {
+    int  pid;            // 0 = empty
+    int  question_id;
+    long pos;            // ring position of the queued submission
+} CoalesceSlot;
+
+// A written submission waiting for the sync that makes it durable
+typedef struct {
+    long submit_us;
+    long written_us;
+} PendingSync;
+
+// One shard: a ring, the flusher thread that drains it and the output
+// segment it writes. Submissions are routed to a shard by pid hash.
+typedef struct {
+    SubmitCell     *cells;           // capacity slots, allocated at init
+    int             capacity;        // power of two
+    long            mask;            // capacity - 1
+    int             max_capacity;    // growth ceiling
+    long            enq_pos  __attribute__((aligned(64)));  // producers
+    long            deq_pos  __attribute__((aligned(64)));  // flusher only
+    int             writers  __attribute__((aligned(64)));  // producers mid-enqueue
+    int             resizing;        // set while the flusher grows the ring
+
+    // Flusher side
+    int             id;
+    int             fd;              // output segment
+    pthread_t       flusher;
+    int             stop;
+    long            drops;           // full-ring drops on this shard
+    long            last_drops;
+    int             pressure_ticks;
+    long            last_sync_ms;
+    long            unsynced;        // bytes written since the last sync
+    PendingSync    *pending;         // written since the last sync, in order
+    int             pending_count, pending_cap;
+    float           threshold;       // flush trigger (fill fraction)
+    float           rate;            // arrivals per tick, EWMA
+    long            last_enq;        // enq_pos at the previous tick
+    int             congested;       // set on drop / delay / late flush
+    long            late_flushes;    // flushes whose oldest item missed the target
+    Submission     *batch;           // flusher scratch
+    char           *chunks;
+    int            *pids;
+    int            *slabs;           // answer slab of each written item
+    AnswerArena     arena;           // answer text for this shard
+    struct SimContext *ctx;          // simulation this shard belongs to
+    struct SubmissionStore *store;   // binary store (STORE = ON), else NULL
+
+    // WAL = ON: log append + ring push happen together under wal_lock,
+    // so ring order is LSN order and a synced prefix is a checkpoint
+    struct Wal     *wal;
+    pthread_mutex_t wal_lock;
+    long            next_lsn;        // last LSN handed out
+    long            written_lsn;     // highest LSN written to the segment
+    int             sync_failed;     // a sync failed: the checkpoint stays put
+
+    // COALESCE: (pid, question) → queued slot, guarded by coalesce_lock
+    CoalesceSlot   *coalesce;        // NULL when coalescing is off
+    long            coalesce_mask;
+    pthread_mutex_t coalesce_lock;
+
+    // BLOCK policy waiters
+    pthread_mutex_t space_lock;
+    pthread_cond_t  space_cond;
+    int             space_waiters;
+    sem_t           kick;            // wake the flusher early
 } IOBuffer;
 
 // ─── Interrupt Vector Table Entry ────────────────────────
-typedef void (*handler_fn)(int pid, SystemState *state);
+struct SimContext;
+typedef void (*handler_fn)(struct SimContext *ctx, int pid);
 
 typedef struct {
     int        interrupt_id;
     char       name[32];
+    int        priority;     // INT_PRIO_* level, higher = more urgent
     handler_fn handler;
 } IVTEntry;
 
-// ─── Global instances (defined in main.c) ────────────────
-extern SystemState g_state;
-extern IOBuffer    g_io_buffer;
-extern Config      g_config;
+// ─── Simulation context ──────────────────────────────────
+// Everything one simulation owns, passed to every module call and
+// thread. Subsystems keep their private state behind the pointers
+// below (allocated by their init), so a process can run any number
+// of simulations side by side. See sim.h for the lifecycle.
+typedef struct SimContext {
+    Config       config;
+    SystemState  state;
+    IOBuffer     io[MAX_IO_SHARDS];
+
+    struct Logger       *logger;
+    struct Scheduler    *sched;
+    struct Admission    *admission;
+    struct Memory       *memory;
+    struct TimerWheel   *wheel;
+    struct Interrupts   *intr;
+    struct WorkQueue    *wq;
+    struct IOState      *io_state;
+    struct Snapshotter  *snap;
+    struct Dashboard    *dash;
+    struct TickClock    *clock;
+    struct Reactor      *reactor;     // RUNTIME = REACTOR only
+    struct Trace        *trace;
+} SimContext;
 
 #endif // SHARED_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "shared.h"
+
+// One simulation: its config, state, subsystems and threads all hang off
+// a SimContext, so a process can run several side by side. Each writes
+// under its own OUTPUT_DIR; only one may run the ncurses dashboard.
+//
+//   ctx = sim_create(&cfg);       // every subsystem at its defaults
+//   snapshot_apply(ctx, snap);    // optional, before running
+//   sim_run(ctx);                 // blocks until the exam ends
+//   sim_destroy(ctx);
+
+// Headline figures of a finished run, for comparing runs side by side
+typedef struct {
+    int  ticks;                           // simulated
+    int  completed;                       // exams
+    int  timeouts;
+    int  context_switches;
+    int  page_hits, page_faults;
+    long submitted, dropped;
+    long submit_p50_ns, submit_p99_ns;    // enqueue
+    long durable_p50_us, durable_p99_us;  // submit → on disk
+    long login_wait_p99;                  // ticks
+} SimMetrics;
+
+SimContext *sim_create(const Config *cfg);   // NULL with a message
+void        sim_run(SimContext *ctx);        // spawn, run, join, write summary
+void        sim_metrics(SimContext *ctx, SimMetrics *out);   // after sim_run
+void        sim_destroy(SimContext *ctx);
+
+#endif // SIM_H
@@ -0,0 +1,94 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "shared.h"
+
+// Versioned binary snapshot of the whole simulation:
+//   <output_dir>/snapshots/snap-TTTTTT.bin  header, then one section per subsystem
+// Simulation threads do each tick's work inside the snapshot gate (a
+// shared lock). A snapshot holds the gate exclusively only while every
+// subsystem copies its state into a memory buffer; the file is written
+// from that copy after the world is running again. Output segments are
+// embedded too (read after the gate opens: they only ever grow), so a
+// snapshot restores on its own, however often it has been forked from.
+
+#define SNAPSHOT_MAGIC   0x314E5345u   // "ESN1"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_DIR     "snapshots"      // under output_dir
+
+typedef enum {
+    SNAP_STATE = 1, SNAP_PROCS, SNAP_SCHEDULER, SNAP_ADMISSION, SNAP_MEMORY,
+    SNAP_TIMERS, SNAP_INTERRUPTS, SNAP_IO, SNAP_SEGMENTS,
+    SNAP_SECTIONS
+} SnapSection;
+
+typedef struct {              // offset 0 of the file
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layout;          // struct sizes of the build that wrote it
+    uint32_t crc;             // CRC-32 of everything after the header
+    uint64_t payload_bytes;
+    int64_t  created_ms;      // wall clock
+    int64_t  mono_us;         // monotonic clock at capture, for rebasing
+    int32_t  tick;
+    int32_t  num_students;    // must match the restoring run
+    int32_t  memory_frames;
+    int32_t  io_shards;
+    uint64_t seed;            // the random streams continue from the snapshot
+} SnapshotHeader;
+
+typedef struct {              // precedes each section's payload
+    uint32_t id;              // SnapSection
+    uint32_t len;
+} SnapSectionHeader;
+
+// Capture side: a growable buffer
+typedef struct {
+    char  *data;
+    size_t len, cap;
+    int    failed;            // out of memory
+} SnapWriter;
+
+// Restore side: one section's payload
+typedef struct {
+    const char *data;
+    size_t      len, pos;
+    long        rebase_us;    // add to saved monotonic µs timestamps
+    int         failed;       // read past the end, or a bad value
+} SnapReader;
+
+void snap_put(SnapWriter *w, const void *p, size_t n);
+void snap_get(SnapReader *r, void *p, size_t n);
+
+typedef struct {
+    long taken;
+    int  last_tick;
+    long last_bytes;
+    long pause_p50_us, pause_max_us;   // gate held exclusively
+    long write_p99_ms;                 // serialize + write + fsync
+    int  restored_tick;                // -1 if this run started fresh
+} SnapshotStats;
+
+void  snapshot_init(SimContext *ctx);     // before any thread takes the gate
+void  snapshot_destroy(SimContext *ctx);
+
+// ─── Gate: held around each unit of simulation work ──────
+void  snapshot_enter(SimContext *ctx);
+void  snapshot_leave(SimContext *ctx);
+
+// ─── Writer ──────────────────────────────────────────────
+void *snapshot_thread(void *arg);      // arg: the SimContext; every SNAPSHOT_TICKS ticks
+void  snapshot_stats(SimContext *ctx, SnapshotStats *out);
+
+// ─── Restore ─────────────────────────────────────────────
+typedef struct Snapshot Snapshot;
+
+Snapshot *snapshot_load(const char *path, const Config *cfg);   // read + validate, NULL with a message
+int       snapshot_tick(const Snapshot *s);
+uint64_t  snapshot_seed(const Snapshot *s);     // the run it was taken from
+int       snapshot_apply(SimContext *ctx, Snapshot *s);   // after every init, before the threads
+void      snapshot_free(Snapshot *s);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,103 @@
+#ifndef SUBMISSION_STORE_H
+#define SUBMISSION_STORE_H
+
+#include <stdint.h>
+#include "shared.h"
+
+// Append-only binary submission store, one per shard directory:
+//   seg-NNNNNN.dat  fixed header + length-prefixed, CRC-checked records
+//   index.dat       open-addressing hash (pid, question_id) → latest record
+// Appends go to the active segment, which is sealed at the segment size.
+// Compaction rewrites mostly-dead sealed segments keeping only the
+// record each key's index slot points at (last writer wins, by seq).
+// Readers mmap the index and segments: one probe + one CRC check.
+
+#define STORE_MAGIC       0x31545345u   // "EST1"
+#define STORE_INDEX_MAGIC 0x31585345u   // "ESX1"
+#define STORE_VERSION     1
+#define STORE_PARTIAL     0x1
+
+typedef struct {              // offset 0 of every segment
+    uint32_t magic;
+    uint32_t version;
+    uint32_t segment_id;
+    uint32_t reserved;
+    int64_t  created_ms;
+} StoreSegmentHeader;
+
+typedef struct {              // precedes each answer
+    uint32_t len;             // answer bytes that follow
+    uint32_t crc;             // CRC-32 of the fields below + answer
+    int32_t  pid;
+    int32_t  question_id;
+    int64_t  timestamp;       // ms, as in submissions.txt
+    uint64_t seq;             // store-wide append order: larger wins
+    uint32_t flags;           // STORE_PARTIAL
+    uint32_t reserved;
+} StoreRecordHeader;
+
+typedef struct {              // index.dat: header, then capacity slots
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;        // power of two
+    uint32_t count;
+    uint64_t data_bytes;      // segment bytes covered; a mismatch means stale
+    uint64_t max_seq;
+} StoreIndexHeader;
+
+typedef struct {
+    int32_t  pid;             // 0 = empty slot (pids start at 1)
+    int32_t  question_id;
+    uint32_t segment;
+    uint32_t offset;          // of the record header in that segment
+} StoreIndexSlot;
+
+typedef struct SubmissionStore SubmissionStore;
+
+typedef struct {
+    long records;             // appended this run
+    long live;                // keys in the index
+    long segments;            // on disk now
+    long compactions;
+    long reclaimed_bytes;
+} StoreStats;
+
+// ─── Writer: one thread appends, the compactor may run alongside ─
+SubmissionStore *store_open(const char *dir, long segment_bytes, int resume);
+int   store_append(SubmissionStore *s, const Submission *subs,
+                   const char *const *answers, int n);
+int   store_sync(SubmissionStore *s);
+int   store_compact(SubmissionStore *s);   // 1 if it compacted, 0 if not worth it
+void  store_stats(SubmissionStore *s, StoreStats *out);
+void  store_close(SubmissionStore *s);     // seals, persists the index
+
+// ─── Reader: mmap-based, no locks, read-only ─────────────
+typedef struct {
+    int32_t     pid;
+    int32_t     question_id;
+    int64_t     timestamp;
+    uint64_t    seq;
+    int         is_partial;
+    const char *answer;       // points into the mapped segment
+    int         len;
+} StoreRecord;
+
+typedef struct {
+    void                 *index_map;
+    size_t                index_len;
+    const StoreIndexSlot *slots;
+    StoreIndexSlot       *rebuilt;    // owned slots when index.dat was stale
+    uint32_t              mask;
+    const char          **seg_base;   // by segment id, NULL if absent
+    size_t               *seg_len;
+    uint32_t              nsegs;      // highest id + 1
+} StoreReader;
+
+int   store_reader_open(StoreReader *r, const char *dir);
+// 0 found, -1 no such key, -2 record failed its CRC
+int   store_lookup(const StoreReader *r, int pid, int question_id, StoreRecord *out);
+void  store_reader_close(StoreReader *r);
+
+uint32_t store_crc32(uint32_t crc, const void *data, size_t len);
+
+#endif // SUBMISSION_STORE_H
@@ -0,0 +1,21 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "shared.h"
+
+// Parameter sweep. A grid file lists config.conf keys, each with a
+// comma-separated list of values:
+//   MEMORY_FRAMES   = 32, 64, 128
+//   PAGE_REPLACE    = LRU, FIFO
+// Every combination runs headless in its own SimContext, on top of the
+// normal config, under <output_dir>/sweep/run-NNN/. SWEEP_JOBS runs go
+// at a time; the comparison lands in <output_dir>/sweep/results.csv and
+// results.md, and the Markdown table is printed at the end.
+
+#define SWEEP_MAX_KEYS    8
+#define SWEEP_MAX_VALUES  16
+#define SWEEP_MAX_RUNS    1024
+
+int sweep_run(const Config *base, const char *grid_path);   // 0 if every run finished
+
+#endif // SWEEP_H
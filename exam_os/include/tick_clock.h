@@ -0,0 +1,61 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include "shared.h"
+#include "histogram.h"
+
+// Lockstep simulation clock. The tick thread sleeps to absolute
+// TIME_TICK_MS deadlines (clock_nanosleep, TIMER_ABSTIME: no drift),
+// advances current_tick, then opens each phase in order and waits for
+// the one thread that runs it to finish:
+//   arrivals → schedule → memory → I/O → interrupts
+// so every subsystem acts exactly once per tick, always in that order.
+// Once the last phase is done the tick is complete: observers (the run
+// loop, snapshots, the store compactor) wake, and the clock ends the
+// run after EXAM_DURATION ticks or once every exam has completed.
+
+typedef enum {
+    TICK_ARRIVALS,            // scheduler thread: logins + admission
+    TICK_SCHEDULE,            // scheduler thread: one decision
+    TICK_MEMORY,              // memory thread: page accesses
+    TICK_IO,                  // I/O thread: simulated submitters
+    TICK_INTERRUPTS,          // interrupt thread: timeouts + dispatch
+    TICK_PHASES
+} TickPhase;
+
+typedef struct {
+    long ticks;               // run by this clock
+    long overruns;            // phases ran past the next deadline
+    long max_lag_us;          // worst start behind its deadline
+    long busy_p50_us, busy_p99_us;     // all phases of one tick
+    long phase_p99_us[TICK_PHASES];
+} TickClockStats;
+
+typedef void (*tick_phase_fn)(SimContext *ctx, int tick);
+
+void  tick_clock_init(SimContext *ctx);
+void  tick_clock_destroy(SimContext *ctx);
+void *tick_clock_thread(void *arg);   // arg: the SimContext; RUNTIME = THREADS
+
+// One whole tick: advance current_tick, run the phases in order,
+// complete it and decide whether the exam is over. With run == NULL
+// each phase is opened for its thread; otherwise run[phase] is called
+// inline. 0 to go on, -1 once the run has ended (waiters are woken).
+int   tick_clock_tick(SimContext *ctx, const tick_phase_fn run[TICK_PHASES]);
+void  tick_clock_late(SimContext *ctx, long lag_us);   // a deadline was missed
+
+// ─── Phase threads ───────────────────────────────────────
+// Block until `phase` opens for a tick after `last`; returns that tick,
+// or -1 once the run is over. Every begin is paired with an end.
+int   tick_phase_begin(SimContext *ctx, TickPhase phase, int last);
+void  tick_phase_end(SimContext *ctx, TickPhase phase);
+
+// ─── Observers ───────────────────────────────────────────
+// Block until a tick after `last` has completed: that tick, or -1
+// once the run is over
+int   tick_clock_wait(SimContext *ctx, int last);
+
+void  tick_clock_stats(SimContext *ctx, TickClockStats *out);
+const char *tick_phase_name(TickPhase phase);
+
+#endif // TICK_CLOCK_H
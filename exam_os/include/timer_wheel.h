@@ -0,0 +1,27 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "shared.h"
+#include "snapshot.h"
+
+// Hierarchical timing wheel for exam deadlines: 4 levels x 64 slots
+// (covers 2^24 ticks). Arm/cancel are O(1); advancing one tick costs
+// O(expired) plus an amortized cascade every 64 ticks.
+
+typedef struct TimerWheel TimerWheel;
+typedef void (*timer_expire_fn)(void *arg, int pid);
+
+TimerWheel *timer_wheel_create(long start_tick);
+void timer_wheel_reset(TimerWheel *tw, long start_tick);   // disarms everything
+void timer_wheel_destroy(TimerWheel *tw);
+void timer_wheel_arm(TimerWheel *tw, int pid, long expires_tick);
+void timer_wheel_cancel(TimerWheel *tw, int pid);
+int  timer_wheel_advance(TimerWheel *tw, long now_tick,
+                         timer_expire_fn on_expire, void *arg);
+int  timer_wheel_armed(TimerWheel *tw);
+
+// Snapshot: the clock and each armed (pid, expiry); restore re-files them
+void timer_wheel_snapshot(TimerWheel *tw, SnapWriter *w);
+void timer_wheel_restore(TimerWheel *tw, SnapReader *r);
+
+#endif // TIMER_WHEEL_H
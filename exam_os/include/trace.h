@@ -0,0 +1,108 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "shared.h"
+
+// Workload trace: every externally driven event of a run, so the same
+// exam can be replayed under another policy (LRU vs FIFO, RR vs
+// PRIORITY) and any difference comes from the policy alone.
+//
+//   TRACE_CAPTURE = ON   <output_dir>/trace.bin, written at the end
+//   --replay FILE        logins, page accesses, submissions and the
+//                        demo storm come from FILE instead of the RNG
+//   --trace-dump FILE    print a trace as text and exit
+//
+// Logins and the storm are bound to their tick. Page accesses and
+// submissions belong to the student: each tick a student runs takes
+// its next page-access burst and, if one follows, its submission, so
+// they line up however the scheduler orders the students. A student
+// who runs past the end of its events falls back to its seeded
+// stream; the summary counts those ticks.
+//
+// --replay also reads the text form --trace-dump prints, one event
+// per line, '#' comments. This is the format for traces imported from
+// production access logs:
+//   <tick> LOGIN  <pid> <exam_ticks>
+//   <tick> MEM    <pid> <page>[w] [<page>[w] ...]    one run tick's burst
+//   <tick> SUBMIT <pid> <question> <bytes> [<roll 0-29>]
+//   <tick> STORM  <submissions>
+//   SEED   <n>                    optional: the captured run's seed
+// The tick of MEM and SUBMIT lines is informational. Storm questions
+// and answer text come from the seed's streams, so a dump replays like
+// its trace.bin only with its SEED line.
+
+#define TRACE_MAGIC    0x31525445u   // "ETR1"
+#define TRACE_VERSION  1
+#define TRACE_FILE     "trace.bin"   // under output_dir
+#define TRACE_MAX_BURST 8            // page accesses in one run tick
+
+typedef enum {
+    TRACE_LOGIN = 1,          // a = exam ticks
+    TRACE_MEM,                // a = page, flags TRACE_WRITE / TRACE_LAST
+    TRACE_SUBMIT,             // a = question, b = answer bytes, flags = roll
+    TRACE_STORM               // a = submissions
+} TraceEventType;
+
+#define TRACE_WRITE  0x01     // MEM: a store, dirties the page
+#define TRACE_LAST   0x02     // MEM: last access of its run tick
+
+typedef struct {              // 16 bytes on disk, host byte order
+    int32_t  tick;
+    uint16_t pid;             // 0 for STORM
+    uint8_t  type;            // TraceEventType
+    uint8_t  flags;
+    int32_t  a, b;
+} TraceRecord;
+
+typedef struct {              // offset 0 of trace.bin, then the records
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seed;            // of the captured run
+    int32_t  num_students;
+    int32_t  exam_duration;
+    int64_t  records;
+} TraceHeader;
+
+typedef struct {
+    int  page;
+    int  write;
+} TraceAccess;
+
+typedef struct {
+    int  question;
+    int  bytes;
+    int  roll;                // 0-29: throttled while I/O credit is at most roll/30
+} TraceSubmit;
+
+typedef struct {
+    int  capturing, replaying;
+    long captured;            // events recorded
+    long replayed;            // events consumed
+    long fallback_ticks;      // run ticks past the end of a student's events
+    char path[256];
+} TraceStats;
+
+// Offline: read + validate FILE and take the run's shape from it
+// (students, seed); -1 with a message
+int   trace_check(const char *path, Config *cfg);
+int   trace_dump(const char *path);
+
+int   trace_init(SimContext *ctx);      // first of all; -1 if the replay file is bad
+void  trace_write(SimContext *ctx);     // after every thread has stopped
+void  trace_destroy(SimContext *ctx);
+void  trace_stats(SimContext *ctx, TraceStats *out);
+
+// ─── Capture: from the phase that generated the event ────
+void  trace_record(SimContext *ctx, int tick, int pid, TraceEventType type,
+                   int flags, int a, int b);
+
+// ─── Replay: each from its own phase ─────────────────────
+int   trace_replaying(SimContext *ctx);
+int   trace_logins(SimContext *ctx, int tick, int *pids, int *exam_ticks, int max);
+int   trace_storm(SimContext *ctx, int tick);              // submissions, 0 if none
+// Both return -1 once the student's events are used up
+int   trace_accesses(SimContext *ctx, int pid, TraceAccess *out);   // 1..TRACE_MAX_BURST
+int   trace_submission(SimContext *ctx, int pid, TraceSubmit *out); // 1 to submit, 0 not this tick
+
+#endif // TRACE_H
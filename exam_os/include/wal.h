@@ -0,0 +1,78 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdint.h>
+#include "shared.h"
+
+// Write-ahead log of accepted submissions, one per shard directory:
+//   wal-NNNNNN.log  CRC-checked records, rolled at WAL_SEGMENT_BYTES
+// Appends are buffered; a committer thread writes and fdatasyncs them
+// in groups (at most every commit_ms) and wal_wait() returns once a
+// record is durable. The flusher appends CHECKPOINT records naming the
+// LSN up to which submissions reached their output; sealed segments
+// below the checkpoint are deleted. A clean shutdown ends with CLOSE,
+// so a log without one belongs to a run that crashed.
+// A failed write, fdatasync or buffer allocation is sticky: nothing
+// after it is reported durable, and wal_wait() fails from then on.
+
+#define WAL_MAGIC          0x324C4157u   // "WAL2"
+#define WAL_SEGMENT_BYTES  (4L * 1024 * 1024)
+
+typedef enum { WAL_SUBMIT = 1, WAL_CHECKPOINT, WAL_CLOSE } WalRecordType;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t len;             // answer bytes that follow (SUBMIT only)
+    uint32_t crc;             // CRC-32 of the fields below + answer
+    uint32_t type;            // WalRecordType
+    uint64_t lsn;             // SUBMIT: its LSN; CHECKPOINT: LSN applied
+    int32_t  pid;
+    int32_t  question_id;
+    int64_t  timestamp;       // ms, as in submissions.txt
+    uint32_t is_partial;
+    uint32_t reserved;
+    uint64_t carrier_lsn;     // SUBMIT coalesced into a queued answer: its LSN
+} WalRecordHeader;
+
+typedef struct Wal Wal;
+
+typedef struct {
+    long records;             // SUBMIT records appended
+    long commits;             // write + fdatasync groups
+    long bytes;
+    long segments_dropped;    // sealed segments below the checkpoint
+    long commit_p99_us;       // write + fdatasync of one group
+} WalStats;
+
+// ─── Writer ──────────────────────────────────────────────
+Wal     *wal_open(const char *dir, int commit_ms);   // fresh log, starts the committer
+// Caller serializes appends and hands out increasing LSNs; carrier is
+// the LSN of the queued submission s was coalesced into, else 0
+void     wal_append(Wal *w, uint64_t lsn, uint64_t carrier, const Submission *s, const char *answer);
+int      wal_wait(Wal *w, uint64_t lsn);             // until lsn is on disk; -1 if it never will be
+int      wal_error(Wal *w);                          // errno of the sticky failure, 0 if none
+void     wal_checkpoint(Wal *w, uint64_t lsn);       // every SUBMIT <= lsn is applied
+void     wal_stats(Wal *w, WalStats *out);
+void     wal_close(Wal *w);                          // CLOSE record, final sync
+
+// ─── Recovery ────────────────────────────────────────────
+typedef struct {
+    int      segments;
+    int      crashed;         // records present, no CLOSE at the end
+    uint64_t checkpoint;      // highest CHECKPOINT seen
+    uint64_t max_lsn;
+    long     pending;         // SUBMIT records above the checkpoint
+    long     bytes;
+} WalScan;
+
+typedef void (*wal_replay_fn)(void *ctx, const WalRecordHeader *h, const char *answer);
+
+int   wal_scan(const char *dir, WalScan *out);       // -1 if there is no log
+// Calls fn for every SUBMIT above `after`, in LSN order within each
+// segment; stops a segment at its first torn or corrupt record. A
+// coalesced SUBMIT whose carrier is at or below `after` already reached
+// the output with it and is skipped.
+long  wal_replay(const char *dir, uint64_t after, wal_replay_fn fn, void *ctx);
+void  wal_remove(const char *dir);                   // delete every segment
+
+#endif // WAL_H
@@ -0,0 +1,20 @@
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include "shared.h"
+
+// Bottom-half work queue: interrupt handlers (top halves) do O(1)
+// bookkeeping and defer anything that touches other subsystems here,
+// so the dispatcher never blocks behind I/O, memory or the scheduler.
+
+#define WORKQ_CAPACITY 1024
+#define MAX_BH_WORKERS 8
+
+typedef void (*work_fn)(SimContext *ctx, int pid, long raised_us);
+
+void workqueue_init(SimContext *ctx, int workers);
+void workqueue_shutdown(SimContext *ctx);   // drain pending work, join workers
+void workqueue_defer(SimContext *ctx, work_fn fn, int pid, long raised_us);
+int  workqueue_depth(SimContext *ctx);
+
+#endif // WORKQUEUE_H
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "admission.h"
+#include "scheduler.h"
+#include "logger.h"
+#include "io_buffer.h"
+#include "rng.h"
+#include "trace.h"
+
+// ─── Login queue (arrived but not yet admitted) ──────────
+typedef struct {
+    int pid;
+    int arrival_tick;
+    int exam_ticks;           // how long this student's exam runs
+} PendingLogin;
+
+typedef struct Admission {
+    PendingLogin login_queue[MAX_STUDENTS];
+    int       lq_head, lq_tail, lq_count;
+
+    int       next_pid;
+    int       max_students;
+    float     tokens;
+    double    arrival_acc;         // fractional logins carried over (CONSTANT)
+    Histogram wait_hist;           // ticks from login to admission
+    Rng       rng;                 // RNG_ARRIVALS: logins + exam lengths
+} Admission;
+
+// ─── Arrival models ──────────────────────────────────────
+// Knuth's method — fine for the small per-tick means we use
+static int sample_poisson(Rng *rng, double lambda) {
+    double limit = exp(-lambda);
+    double p = 1.0;
+    int    k = 0;
+    do {
+        k++;
+        p *= rng_unit(rng);
+    } while (p > limit);
+    return k - 1;
+}
+
+static int arrivals_for_tick(SimContext *ctx, int tick) {
+    Admission    *a   = ctx->admission;
+    const Config *cfg = &ctx->config;
+    int want = 0;
+
+    switch (cfg->arrival_model) {
+    case ARRIVAL_POISSON:
+        want = sample_poisson(&a->rng, cfg->arrival_rate);
+        break;
+    case ARRIVAL_BURST:
+        // Trickle at arrival_rate, then everyone left logs in at once
+        if (tick >= cfg->arrival_burst_tick)
+            return a->max_students;
+        /* fall through */
+    case ARRIVAL_CONSTANT:
+        a->arrival_acc += cfg->arrival_rate;
+        want = (int)a->arrival_acc;
+        a->arrival_acc -= want;
+        break;
+    }
+    return want;
+}
+
+void admission_init(SimContext *ctx) {
+    const Config *cfg = &ctx->config;
+    Admission    *a   = calloc(1, sizeof(Admission));
+    ctx->admission  = a;
+    a->next_pid     = 1;
+    a->max_students = cfg->num_students < MAX_STUDENTS
+                      ? cfg->num_students : MAX_STUDENTS;
+    a->tokens       = (float)cfg->admit_burst;
+    hist_reset(&a->wait_hist);
+    rng_seed(&a->rng, cfg->seed, RNG_ARRIVALS, 0);
+
+    char msg[128];
+    const char *names[] = { "CONSTANT", "POISSON", "BURST" };
+    snprintf(msg, sizeof(msg),
+             "Admission initialized (%s arrivals %.2f/tick, bucket %.2f/tick depth %d)",
+             names[cfg->arrival_model], cfg->arrival_rate,
+             cfg->admit_rate, cfg->admit_burst);
+    log_event(ctx, "INFO", "ADMISSION", msg);
+}
+
+void admission_destroy(SimContext *ctx) {
+    free(ctx->admission);
+    ctx->admission = NULL;
+}
+
+// ─── Called exactly once per simulation tick ─────────────
+void admission_tick(SimContext *ctx, int tick) {
+    Admission    *a     = ctx->admission;
+    const Config *cfg   = &ctx->config;
+    SystemState  *state = &ctx->state;
+
+    // 1. New logins join the back of the queue: drawn from the
+    //    arrival model, or the ones a replayed trace has due
+    int pids[MAX_STUDENTS], exam_ticks[MAX_STUDENTS];
+    int arrived;
+    if (trace_replaying(ctx)) {
+        arrived = trace_logins(ctx, tick, pids, exam_ticks, MAX_STUDENTS - a->lq_count);
+    } else {
+        arrived = arrivals_for_tick(ctx, tick);
+        if (arrived > a->max_students - (a->next_pid - 1))
+            arrived = a->max_students - (a->next_pid - 1);
+        for (int i = 0; i < arrived; i++) {
+            pids[i]       = a->next_pid + i;
+            exam_ticks[i] = cfg->exam_duration - (int)rng_below(&a->rng, 10);
+        }
+    }
+
+    for (int i = 0; i < arrived; i++) {
+        a->login_queue[a->lq_tail].pid          = pids[i];
+        a->login_queue[a->lq_tail].arrival_tick = tick;
+        a->login_queue[a->lq_tail].exam_ticks   = exam_ticks[i];
+        a->lq_tail = (a->lq_tail + 1) % MAX_STUDENTS;
+        a->lq_count++;
+        if (pids[i] >= a->next_pid) a->next_pid = pids[i] + 1;
+        trace_record(ctx, tick, pids[i], TRACE_LOGIN, 0, exam_ticks[i], 0);
+    }
+
+    if (arrived > 1) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%d logins arrived (queue=%d)", arrived, a->lq_count);
+        log_event(ctx, "INFO", "ADMISSION", msg);
+    }
+
+    // 2. Refill the bucket, then admit from the head while tokens last.
+    //    I/O back-pressure credits scale the refill; at zero credit
+    //    nobody is admitted, however many tokens are banked.
+    float credit    = io_buffer_credit(ctx);
+    int   unlimited = cfg->admit_rate <= 0.0f;
+    if (!unlimited) {
+        a->tokens += cfg->admit_rate * credit;
+        if (a->tokens > cfg->admit_burst) a->tokens = (float)cfg->admit_burst;
+    }
+
+    int admitted = 0;
+    int held     = credit <= 0.0f ? a->lq_count : 0;
+    while (a->lq_count > 0 && credit > 0.0f && (unlimited || a->tokens >= 1.0f)) {
+        PendingLogin login = a->login_queue[a->lq_head];
+        a->lq_head = (a->lq_head + 1) % MAX_STUDENTS;
+        a->lq_count--;
+        if (!unlimited) a->tokens -= 1.0f;
+
+        int wait = tick - login.arrival_tick;
+        hist_record(&a->wait_hist, wait);
+
+        PCB p = {
+            .pid             = login.pid,
+            .state           = NEW,
+            .priority        = 1,
+            .total_time      = cfg->exam_duration,
+            .remaining_time  = login.exam_ticks,
+            .waiting_time    = wait,
+            .turnaround_time = 0,
+            .pages_used      = 0
+        };
+        scheduler_add_process(ctx, p);
+        admitted++;
+
+        pthread_mutex_lock(&state->lock);
+        if (wait > state->login_wait_max) state->login_wait_max = wait;
+        pthread_mutex_unlock(&state->lock);
+    }
+
+    pthread_mutex_lock(&state->lock);
+    state->logins_arrived  += arrived;
+    state->logins_admitted += admitted;
+    state->login_queue_len  = a->lq_count;
+    state->throttled_logins += held;
+    pthread_mutex_unlock(&state->lock);
+
+    if (a->lq_count > 0 && arrived > 0) {
+        char msg[96];
+        snprintf(msg, sizeof(msg),
+                 "Admission throttled: %d logins waiting for tokens", a->lq_count);
+        log_event(ctx, "WARN", "ADMISSION", msg);
+    }
+}
+
+const Histogram *admission_wait_hist(SimContext *ctx) {
+    return &ctx->admission->wait_hist;
+}
+
+// ─── Snapshot: login queue, pid counter, bucket ──────────
+// Only the scheduler thread runs admission, inside the snapshot gate
+void admission_snapshot(SimContext *ctx, SnapWriter *w) {
+    Admission *a = ctx->admission;
+    snap_put(w, a->login_queue,  sizeof(a->login_queue));
+    snap_put(w, &a->lq_head,     sizeof(a->lq_head));
+    snap_put(w, &a->lq_tail,     sizeof(a->lq_tail));
+    snap_put(w, &a->lq_count,    sizeof(a->lq_count));
+    snap_put(w, &a->next_pid,    sizeof(a->next_pid));
+    snap_put(w, &a->tokens,      sizeof(a->tokens));
+    snap_put(w, &a->arrival_acc, sizeof(a->arrival_acc));
+    snap_put(w, &a->wait_hist,   sizeof(a->wait_hist));
+    snap_put(w, &a->rng,         sizeof(a->rng));
+}
+
+void admission_restore(SimContext *ctx, SnapReader *r) {
+    Admission *a = ctx->admission;
+    snap_get(r, a->login_queue,  sizeof(a->login_queue));
+    snap_get(r, &a->lq_head,     sizeof(a->lq_head));
+    snap_get(r, &a->lq_tail,     sizeof(a->lq_tail));
+    snap_get(r, &a->lq_count,    sizeof(a->lq_count));
+    snap_get(r, &a->next_pid,    sizeof(a->next_pid));
+    snap_get(r, &a->tokens,      sizeof(a->tokens));
+    snap_get(r, &a->arrival_acc, sizeof(a->arrival_acc));
+    snap_get(r, &a->wait_hist,   sizeof(a->wait_hist));
+    snap_get(r, &a->rng,         sizeof(a->rng));
+    if (a->lq_head < 0 || a->lq_head >= MAX_STUDENTS || a->lq_tail < 0 || a->lq_tail >= MAX_STUDENTS ||
+        a->lq_count < 0 || a->lq_count > MAX_STUDENTS || a->next_pid < 1 || a->next_pid > MAX_STUDENTS + 1)
+        r->failed = 1;
+}
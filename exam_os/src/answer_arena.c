@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <string.h>
+#include "answer_arena.h"
+
+enum { SLAB_FREE, SLAB_ACTIVE, SLAB_RETIRED };
+
+void arena_init(AnswerArena *a) {
+    memset(a, 0, sizeof(AnswerArena));
+    pthread_mutex_init(&a->lock, NULL);
+    a->slabs[0].data  = malloc(ARENA_SLAB_BYTES);
+    a->slabs[0].state = SLAB_ACTIVE;
+    a->nslabs  = 1;
+    a->current = 0;
+}
+
+void arena_destroy(AnswerArena *a) {
+    for (int i = 0; i < a->nslabs; i++) free(a->slabs[i].data);
+    pthread_mutex_destroy(&a->lock);
+    a->nslabs = 0;
+}
+
+// ─── Recycling ───────────────────────────────────────────
+// Retired and drained: exactly one caller wins the CAS and frees it
+static void try_recycle(AnswerArena *a, int s) {
+    int expected = SLAB_RETIRED;
+    if (!__atomic_compare_exchange_n(&a->slabs[s].state, &expected, SLAB_FREE, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        return;
+    pthread_mutex_lock(&a->lock);
+    a->free_list[a->free_count++] = s;
+    a->recycled++;
+    pthread_mutex_unlock(&a->lock);
+}
+
+static void unref(AnswerArena *a, int s, int n) {
+    if (__atomic_sub_fetch(&a->slabs[s].live, n, __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&a->slabs[s].state, __ATOMIC_SEQ_CST) == SLAB_RETIRED)
+        try_recycle(a, s);
+}
+
+// Replace the full slab with a recycled or new one. -1 if the
+// arena is at ARENA_MAX_SLABS and nothing has drained yet.
+static int switch_slab(AnswerArena *a, int full) {
+    pthread_mutex_lock(&a->lock);
+    if (__atomic_load_n(&a->current, __ATOMIC_ACQUIRE) != full) {
+        pthread_mutex_unlock(&a->lock);
+        return 0;   // another producer already switched
+    }
+    int next = -1;
+    if (a->free_count > 0) {
+        next = a->free_list[--a->free_count];
+    } else if (a->nslabs < ARENA_MAX_SLABS) {
+        char *data = malloc(ARENA_SLAB_BYTES);
+        if (data) {
+            next = a->nslabs;
+            a->slabs[next].data = data;
+            a->nslabs++;
+        }
+    }
+    if (next < 0) {
+        a->exhausted++;
+        pthread_mutex_unlock(&a->lock);
+        return -1;
+    }
+    a->slabs[next].used = 0;
+    __atomic_store_n(&a->slabs[next].state, SLAB_ACTIVE, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&a->current, next, __ATOMIC_RELEASE);
+    __atomic_store_n(&a->slabs[full].state, SLAB_RETIRED, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&a->lock);
+
+    // Everything in it may already have been flushed
+    if (__atomic_load_n(&a->slabs[full].live, __ATOMIC_SEQ_CST) == 0)
+        try_recycle(a, full);
+    return 0;
+}
+
+// ─── Producer side ───────────────────────────────────────
+// Take a reference on the current slab first, then confirm it is
+// still current: a stale index may point at a slab that was recycled
+// in between, and the reference keeps it from being recycled again.
+int arena_put(AnswerArena *a, const char *text, AnswerRef *out) {
+    int len = (int)strnlen(text, MAX_ANSWER_BYTES);
+    if (len == MAX_ANSWER_BYTES && text[len] != '\0')
+        __atomic_add_fetch(&a->truncated, 1, __ATOMIC_RELAXED);
+
+    while (1) {
+        int s = __atomic_load_n(&a->current, __ATOMIC_ACQUIRE);
+        ArenaSlab *slab = &a->slabs[s];
+        __atomic_add_fetch(&slab->live, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&a->current, __ATOMIC_SEQ_CST) != s) {
+            unref(a, s, 1);
+            continue;
+        }
+
+        long off = __atomic_fetch_add(&slab->used, len, __ATOMIC_RELAXED);
+        if (off + len <= ARENA_SLAB_BYTES) {
+            memcpy(slab->data + off, text, len);
+            out->slab   = s;
+            out->offset = (int)off;
+            out->len    = len;
+            __atomic_add_fetch(&a->bytes, len, __ATOMIC_RELAXED);
+            return 0;
+        }
+        unref(a, s, 1);
+        if (switch_slab(a, s) != 0) return -1;
+    }
+}
+
+const char *arena_get(const AnswerArena *a, AnswerRef ref) {
+    return a->slabs[ref.slab].data + ref.offset;
+}
+
+// ─── Flusher side: bulk release ──────────────────────────
+// Consecutive answers mostly share a slab, so each run costs one
+// atomic subtraction
+void arena_release(AnswerArena *a, const int *slabs, int n) {
+    int i = 0;
+    while (i < n) {
+        int s = slabs[i], run = 1;
+        while (i + run < n && slabs[i + run] == s) run++;
+        unref(a, s, run);
+        i += run;
+    }
+}
+
+int arena_slabs(const AnswerArena *a) {
+    return __atomic_load_n(&a->nslabs, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,599 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/uio.h>
+#include "bench.h"
+#include "proc_table.h"
+#include "histogram.h"
+#include "submission_store.h"
+#include "wal.h"
+#include "rng.h"
+
+// ─── Timestamp ────────────────────────────────────────────
+static long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// ════════════════════════════════════════════════════════
+//  PROCESS TABLE: array-of-structs vs structure-of-arrays
+// ════════════════════════════════════════════════════════
+
+// The pre-SoA per-tick sweep, minus the lock juggling
+static int aos_tick(PCB *p, int n, int *expired, int max) {
+    int fired = 0;
+    for (int i = 0; i < n; i++) {
+        if (p[i].state == RUNNING || p[i].state == READY) {
+            p[i].remaining_time--;
+            if (p[i].remaining_time <= 0) {
+                p[i].state = TERMINATED;
+                if (fired < max) expired[fired] = p[i].pid;
+                fired++;
+            }
+        }
+    }
+    return fired;
+}
+
+static int aos_count_state(const PCB *p, int n, ProcessState state) {
+    int c = 0;
+    for (int i = 0; i < n; i++)
+        c += (p[i].state == state);
+    return c;
+}
+
+static void bench_proctable() {
+    const int sizes[] = { 10000, 100000, 1000000 };
+    int *expired = malloc(sizeof(int) * 1000000);
+
+    printf("Process table sweeps (ns per process, lower is better)\n\n");
+    printf("  %-9s | %-27s | %-27s\n", "", "decrement + detect expiry", "count by state");
+    printf("  %-9s | %8s %8s %8s | %8s %8s %8s\n",
+           "processes", "AoS", "SoA", "speedup", "AoS", "SoA", "speedup");
+    printf("  ----------+-----------------------------+----------------------------\n");
+
+    for (int s = 0; s < 3; s++) {
+        int n     = sizes[s];
+        int iters = 20000000 / n;
+        if (iters < 10) iters = 10;
+
+        PCB *aos = malloc(sizeof(PCB) * n);
+        ProcTable soa;
+        proc_table_init(&soa, n);
+
+        // Mostly live processes, deadlines spread so a few expire per sweep
+        Rng rng;
+        rng_seed(&rng, 42, RNG_BENCH, 0);
+        for (int i = 0; i < n; i++) {
+            int r = rng_below(&rng, 100);
+            PCB p = {
+                .pid            = i + 1,
+                .state          = r < 80 ? READY : (r < 85 ? RUNNING : TERMINATED),
+                .priority       = 1,
+                .total_time     = 100000,
+                .remaining_time = iters / 2 + rng_below(&rng, iters * 4),
+                .deadline_tick  = 0
+            };
+            aos[i] = p;
+            proc_table_append(&soa, &p);
+        }
+
+        long t0 = now_ns();
+        long aos_fired = 0;
+        for (int it = 0; it < iters; it++)
+            aos_fired += aos_tick(aos, n, expired, n);
+        long t1 = now_ns();
+        long soa_fired = 0;
+        for (int it = 0; it < iters; it++)
+            soa_fired += proc_table_tick(&soa, expired, n);
+        long t2 = now_ns();
+
+        long aos_live = 0, soa_live = 0;
+        for (int it = 0; it < iters; it++)
+            aos_live += aos_count_state(aos, n, READY);
+        long t3 = now_ns();
+        for (int it = 0; it < iters; it++)
+            soa_live += proc_table_count_state(&soa, READY);
+        long t4 = now_ns();
+
+        double visits    = (double)n * iters;
+        double sweep_aos = (t1 - t0) / visits, sweep_soa = (t2 - t1) / visits;
+        double count_aos = (t3 - t2) / visits, count_soa = (t4 - t3) / visits;
+
+        printf("  %-9d | %8.3f %8.3f %7.1fx | %8.3f %8.3f %7.1fx%s\n",
+               n, sweep_aos, sweep_soa, sweep_aos / sweep_soa,
+               count_aos, count_soa, count_aos / count_soa,
+               (aos_fired != soa_fired || aos_live != soa_live) ? "  MISMATCH" : "");
+
+        proc_table_free(&soa);
+        free(aos);
+    }
+
+    printf("\n  (%d-byte PCB vs 1-byte state + 4-byte remaining_time per process)\n",
+           (int)sizeof(PCB));
+    free(expired);
+}
+
+// ════════════════════════════════════════════════════════
+//  SUBMISSION RING: semaphores + mutexes vs lock-free MPSC
+// ════════════════════════════════════════════════════════
+
+#define SUB_RING_CAP   256
+#define SUB_PER_THREAD 200000
+
+// The pre-MPSC path: trywait, buffer lock with the state lock nested
+// inside, post; the flusher repeats the dance per item
+static struct {
+    Submission      buf[SUB_RING_CAP];
+    int             head, tail, count;
+    sem_t           empty, filled;
+    pthread_mutex_t lock, state_lock;
+    int             state_count;
+} locked;
+
+static int locked_push(const Submission *s) {
+    if (sem_trywait(&locked.empty) != 0) return -1;
+    pthread_mutex_lock(&locked.lock);
+    locked.buf[locked.tail] = *s;
+    locked.tail = (locked.tail + 1) % SUB_RING_CAP;
+    locked.count++;
+    pthread_mutex_lock(&locked.state_lock);
+    locked.state_count = locked.count;
+    pthread_mutex_unlock(&locked.state_lock);
+    pthread_mutex_unlock(&locked.lock);
+    sem_post(&locked.filled);
+    return 0;
+}
+
+static int locked_pop(Submission *out) {
+    if (sem_trywait(&locked.filled) != 0) return 0;
+    pthread_mutex_lock(&locked.lock);
+    *out = locked.buf[locked.head];
+    locked.head = (locked.head + 1) % SUB_RING_CAP;
+    locked.count--;
+    pthread_mutex_lock(&locked.state_lock);
+    locked.state_count = locked.count;
+    pthread_mutex_unlock(&locked.state_lock);
+    pthread_mutex_unlock(&locked.lock);
+    sem_post(&locked.empty);
+    return 1;
+}
+
+// Same cell protocol as io_buffer.c
+static SubmitCell mpsc_cells[SUB_RING_CAP];
+static long mpsc_enq __attribute__((aligned(64)));
+static long mpsc_deq __attribute__((aligned(64)));
+
+static int mpsc_push(const Submission *s) {
+    long pos = __atomic_load_n(&mpsc_enq, __ATOMIC_RELAXED);
+    SubmitCell *cell;
+    while (1) {
+        cell = &mpsc_cells[pos & (SUB_RING_CAP - 1)];
+        long dif = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos;
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&mpsc_enq, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (dif < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&mpsc_enq, __ATOMIC_RELAXED);
+        }
+    }
+    cell->sub = *s;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int mpsc_pop(Submission *out) {
+    static Submission batch[SUB_RING_CAP];
+    static int have = 0, next = 0;
+    if (next == have) {
+        long pos = mpsc_deq;
+        have = next = 0;
+        while (have < SUB_RING_CAP) {
+            SubmitCell *c = &mpsc_cells[(pos + have) & (SUB_RING_CAP - 1)];
+            if (__atomic_load_n(&c->seq, __ATOMIC_ACQUIRE) != pos + have + 1) break;
+            batch[have++] = c->sub;
+        }
+        for (int i = 0; i < have; i++)
+            __atomic_store_n(&mpsc_cells[(pos + i) & (SUB_RING_CAP - 1)].seq,
+                             pos + i + SUB_RING_CAP, __ATOMIC_RELEASE);
+        __atomic_store_n(&mpsc_deq, pos + have, __ATOMIC_RELEASE);
+        if (have == 0) return 0;
+    }
+    *out = batch[next++];
+    return 1;
+}
+
+typedef struct {
+    int (*push)(const Submission *);
+    Histogram lat;      // per producer, so recording doesn't contend
+    long accepted;
+} SubProducer;
+
+static int sub_stop = 0;
+
+static void *sub_producer(void *arg) {
+    SubProducer *p = arg;
+    Submission s = { .pid = 1, .question_id = 1 };
+    for (int i = 0; i < SUB_PER_THREAD; i++) {
+        long t0 = now_ns();
+        int ok = p->push(&s) == 0;
+        hist_record(&p->lat, now_ns() - t0);
+        if (ok) p->accepted++;
+        else    sched_yield();   // full: let the flusher catch up
+    }
+    return NULL;
+}
+
+static void *sub_consumer(void *arg) {
+    int (*pop)(Submission *) = arg;
+    Submission s;
+    while (!__atomic_load_n(&sub_stop, __ATOMIC_ACQUIRE))
+        if (!pop(&s)) sched_yield();
+    while (pop(&s)) ;
+    return NULL;
+}
+
+static void sub_run(int producers, int (*push)(const Submission *),
+                    int (*pop)(Submission *), double *mops, long *p99) {
+    static SubProducer p[8];
+    static Histogram   lat;
+    hist_reset(&lat);
+    pthread_t   t[8], consumer;
+
+    sub_stop = 0;
+    pthread_create(&consumer, NULL, sub_consumer, (void *)pop);
+    long t0 = now_ns();
+    for (int i = 0; i < producers; i++) {
+        p[i].push = push;
+        p[i].accepted = 0;
+        hist_reset(&p[i].lat);
+        pthread_create(&t[i], NULL, sub_producer, &p[i]);
+    }
+    for (int i = 0; i < producers; i++) pthread_join(t[i], NULL);
+    long t1 = now_ns();
+    __atomic_store_n(&sub_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(consumer, NULL);
+
+    // Merge per-producer histograms; throughput counts accepted only
+    long accepted = 0;
+    for (int i = 0; i < producers; i++) {
+        accepted += p[i].accepted;
+        for (int b = 0; b < HIST_BUCKETS; b++) lat.counts[b] += p[i].lat.counts[b];
+        lat.count += p[i].lat.count;
+        if (p[i].lat.max > lat.max) lat.max = p[i].lat.max;
+    }
+    *mops = accepted / ((t1 - t0) / 1000.0);
+    *p99  = hist_percentile(&lat, 99.0);
+}
+
+static void bench_submit() {
+    printf("Submission ring, %d-slot ring, %d submits per producer\n\n",
+           SUB_RING_CAP, SUB_PER_THREAD);
+    printf("  %-9s | %-25s | %-25s\n", "",
+           "accepted / us", "submit p99 ns");
+    printf("  %-9s | %8s %8s %7s | %8s %8s %7s\n",
+           "producers", "locked", "mpsc", "speedup", "locked", "mpsc", "ratio");
+    printf("  ----------+---------------------------+--------------------------\n");
+
+    const int counts[] = { 1, 2, 4, 8 };
+    for (int c = 0; c < 4; c++) {
+        double lk_mops, mp_mops;
+        long   lk_p99,  mp_p99;
+
+        sem_init(&locked.empty, 0, SUB_RING_CAP);
+        sem_init(&locked.filled, 0, 0);
+        pthread_mutex_init(&locked.lock, NULL);
+        pthread_mutex_init(&locked.state_lock, NULL);
+        locked.head = locked.tail = locked.count = 0;
+        sub_run(counts[c], locked_push, locked_pop, &lk_mops, &lk_p99);
+        sem_destroy(&locked.empty);
+        sem_destroy(&locked.filled);
+        pthread_mutex_destroy(&locked.lock);
+        pthread_mutex_destroy(&locked.state_lock);
+
+        for (long i = 0; i < SUB_RING_CAP; i++) mpsc_cells[i].seq = i;
+        mpsc_enq = mpsc_deq = 0;
+        sub_run(counts[c], mpsc_push, mpsc_pop, &mp_mops, &mp_p99);
+
+        printf("  %-9d | %8.2f %8.2f %6.1fx | %8ld %8ld %6.1fx\n",
+               counts[c], lk_mops, mp_mops, mp_mops / lk_mops,
+               lk_p99, mp_p99, mp_p99 > 0 ? (double)lk_p99 / mp_p99 : 0.0);
+    }
+    printf("\n  (full ring drops, as in io_buffer_submit; only accepted submits count)\n");
+}
+
+// ─── Sharded flush: N writers, N segments vs one file ─────
+// A fixed amount of flush work (writev of a formatted batch followed
+// by fdatasync, as DURABILITY = FDATASYNC does) split across N
+// flusher threads, each with its own segment file.
+#define SHARD_FLUSHES   256
+#define SHARD_BATCH     256
+#define SHARD_LINE      64
+
+typedef struct {
+    int  fd;
+    int  flushes;
+    char buf[SHARD_BATCH * SHARD_LINE];
+} ShardWriter;
+
+static void *shard_writer(void *arg) {
+    ShardWriter *w = arg;
+    struct iovec iov = { w->buf, sizeof(w->buf) };
+    for (int i = 0; i < w->flushes; i++) {
+        if (writev(w->fd, &iov, 1) < 0) break;
+        fdatasync(w->fd);
+    }
+    return NULL;
+}
+
+static double shard_run(int shards) {
+    static ShardWriter w[MAX_IO_SHARDS];
+    pthread_t t[MAX_IO_SHARDS];
+
+    for (int i = 0; i < shards; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "output/bench.shard%d.tmp", i);
+        w[i].fd      = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        w[i].flushes = SHARD_FLUSHES / shards;
+        memset(w[i].buf, 'x', sizeof(w[i].buf));
+    }
+    long t0 = now_ns();
+    for (int i = 0; i < shards; i++) pthread_create(&t[i], NULL, shard_writer, &w[i]);
+    for (int i = 0; i < shards; i++) pthread_join(t[i], NULL);
+    long t1 = now_ns();
+
+    for (int i = 0; i < shards; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "output/bench.shard%d.tmp", i);
+        close(w[i].fd);
+        unlink(path);
+    }
+    return (double)SHARD_FLUSHES * SHARD_BATCH / ((t1 - t0) / 1e9);
+}
+
+static void bench_shards() {
+    printf("Sharded flush, %d flushes of %d submissions, fdatasync each\n\n",
+           SHARD_FLUSHES, SHARD_BATCH);
+    printf("  %-6s | %14s | %7s\n", "shards", "submissions/s", "scaling");
+    printf("  -------+----------------+--------\n");
+
+    const int counts[] = { 1, 2, 4, 8 };
+    double base = 0.0;
+    for (int c = 0; c < 4; c++) {
+        double rate = shard_run(counts[c]);
+        if (c == 0) base = rate;
+        printf("  %-6d | %14.0f | %6.2fx\n", counts[c], rate, rate / base);
+    }
+}
+
+// ─── Binary store: appends, compaction, O(1) lookups ─────
+// STORE_APPENDS submissions over STORE_KEYS (pid, question) keys, so
+// every key is overwritten ~20 times and compaction has work to do.
+// Lookups go through the mmap'd index; the baseline scans every
+// segment for the key's highest seq, as a text log would need.
+#define STORE_APPENDS   1000000
+#define STORE_KEYS      50000
+#define STORE_BATCH     256
+#define STORE_LOOKUPS   100000
+#define STORE_SCANS     20
+#define STORE_DIR       "output/bench-store"
+
+static void remove_dir(const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (e->d_name[0] == '.') continue;
+        char path[400];
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        unlink(path);
+    }
+    closedir(d);
+    rmdir(dir);
+}
+
+static int scan_lookup(const StoreReader *r, int pid, int qid) {
+    uint64_t best = 0;
+    for (uint32_t id = 0; id < r->nsegs; id++) {
+        if (!r->seg_base[id]) continue;
+        size_t at = sizeof(StoreSegmentHeader);
+        while (at + sizeof(StoreRecordHeader) <= r->seg_len[id]) {
+            const StoreRecordHeader *h = (const StoreRecordHeader *)(r->seg_base[id] + at);
+            if (h->pid == pid && h->question_id == qid && h->seq > best) best = h->seq;
+            at += sizeof(*h) + h->len;
+        }
+    }
+    return best > 0;
+}
+
+static void bench_store() {
+    printf("Binary submission store, %d appends over %d keys, batches of %d\n\n",
+           STORE_APPENDS, STORE_KEYS, STORE_BATCH);
+
+    SubmissionStore *s = store_open(STORE_DIR, 1024 * 1024, 0);
+    if (!s) {
+        fprintf(stderr, "Could not open %s\n", STORE_DIR);
+        return;
+    }
+    static Submission  batch[STORE_BATCH];
+    static char        text[STORE_BATCH][48];
+    const char        *answers[STORE_BATCH];
+    Rng rng;
+    rng_seed(&rng, 1, RNG_BENCH, 0);
+
+    long t0 = now_ns(), compact_ns = 0;
+    for (int done = 0; done < STORE_APPENDS; done += STORE_BATCH) {
+        for (int i = 0; i < STORE_BATCH; i++) {
+            int key = rng_below(&rng, STORE_KEYS);
+            batch[i].pid         = key / 10 + 1;
+            batch[i].question_id = key % 10 + 1;
+            batch[i].timestamp   = done + i;
+            batch[i].is_partial  = 0;
+            batch[i].answer.len  = snprintf(text[i], sizeof(text[i]), "ANSWER_Q%d_PID%d_V%d",
+                                            batch[i].question_id, batch[i].pid, done + i);
+            answers[i] = text[i];
+        }
+        store_append(s, batch, answers, STORE_BATCH);
+        if ((done / STORE_BATCH) % 256 == 255) {
+            long c0 = now_ns();
+            store_compact(s);
+            compact_ns += now_ns() - c0;
+        }
+    }
+    long t1 = now_ns();
+    store_sync(s);
+    StoreStats st;
+    store_stats(s, &st);
+    store_close(s);
+
+    printf("  append      : %.2f M records/s (%.0f ms incl. %.0f ms compacting)\n",
+           STORE_APPENDS / ((t1 - t0) / 1e9) / 1e6, (t1 - t0) / 1e6, compact_ns / 1e6);
+    printf("  compaction  : %ld passes, %ld segments left, %.1f MB reclaimed\n",
+           st.compactions, st.segments, st.reclaimed_bytes / 1048576.0);
+
+    StoreReader r;
+    long o0 = now_ns();
+    if (store_reader_open(&r, STORE_DIR) != 0) {
+        fprintf(stderr, "Could not read %s\n", STORE_DIR);
+        remove_dir(STORE_DIR);
+        return;
+    }
+    long o1 = now_ns();
+
+    static Histogram idx_hist;
+    hist_reset(&idx_hist);
+    int found = 0;
+    for (int i = 0; i < STORE_LOOKUPS; i++) {
+        int key = rng_below(&rng, STORE_KEYS);
+        StoreRecord rec;
+        long l0 = now_ns();
+        found += store_lookup(&r, key / 10 + 1, key % 10 + 1, &rec) == 0;
+        hist_record(&idx_hist, now_ns() - l0);
+    }
+    long scan_ns = 0;
+    for (int i = 0; i < STORE_SCANS; i++) {
+        int  key = rng_below(&rng, STORE_KEYS);
+        long l0  = now_ns();
+        scan_lookup(&r, key / 10 + 1, key % 10 + 1);
+        scan_ns += now_ns() - l0;
+    }
+    printf("  reader open : %.2f ms (%s)\n", (o1 - o0) / 1e6,
+           r.rebuilt ? "index rebuilt" : "mmap'd index");
+    printf("  lookup      : p50 %ld ns, p99 %ld ns (%d/%d found)\n",
+           hist_percentile(&idx_hist, 50.0), hist_percentile(&idx_hist, 99.0),
+           found, STORE_LOOKUPS);
+    printf("  full scan   : %.2f ms per lookup (%.0fx slower)\n",
+           scan_ns / 1e6 / STORE_SCANS,
+           (double)scan_ns / STORE_SCANS / (hist_percentile(&idx_hist, 50.0) + 1));
+
+    store_reader_close(&r);
+    remove_dir(STORE_DIR);
+}
+
+// ─── WAL: group commit, then recovery time vs log size ───
+// Each log is written through the group committer by WAL_WRITERS
+// threads waiting on their own records, then scanned and replayed as
+// a restart after a crash would (nothing checkpointed).
+#define WAL_WRITERS  4
+#define WAL_DIR      "output/bench-wal"
+
+typedef struct {
+    Wal            *wal;
+    pthread_mutex_t *lock;
+    uint64_t       *next;
+    long            count;
+} WalWriter;
+
+static void *wal_writer(void *arg) {
+    WalWriter *w = arg;
+    char text[64];
+    for (long i = 0; i < w->count; i++) {
+        Submission s;
+        memset(&s, 0, sizeof(s));
+        s.pid         = (int)(i % 5000) + 1;
+        s.question_id = (int)(i % 10) + 1;
+        s.timestamp   = i;
+        s.answer.len  = snprintf(text, sizeof(text), "ANSWER_Q%d_PID%d_%ld", s.question_id, s.pid, i);
+        pthread_mutex_lock(w->lock);
+        uint64_t lsn = ++*w->next;
+        wal_append(w->wal, lsn, 0, &s, text);
+        pthread_mutex_unlock(w->lock);
+        // Only every 64th record waits: enough writers in flight to fill groups
+        if (i % 64 == 63 || i == w->count - 1) wal_wait(w->wal, lsn);
+    }
+    return NULL;
+}
+
+static void count_replayed(void *ctx, const WalRecordHeader *h, const char *answer) {
+    (void)answer;
+    long *bytes = ctx;
+    *bytes += h->len;
+}
+
+static void bench_wal() {
+    printf("Write-ahead log: %d writers, 2 ms group commit, then recovery\n\n", WAL_WRITERS);
+    printf("  %-9s | %8s | %9s | %8s | %10s | %12s\n",
+           "records", "log MB", "commits", "append/s", "recover ms", "records/s");
+    printf("  ----------+----------+-----------+----------+------------+-------------\n");
+
+    const long sizes[] = { 10000, 100000, 1000000 };
+    for (int c = 0; c < 3; c++) {
+        Wal *wal = wal_open(WAL_DIR, 2);
+        if (!wal) {
+            fprintf(stderr, "Could not open %s\n", WAL_DIR);
+            return;
+        }
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        uint64_t  next = 0;
+        WalWriter w[WAL_WRITERS];
+        pthread_t t[WAL_WRITERS];
+        long t0 = now_ns();
+        for (int i = 0; i < WAL_WRITERS; i++) {
+            w[i] = (WalWriter){ wal, &lock, &next, sizes[c] / WAL_WRITERS };
+            pthread_create(&t[i], NULL, wal_writer, &w[i]);
+        }
+        for (int i = 0; i < WAL_WRITERS; i++) pthread_join(t[i], NULL);
+        long t1 = now_ns();
+        WalStats st;
+        wal_stats(wal, &st);
+        wal_close(wal);
+
+        // Recovery = scan (checkpoint, crash check) + replay above it
+        long r0 = now_ns();
+        WalScan scan;
+        wal_scan(WAL_DIR, &scan);
+        long bytes = 0;
+        long replayed = wal_replay(WAL_DIR, scan.checkpoint, count_replayed, &bytes);
+        long r1 = now_ns();
+
+        printf("  %-9ld | %8.1f | %9ld | %7.0fk | %10.1f | %11.0fk\n",
+               replayed, scan.bytes / 1048576.0, st.commits,
+               sizes[c] / ((t1 - t0) / 1e9) / 1e3, (r1 - r0) / 1e6,
+               replayed / ((r1 - r0) / 1e9) / 1e3);
+        wal_remove(WAL_DIR);
+    }
+    rmdir(WAL_DIR);
+}
+
+// ─── Dispatcher ───────────────────────────────────────────
+int bench_run(const char *name) {
+    if (strcmp(name, "proctable") == 0) { bench_proctable(); return 0; }
+    if (strcmp(name, "submit")    == 0) { bench_submit();    return 0; }
+    if (strcmp(name, "shards")    == 0) { bench_shards();    return 0; }
+    if (strcmp(name, "store")     == 0) { bench_store();     return 0; }
+    if (strcmp(name, "wal")       == 0) { bench_wal();       return 0; }
+
+    fprintf(stderr, "Unknown benchmark '%s' (available: proctable, submit, shards, store, wal)\n", name);
+    return -1;
+}
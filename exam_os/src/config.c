@@ -12,7 +12,104 @@ void config_load_defaults(Config *cfg) {
     cfg->sched_algo      = PRIORITY;
     cfg->page_algo       = LRU;
     cfg->buffer_capacity = 256;
+    cfg->buffer_max_capacity = 0;
+    cfg->io_shards       = 1;
+    cfg->submit_policy   = SUBMIT_DROP;
+    cfg->submit_wait_ms  = 500;
+    cfg->durability      = DURABILITY_NONE;
+    cfg->group_commit_ms = 50;
+    cfg->flush_policy    = FLUSH_FIXED;
+    cfg->flush_target_ms = 500;
+    cfg->store_enabled   = 0;
+    cfg->coalesce        = 0;
+    cfg->wal_enabled     = 0;
+    cfg->wal_commit_ms   = 2;
+    cfg->store_segment_kb = 1024;
+    cfg->snapshot_ticks  = 0;
+    cfg->restore_path[0] = '\0';
+    cfg->replay_path[0]  = '\0';
+    cfg->trace_dump[0]   = '\0';
+    cfg->trace_capture   = 0;
+    snprintf(cfg->output_dir, sizeof(cfg->output_dir), "output");
+    cfg->headless        = 0;
+    cfg->runtime         = RUNTIME_THREADS;
+    cfg->sweep[0]        = '\0';
+    cfg->sweep_jobs      = 0;
+    cfg->seed            = 0;
     cfg->demo_mode       = 0;
+    cfg->bench[0]        = '\0';
+    cfg->merge_only      = 0;
+    cfg->lookup_pid      = 0;
+    cfg->lookup_qid      = 0;
+
+    cfg->arrival_model      = ARRIVAL_CONSTANT;
+    cfg->arrival_rate       = 0.5f;   // old behaviour: 5 students / 10 ticks
+    cfg->arrival_burst_tick = 20;
+    cfg->admit_rate         = 2.0f;
+    cfg->admit_burst        = 5;
+
+    cfg->int_queue_capacity = 256;
+    cfg->bh_workers         = 2;
+    cfg->storm_mask_threshold = 8;
+}
+
+static DurabilityMode parse_durability(const char *val) {
+    if (strcmp(val, "FDATASYNC") == 0) return DURABILITY_FDATASYNC;
+    if (strcmp(val, "GROUP")     == 0) return DURABILITY_GROUP;
+    return DURABILITY_NONE;
+}
+
+static ArrivalModel parse_arrival(const char *val) {
+    if (strcmp(val, "POISSON") == 0) return ARRIVAL_POISSON;
+    if (strcmp(val, "BURST")   == 0) return ARRIVAL_BURST;
+    return ARRIVAL_CONSTANT;
+}
+
+// One KEY = VALUE setting, as in config.conf; 0 if the key is unknown
+int config_set(Config *cfg, const char *key, const char *val) {
+    if      (strcmp(key, "NUM_STUDENTS")     == 0) cfg->num_students    = atoi(val);
+    else if (strcmp(key, "MEMORY_FRAMES")    == 0) cfg->memory_frames   = atoi(val);
+    else if (strcmp(key, "PAGE_SIZE")        == 0) cfg->page_size       = atoi(val);
+    else if (strcmp(key, "TIME_QUANTUM")     == 0) cfg->time_quantum    = atoi(val);
+    else if (strcmp(key, "EXAM_DURATION")    == 0) cfg->exam_duration   = atoi(val);
+    else if (strcmp(key, "BUFFER_CAPACITY")  == 0) cfg->buffer_capacity = atoi(val);
+    else if (strcmp(key, "BUFFER_MAX_CAPACITY") == 0) cfg->buffer_max_capacity = atoi(val);
+    else if (strcmp(key, "IO_SHARDS")        == 0) cfg->io_shards       = atoi(val);
+    else if (strcmp(key, "SUBMIT_POLICY")    == 0)
+        cfg->submit_policy = (strcmp(val, "BLOCK") == 0) ? SUBMIT_BLOCK : SUBMIT_DROP;
+    else if (strcmp(key, "SUBMIT_WAIT_MS")   == 0) cfg->submit_wait_ms  = atoi(val);
+    else if (strcmp(key, "DURABILITY")       == 0) cfg->durability      = parse_durability(val);
+    else if (strcmp(key, "GROUP_COMMIT_MS")  == 0) cfg->group_commit_ms = atoi(val);
+    else if (strcmp(key, "FLUSH_POLICY")     == 0)
+        cfg->flush_policy = (strcmp(val, "ADAPTIVE") == 0) ? FLUSH_ADAPTIVE : FLUSH_FIXED;
+    else if (strcmp(key, "FLUSH_TARGET_MS")  == 0) cfg->flush_target_ms = atoi(val);
+    else if (strcmp(key, "STORE")            == 0) cfg->store_enabled   = strcmp(val, "ON") == 0;
+    else if (strcmp(key, "STORE_SEGMENT_KB") == 0) cfg->store_segment_kb = atoi(val);
+    else if (strcmp(key, "COALESCE")         == 0) cfg->coalesce        = strcmp(val, "ON") == 0;
+    else if (strcmp(key, "WAL")              == 0) cfg->wal_enabled     = strcmp(val, "ON") == 0;
+    else if (strcmp(key, "WAL_COMMIT_MS")    == 0) cfg->wal_commit_ms   = atoi(val);
+    else if (strcmp(key, "SNAPSHOT_TICKS")   == 0) cfg->snapshot_ticks  = atoi(val);
+    else if (strcmp(key, "OUTPUT_DIR")       == 0)
+        snprintf(cfg->output_dir, sizeof(cfg->output_dir), "%s", val);
+    else if (strcmp(key, "SCHEDULING_ALGO")  == 0)
+        cfg->sched_algo = (strcmp(val, "ROUND_ROBIN") == 0) ? ROUND_ROBIN : PRIORITY;
+    else if (strcmp(key, "PAGE_REPLACE")     == 0)
+        cfg->page_algo  = (strcmp(val, "FIFO") == 0) ? FIFO : LRU;
+    else if (strcmp(key, "ARRIVAL_MODEL")    == 0) cfg->arrival_model      = parse_arrival(val);
+    else if (strcmp(key, "ARRIVAL_RATE")     == 0) cfg->arrival_rate       = atof(val);
+    else if (strcmp(key, "ARRIVAL_BURST_TICK") == 0) cfg->arrival_burst_tick = atoi(val);
+    else if (strcmp(key, "ADMIT_RATE")       == 0) cfg->admit_rate         = atof(val);
+    else if (strcmp(key, "ADMIT_BURST")      == 0) cfg->admit_burst        = atoi(val);
+    else if (strcmp(key, "INT_QUEUE_CAPACITY") == 0) cfg->int_queue_capacity = atoi(val);
+    else if (strcmp(key, "BH_WORKERS")       == 0) cfg->bh_workers         = atoi(val);
+    else if (strcmp(key, "INT_STORM_MASK")   == 0) cfg->storm_mask_threshold = atoi(val);
+    else if (strcmp(key, "SWEEP_JOBS")       == 0) cfg->sweep_jobs         = atoi(val);
+    else if (strcmp(key, "RUNTIME")          == 0)
+        cfg->runtime = (strcmp(val, "REACTOR") == 0) ? RUNTIME_REACTOR : RUNTIME_THREADS;
+    else if (strcmp(key, "SEED")             == 0) cfg->seed = strtoull(val, NULL, 0);
+    else if (strcmp(key, "TRACE_CAPTURE")    == 0) cfg->trace_capture = strcmp(val, "ON") == 0;
+    else return 0;
+    return 1;
 }
 
 int config_parse_file(Config *cfg, const char *filepath) {
@@ -22,17 +119,7 @@ int config_parse_file(Config *cfg, const char *filepath) {
     char key[64], val[64];
     while (fscanf(f, "%63s = %63s", key, val) == 2) {
         if (key[0] == '#') continue;  // skip comments
-
-        if      (strcmp(key, "NUM_STUDENTS")     == 0) cfg->num_students    = atoi(val);
-        else if (strcmp(key, "MEMORY_FRAMES")    == 0) cfg->memory_frames   = atoi(val);
-        else if (strcmp(key, "PAGE_SIZE")        == 0) cfg->page_size       = atoi(val);
-        else if (strcmp(key, "TIME_QUANTUM")     == 0) cfg->time_quantum    = atoi(val);
-        else if (strcmp(key, "EXAM_DURATION")    == 0) cfg->exam_duration   = atoi(val);
-        else if (strcmp(key, "BUFFER_CAPACITY")  == 0) cfg->buffer_capacity = atoi(val);
-        else if (strcmp(key, "SCHEDULING_ALGO")  == 0)
-            cfg->sched_algo = (strcmp(val, "ROUND_ROBIN") == 0) ? ROUND_ROBIN : PRIORITY;
-        else if (strcmp(key, "PAGE_REPLACE")     == 0)
-            cfg->page_algo  = (strcmp(val, "FIFO") == 0) ? FIFO : LRU;
+        config_set(cfg, key, val);
     }
 
     fclose(f);
@@ -49,10 +136,69 @@ void config_parse_args(Config *cfg, int argc, char *argv[]) {
             cfg->sched_algo = (strcmp(argv[++i], "RR") == 0) ? ROUND_ROBIN : PRIORITY;
         else if (strcmp(argv[i], "--page")     == 0 && i+1 < argc)
             cfg->page_algo  = (strcmp(argv[++i], "FIFO") == 0) ? FIFO : LRU;
+        else if (strcmp(argv[i], "--buffer")   == 0 && i+1 < argc) cfg->buffer_capacity = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--buffer-max")   == 0 && i+1 < argc) cfg->buffer_max_capacity = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--io-shards")    == 0 && i+1 < argc) cfg->io_shards = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--merge")    == 0) cfg->merge_only = 1;
+        else if (strcmp(argv[i], "--submit-policy") == 0 && i+1 < argc)
+            cfg->submit_policy = (strcmp(argv[++i], "BLOCK") == 0) ? SUBMIT_BLOCK : SUBMIT_DROP;
+        else if (strcmp(argv[i], "--submit-wait")  == 0 && i+1 < argc) cfg->submit_wait_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--durability")   == 0 && i+1 < argc) cfg->durability = parse_durability(argv[++i]);
+        else if (strcmp(argv[i], "--group-commit") == 0 && i+1 < argc) cfg->group_commit_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--flush-policy") == 0 && i+1 < argc)
+            cfg->flush_policy = (strcmp(argv[++i], "ADAPTIVE") == 0) ? FLUSH_ADAPTIVE : FLUSH_FIXED;
+        else if (strcmp(argv[i], "--flush-target") == 0 && i+1 < argc) cfg->flush_target_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--store")        == 0 && i+1 < argc) cfg->store_enabled = strcmp(argv[++i], "ON") == 0;
+        else if (strcmp(argv[i], "--store-segment") == 0 && i+1 < argc) cfg->store_segment_kb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--coalesce")     == 0 && i+1 < argc) cfg->coalesce = strcmp(argv[++i], "ON") == 0;
+        else if (strcmp(argv[i], "--wal")          == 0 && i+1 < argc) cfg->wal_enabled = strcmp(argv[++i], "ON") == 0;
+        else if (strcmp(argv[i], "--wal-commit")   == 0 && i+1 < argc) cfg->wal_commit_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--snapshot")     == 0 && i+1 < argc) cfg->snapshot_ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--restore")      == 0 && i+1 < argc)
+            snprintf(cfg->restore_path, sizeof(cfg->restore_path), "%s", argv[++i]);
+        else if (strcmp(argv[i], "--capture")      == 0) cfg->trace_capture = 1;
+        else if (strcmp(argv[i], "--replay")       == 0 && i+1 < argc)
+            snprintf(cfg->replay_path, sizeof(cfg->replay_path), "%s", argv[++i]);
+        else if (strcmp(argv[i], "--trace-dump")   == 0 && i+1 < argc)
+            snprintf(cfg->trace_dump, sizeof(cfg->trace_dump), "%s", argv[++i]);
+        else if (strcmp(argv[i], "--output")       == 0 && i+1 < argc)
+            snprintf(cfg->output_dir, sizeof(cfg->output_dir), "%s", argv[++i]);
+        else if (strcmp(argv[i], "--headless")     == 0) cfg->headless = 1;
+        else if (strcmp(argv[i], "--runtime")      == 0 && i+1 < argc)
+            cfg->runtime = (strcmp(argv[++i], "REACTOR") == 0) ? RUNTIME_REACTOR : RUNTIME_THREADS;
+        else if (strcmp(argv[i], "--sweep")        == 0 && i+1 < argc)
+            snprintf(cfg->sweep, sizeof(cfg->sweep), "%s", argv[++i]);
+        else if (strcmp(argv[i], "--jobs")         == 0 && i+1 < argc) cfg->sweep_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed")         == 0 && i+1 < argc) cfg->seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--lookup")       == 0 && i+2 < argc) {
+            cfg->lookup_pid = atoi(argv[++i]);
+            cfg->lookup_qid = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--arrival")  == 0 && i+1 < argc) cfg->arrival_model = parse_arrival(argv[++i]);
+        else if (strcmp(argv[i], "--arrival-rate") == 0 && i+1 < argc) cfg->arrival_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--burst-tick")   == 0 && i+1 < argc) cfg->arrival_burst_tick = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--admit-rate")   == 0 && i+1 < argc) cfg->admit_rate  = atof(argv[++i]);
+        else if (strcmp(argv[i], "--admit-burst")  == 0 && i+1 < argc) cfg->admit_burst = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--int-queue")    == 0 && i+1 < argc) cfg->int_queue_capacity = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bh-workers")   == 0 && i+1 < argc) cfg->bh_workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--storm-mask")   == 0 && i+1 < argc) cfg->storm_mask_threshold = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bench")    == 0 && i+1 < argc)
+            snprintf(cfg->bench, sizeof(cfg->bench), "%s", argv[++i]);
         else if (strcmp(argv[i], "--demo")     == 0) cfg->demo_mode = 1;
     }
 }
 
+// Settings that parse but could never run: a token bucket shallower
+// than one token admits nobody, however long it refills
+int config_check(const Config *cfg) {
+    if (cfg->admit_rate > 0.0f && cfg->admit_burst < 1) {
+        fprintf(stderr, "  ADMIT_BURST must be at least 1 when ADMIT_RATE > 0 (got %d):"
+                        " no login would ever be admitted\n", cfg->admit_burst);
+        return -1;
+    }
+    return 0;
+}
+
 void config_print(Config *cfg) {
     printf("┌─── Configuration ───────────────────────┐\n");
     printf("│ Students     : %-26d │\n", cfg->num_students);
@@ -61,6 +207,72 @@ void config_print(Config *cfg) {
     printf("│ Exam Duration: %-26d │\n", cfg->exam_duration);
     printf("│ Scheduling   : %-26s │\n", cfg->sched_algo == PRIORITY ? "PRIORITY" : "ROUND_ROBIN");
     printf("│ Page Replace : %-26s │\n", cfg->page_algo  == LRU      ? "LRU"      : "FIFO");
+    const char *arrivals[] = { "CONSTANT", "POISSON", "BURST" };
+    char line[64];
+    snprintf(line, sizeof(line), "%s %.2f/tick",
+             arrivals[cfg->arrival_model], cfg->arrival_rate);
+    printf("│ Arrivals     : %-26s │\n", line);
+    if (cfg->admit_rate > 0.0f)
+        snprintf(line, sizeof(line), "%.2f/tick, burst %d",
+                 cfg->admit_rate, cfg->admit_burst);
+    else
+        snprintf(line, sizeof(line), "UNLIMITED");
+    printf("│ Admission    : %-26s │\n", line);
+    if (cfg->buffer_max_capacity > cfg->buffer_capacity)
+        snprintf(line, sizeof(line), "%d, grows to %d",
+                 cfg->buffer_capacity, cfg->buffer_max_capacity);
+    else
+        snprintf(line, sizeof(line), "%d", cfg->buffer_capacity);
+    if (cfg->io_shards > 1) {
+        size_t len = strlen(line);
+        snprintf(line + len, sizeof(line) - len, " x%d shards", cfg->io_shards);
+    }
+    printf("│ I/O Buffer   : %-26s │\n", line);
+    if (cfg->submit_policy == SUBMIT_DROP)
+        snprintf(line, sizeof(line), "DROP when full");
+    else if (cfg->submit_wait_ms > 0)
+        snprintf(line, sizeof(line), "BLOCK up to %d ms", cfg->submit_wait_ms);
+    else
+        snprintf(line, sizeof(line), "BLOCK, never drop");
+    printf("│ Submit Policy: %-26s │\n", line);
+    const char *durability[] = { "NONE", "FDATASYNC", "GROUP" };
+    if (cfg->durability == DURABILITY_GROUP)
+        snprintf(line, sizeof(line), "GROUP every %d ms", cfg->group_commit_ms);
+    else
+        snprintf(line, sizeof(line), "%s", durability[cfg->durability]);
+    printf("│ Durability   : %-26s │\n", line);
+    if (cfg->flush_policy == FLUSH_ADAPTIVE)
+        snprintf(line, sizeof(line), "ADAPTIVE, target %d ms", cfg->flush_target_ms);
+    else
+        snprintf(line, sizeof(line), "FIXED (80%% / 15 ticks)");
+    printf("│ Flush Policy : %-26s │\n", line);
+    if (cfg->store_enabled)
+        snprintf(line, sizeof(line), "ON, %d KB segments", cfg->store_segment_kb);
+    else
+        snprintf(line, sizeof(line), "OFF");
+    printf("│ Binary Store : %-26s │\n", line);
+    printf("│ Coalescing   : %-26s │\n", cfg->coalesce ? "ON (pid, question)" : "OFF");
+    if (cfg->wal_enabled)
+        snprintf(line, sizeof(line), "ON, group commit %d ms", cfg->wal_commit_ms);
+    else
+        snprintf(line, sizeof(line), "OFF");
+    printf("│ Write-Ahead  : %-26s │\n", line);
+    if (cfg->snapshot_ticks > 0)
+        snprintf(line, sizeof(line), "every %d ticks", cfg->snapshot_ticks);
+    else
+        snprintf(line, sizeof(line), "OFF");
+    printf("│ Snapshots    : %-26s │\n", line);
+    printf("│ Runtime      : %-26s │\n",
+           cfg->runtime == RUNTIME_REACTOR ? "REACTOR (epoll)" : "THREADS (lockstep)");
+    printf("│ Seed         : %-26llu │\n", (unsigned long long)cfg->seed);
+    if (cfg->replay_path[0])
+        snprintf(line, sizeof(line), "REPLAY %.40s%s", cfg->replay_path,
+                 cfg->trace_capture ? " + capture" : "");
+    else
+        snprintf(line, sizeof(line), "%s", cfg->trace_capture ? "CAPTURE" : "OFF");
+    printf("│ Trace        : %-26.26s │\n", line);
+    snprintf(line, sizeof(line), "%.40s%s", cfg->output_dir, cfg->headless ? ", headless" : "");
+    printf("│ Output       : %-26.26s │\n", line);
     printf("│ Demo Mode    : %-26s │\n", cfg->demo_mode  ? "ON" : "OFF");
     printf("└─────────────────────────────────────────┘\n");
 }
@@ -4,11 +4,18 @@
 #include <unistd.h>
 #include <time.h>
 #include "dashboard.h"
+#include "proc_table.h"
+#include "interrupt.h"
+#include "io_buffer.h"
 
 #define REFRESH_MS 500
 
-static int dash_running = 1;
-static long start_time  = 0;
+typedef struct Dashboard {
+    int     running;
+    long    start_time;
+    int     max_x;
+    WINDOW *w_header, *w_cpu, *w_mem, *w_io, *w_int, *w_procs, *w_logs;
+} Dashboard;
 
 // ─── Timestamp ────────────────────────────────────────────
 static long now_ms() {
@@ -17,7 +24,7 @@ static long now_ms() {
     return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
 }
 
-static void format_elapsed(char *buf, int size) {
+static void format_elapsed(long start_time, char *buf, int size) {
     long elapsed = (now_ms() - start_time) / 1000;
     int  h = elapsed / 3600;
     int  m = (elapsed % 3600) / 60;
@@ -50,16 +57,25 @@ static void draw_box(WINDOW *win, const char *title) {
     wattroff(win, A_BOLD | COLOR_PAIR(6));
 }
 
-void dashboard_init() {
-    start_time = now_ms();
+void dashboard_init(SimContext *ctx) {
+    Dashboard *d = calloc(1, sizeof(Dashboard));
+    ctx->dash     = d;
+    d->running    = 1;
+    d->start_time = now_ms();
 }
 
-void dashboard_shutdown() {
-    dash_running = 0;
+void dashboard_shutdown(SimContext *ctx) {
+    __atomic_store_n(&ctx->dash->running, 0, __ATOMIC_RELEASE);
 }
 
-void *dashboard_thread(void *arg) {
-    (void)arg;
+void dashboard_destroy(SimContext *ctx) {
+    free(ctx->dash);
+    ctx->dash = NULL;
+}
+
+// ─── Screen lifecycle ─────────────────────────────────────
+int dashboard_open(SimContext *ctx) {
+    Dashboard *d = ctx->dash;
 
     // ─── ncurses setup ────────────────────────────────────
     initscr();
@@ -71,7 +87,7 @@ void *dashboard_thread(void *arg) {
     if (!has_colors()) {
         endwin();
         fprintf(stderr, "Terminal does not support colors\n");
-        return NULL;
+        return -1;
     }
 
     start_color();
@@ -91,211 +107,335 @@ void *dashboard_thread(void *arg) {
 
     // ─── Create windows ───────────────────────────────────
     // Header
-    WINDOW *w_header  = newwin(3,  max_x,          0, 0);
+    d->w_header   = newwin(3,  max_x,          0, 0);
     // CPU panel
-    WINDOW *w_cpu     = newwin(7,  max_x / 2,      3, 0);
+    d->w_cpu      = newwin(8,  max_x / 2,      3, 0);
     // Memory panel
-    WINDOW *w_mem     = newwin(7,  max_x / 2,      3, max_x / 2);
+    d->w_mem      = newwin(8,  max_x / 2,      3, max_x / 2);
     // IO + Interrupt panel
-    WINDOW *w_io      = newwin(7,  max_x / 2,     10, 0);
-    WINDOW *w_int     = newwin(7,  max_x / 2,     10, max_x / 2);
+    d->w_io       = newwin(10, max_x / 2,     11, 0);
+    d->w_int      = newwin(10, max_x / 2,     11, max_x / 2);
     // Process list
-    WINDOW *w_procs   = newwin(8,  max_x,          17, 0);
+    d->w_procs    = newwin(8,  max_x,          21, 0);
     // Log feed
-    WINDOW *w_logs    = newwin(6,  max_x,          25, 0);
+    d->w_logs     = newwin(6,  max_x,          29, 0);
+
+    d->max_x = max_x;
+    return 0;
+}
+
+void dashboard_close(SimContext *ctx) {
+    Dashboard *d = ctx->dash;
+    delwin(d->w_header);
+    delwin(d->w_cpu);
+    delwin(d->w_mem);
+    delwin(d->w_io);
+    delwin(d->w_int);
+    delwin(d->w_procs);
+    delwin(d->w_logs);
+    endwin();
+}
 
-    while (dash_running) {
-        // Check for 'q' to quit
-        int ch = getch();
+// ─── Keyboard: 'q' ends the run ───────────────────────────
+int dashboard_input(SimContext *ctx) {
+    int ch;
+    while ((ch = getch()) != ERR) {
         if (ch == 'q' || ch == 'Q') {
-            pthread_mutex_lock(&g_state.lock);
-            g_state.simulation_running = 0;
-            pthread_mutex_unlock(&g_state.lock);
-            break;
+            pthread_mutex_lock(&ctx->state.lock);
+            ctx->state.simulation_running = 0;
+            pthread_mutex_unlock(&ctx->state.lock);
+            return 1;
         }
+    }
+    return 0;
+}
 
-        // Snapshot state (minimize lock time)
-        pthread_mutex_lock(&g_state.lock);
-        int   running_pid    = g_state.running_pid;
-        float cpu_util       = g_state.cpu_utilization;
-        int   ctx_switches   = g_state.context_switches;
-        int   completed      = g_state.completed_processes;
-        int   page_faults    = g_state.page_faults;
-        int   page_hits      = g_state.page_hits;
-        int   frames_used    = g_state.frames_used;
-        int   buf_count      = g_state.buffer_count;
-        int   total_subs     = g_state.total_submissions;
-        int   dropped_subs   = g_state.dropped_submissions;
-        int   flush_count    = g_state.flush_count;
-        int   timeouts       = g_state.timeouts_fired;
-        int   overloads      = g_state.overload_signals;
-        int   proc_count     = g_state.process_count;
-        int   tick           = g_state.current_tick;
-        char  logs[3][256];
-        for (int i = 0; i < 3; i++)
-            strncpy(logs[i], g_state.recent_logs[i], 255);
-        PCB   procs[MAX_STUDENTS];
-        int   snap_count = proc_count < MAX_STUDENTS ? proc_count : MAX_STUDENTS;
-        memcpy(procs, g_state.processes, sizeof(PCB) * snap_count);
-        pthread_mutex_unlock(&g_state.lock);
-
-        char elapsed[16];
-        format_elapsed(elapsed, sizeof(elapsed));
-
-        int  total_pages = page_faults + page_hits;
-        float hit_rate   = total_pages > 0
-                           ? (float)page_hits / total_pages * 100.0f : 0.0f;
-        float mem_pct    = (float)frames_used / g_config.memory_frames * 100.0f;
-        float buf_pct    = (float)buf_count   / BUFFER_CAPACITY        * 100.0f;
-
-        // ── HEADER ─────────────────────────────────────────
-        werase(w_header);
-        wattron(w_header, A_BOLD | COLOR_PAIR(7));
-        mvwprintw(w_header, 1, 2,
-                  "  EXAM OS SIMULATION  |  Tick: %-4d  |  Time: %s  |  "
-                  "Press 'q' to quit  |  Mode: %s",
-                  tick, elapsed,
-                  g_config.sched_algo == PRIORITY ? "PRIORITY" : "ROUND_ROBIN");
-        wattroff(w_header, A_BOLD | COLOR_PAIR(7));
-        box(w_header, 0, 0);
-        wrefresh(w_header);
-
-        // ── CPU PANEL ──────────────────────────────────────
-        werase(w_cpu);
-        draw_box(w_cpu, " CPU SCHEDULER ");
-        int bar_w = max_x / 2 - 18;
-
-        mvwprintw(w_cpu, 2, 2, "Utilization:");
-        draw_bar(w_cpu, 2, 15, bar_w, cpu_util, 1);
-        mvwprintw(w_cpu, 2, 15 + bar_w + 1, "%5.1f%%", cpu_util);
-
-        mvwprintw(w_cpu, 3, 2, "Running PID : ");
-        wattron(w_cpu, COLOR_PAIR(1) | A_BOLD);
-        wprintw(w_cpu, "%d", running_pid > 0 ? running_pid : 0);
-        wattroff(w_cpu, COLOR_PAIR(1) | A_BOLD);
-
-        mvwprintw(w_cpu, 4, 2, "Ctx Switches: %d", ctx_switches);
-        mvwprintw(w_cpu, 5, 2, "Completed   : %d / %d",
-                  completed, g_config.num_students);
-        wrefresh(w_cpu);
-
-        // ── MEMORY PANEL ───────────────────────────────────
-        werase(w_mem);
-        draw_box(w_mem, " MEMORY PAGING ");
-
-        mvwprintw(w_mem, 2, 2, "Usage  :");
-        draw_bar(w_mem, 2, 11, bar_w, mem_pct,
-                 mem_pct > 85.0f ? 4 : 2);
-        mvwprintw(w_mem, 2, 11 + bar_w + 1, "%5.1f%%", mem_pct);
-
-        mvwprintw(w_mem, 3, 2, "Frames : %d / %d",
-                  frames_used, g_config.memory_frames);
-        mvwprintw(w_mem, 4, 2, "Faults : ");
-        wattron(w_mem, COLOR_PAIR(4));
-        wprintw(w_mem, "%d", page_faults);
-        wattroff(w_mem, COLOR_PAIR(4));
-
-        mvwprintw(w_mem, 5, 2, "Hit Rate: ");
-        wattron(w_mem, COLOR_PAIR(1));
-        wprintw(w_mem, "%.1f%%  [%s]", hit_rate,
-                g_config.page_algo == LRU ? "LRU" : "FIFO");
-        wattroff(w_mem, COLOR_PAIR(1));
-        wrefresh(w_mem);
-
-        // ── I/O PANEL ──────────────────────────────────────
-        werase(w_io);
-        draw_box(w_io, " I/O BUFFER ");
-
-        mvwprintw(w_io, 2, 2, "Buffer :");
-        draw_bar(w_io, 2, 11, bar_w, buf_pct,
-                 buf_pct > 80.0f ? 4 : 3);
-        mvwprintw(w_io, 2, 11 + bar_w + 1, "%5.1f%%", buf_pct);
-
-        mvwprintw(w_io, 3, 2, "Queued  : %d / %d",
-                  buf_count, BUFFER_CAPACITY);
-        mvwprintw(w_io, 4, 2, "Total   : %d submitted", total_subs);
-        mvwprintw(w_io, 5, 2, "Dropped : ");
-        wattron(w_io, dropped_subs > 0 ? COLOR_PAIR(4) : COLOR_PAIR(1));
-        wprintw(w_io, "%d  |  Flushes: %d",
-                dropped_subs, flush_count);
-        wattroff(w_io, COLOR_PAIR(4));
-        wrefresh(w_io);
-
-        // ── INTERRUPT PANEL ────────────────────────────────
-        werase(w_int);
-        draw_box(w_int, " INTERRUPTS ");
-        mvwprintw(w_int, 2, 2, "Timeouts fired : ");
-        wattron(w_int, COLOR_PAIR(4) | A_BOLD);
-        wprintw(w_int, "%d", timeouts);
-        wattroff(w_int, COLOR_PAIR(4) | A_BOLD);
-
-        mvwprintw(w_int, 3, 2, "Overload signals: ");
-        wattron(w_int, COLOR_PAIR(5));
-        wprintw(w_int, "%d", overloads);
-        wattroff(w_int, COLOR_PAIR(5));
-
-        mvwprintw(w_int, 4, 2, "IVT entries    : 4");
-        mvwprintw(w_int, 5, 2, "INT_0 TIMEOUT  INT_1 OVERLOAD");
-        wrefresh(w_int);
-
-        // ── PROCESS LIST ───────────────────────────────────
-        werase(w_procs);
-        draw_box(w_procs, " ACTIVE PROCESSES ");
-        mvwprintw(w_procs, 1, 2,
-                  "%-6s %-10s %-8s %-8s",
-                  "PID", "STATE", "REMAIN", "PRIORITY");
-
-        const char *state_names[] = {
-            "NEW", "READY", "RUNNING", "WAITING", "TERMINATED"
-        };
-        int shown = 0;
-        for (int i = 0; i < snap_count && shown < 5; i++) {
-            PCB *p = &procs[i];
-            if (p->state == TERMINATED) continue;
-
-            int pair = (p->pid == running_pid) ? 1 : 6;
-            wattron(w_procs, COLOR_PAIR(pair));
-            mvwprintw(w_procs, 2 + shown, 2,
-                      "%-6d %-10s %-8d %-8d",
-                      p->pid,
-                      state_names[p->state],
-                      p->remaining_time,
-                      p->priority);
-            wattroff(w_procs, COLOR_PAIR(pair));
-            shown++;
-        }
-        if (proc_count > 5)
-            mvwprintw(w_procs, 7, 2,
-                      "... and %d more processes", proc_count - 5);
-        wrefresh(w_procs);
-
-        // ── LOG FEED ───────────────────────────────────────
-        werase(w_logs);
-        draw_box(w_logs, " RECENT EVENTS ");
-        for (int i = 0; i < 3; i++) {
-            int idx = (g_state.log_index - 3 + i + MAX_LOG_QUEUE) % 3;
-            int pair = (strstr(logs[idx], "ERROR") || strstr(logs[idx], "TIMEOUT"))
-                       ? 4
-                       : (strstr(logs[idx], "WARN") ? 3 : 6);
-            wattron(w_logs, COLOR_PAIR(pair));
-            mvwprintw(w_logs, i + 1, 2, "%-*.*s",
-                      max_x - 4, max_x - 4, logs[idx]);
-            wattroff(w_logs, COLOR_PAIR(pair));
+// ─── One refresh of every panel ───────────────────────────
+void dashboard_draw(SimContext *ctx) {
+    Dashboard    *d     = ctx->dash;
+    SystemState  *state = &ctx->state;
+    const Config *cfg   = &ctx->config;
+    int     max_x    = d->max_x;
+    WINDOW *w_header = d->w_header, *w_cpu = d->w_cpu, *w_mem = d->w_mem,
+           *w_io     = d->w_io,     *w_int = d->w_int, *w_procs = d->w_procs,
+           *w_logs   = d->w_logs;
+
+    // Snapshot state (minimize lock time)
+    pthread_mutex_lock(&state->lock);
+    int   running_pid    = state->running_pid;
+    float cpu_util       = state->cpu_utilization;
+    int   ctx_switches   = state->context_switches;
+    int   completed      = state->completed_processes;
+    int   page_faults    = state->page_faults;
+    int   page_hits      = state->page_hits;
+    int   frames_used    = state->frames_used;
+    int   buf_count      = state->buffer_count;
+    int   buf_cap        = state->buffer_capacity > 0 ? state->buffer_capacity : 1;
+    int   buf_grows      = state->buffer_grows;
+    int   total_subs     = state->total_submissions;
+    int   dropped_subs   = state->dropped_submissions;
+    int   flush_count    = state->flush_count;
+    int   delayed_subs   = state->delayed_submissions;
+    int   flush_thr      = state->flush_threshold_pct;
+    float submit_rate    = state->submit_rate;
+    int   hist_len       = state->flush_history_len;
+    int   flush_hist[FLUSH_HISTORY];
+    memcpy(flush_hist, state->flush_history, sizeof(flush_hist));
+    int   shard_fill[MAX_IO_SHARDS];
+    memcpy(shard_fill, state->shard_fill, sizeof(shard_fill));
+    int   timeouts       = state->timeouts_fired;
+    int   overloads      = state->overload_signals;
+    int   int_depth      = state->int_queue_depth;
+    int   int_cap        = state->int_queue_capacity;
+    int   int_coalesced  = state->int_coalesced;
+    int   int_overflows  = state->int_overflows;
+    int   int_to_over    = state->int_timeout_overflows;
+    int   int_masked     = state->int_masked_levels;
+    int   int_levels[INT_LEVELS];
+    memcpy(int_levels, state->int_level_depth, sizeof(int_levels));
+    int   proc_count     = state->procs.count;
+    int   logins_admit   = state->logins_admitted;
+    int   login_queue    = state->login_queue_len;
+    int   login_wait_max = state->login_wait_max;
+    int   tick           = state->current_tick;
+    char  logs[3][256];
+    for (int i = 0; i < 3; i++)
+        strncpy(logs[i], state->recent_logs[i], 255);
+    // Only the rows we draw are copied; the rest is a state sweep
+    PCB   procs[5];
+    int   snap_count = proc_table_collect_active(&state->procs, procs, 5);
+    int   active     = proc_count
+                       - proc_table_count_state(&state->procs, TERMINATED);
+    pthread_mutex_unlock(&state->lock);
+
+    char elapsed[16];
+    format_elapsed(d->start_time, elapsed, sizeof(elapsed));
+
+    int  total_pages = page_faults + page_hits;
+    float hit_rate   = total_pages > 0
+                       ? (float)page_hits / total_pages * 100.0f : 0.0f;
+    float mem_pct    = (float)frames_used / cfg->memory_frames * 100.0f;
+    float buf_pct    = (float)buf_count   / buf_cap                * 100.0f;
+
+    // ── HEADER ─────────────────────────────────────────
+    werase(w_header);
+    wattron(w_header, A_BOLD | COLOR_PAIR(7));
+    mvwprintw(w_header, 1, 2,
+              "  EXAM OS SIMULATION  |  Tick: %-4d  |  Time: %s  |  "
+              "Press 'q' to quit  |  Mode: %s",
+              tick, elapsed,
+              cfg->sched_algo == PRIORITY ? "PRIORITY" : "ROUND_ROBIN");
+    wattroff(w_header, A_BOLD | COLOR_PAIR(7));
+    box(w_header, 0, 0);
+    wrefresh(w_header);
+
+    // ── CPU PANEL ──────────────────────────────────────
+    werase(w_cpu);
+    draw_box(w_cpu, " CPU SCHEDULER ");
+    int bar_w = max_x / 2 - 18;
+
+    mvwprintw(w_cpu, 2, 2, "Utilization:");
+    draw_bar(w_cpu, 2, 15, bar_w, cpu_util, 1);
+    mvwprintw(w_cpu, 2, 15 + bar_w + 1, "%5.1f%%", cpu_util);
+
+    mvwprintw(w_cpu, 3, 2, "Running PID : ");
+    wattron(w_cpu, COLOR_PAIR(1) | A_BOLD);
+    wprintw(w_cpu, "%d", running_pid > 0 ? running_pid : 0);
+    wattroff(w_cpu, COLOR_PAIR(1) | A_BOLD);
+
+    mvwprintw(w_cpu, 4, 2, "Ctx Switches: %d", ctx_switches);
+    mvwprintw(w_cpu, 5, 2, "Completed   : %d / %d",
+              completed, cfg->num_students);
+    mvwprintw(w_cpu, 6, 2, "Logins      : %d in  ", logins_admit);
+    wattron(w_cpu, login_queue > 0 ? COLOR_PAIR(3) : COLOR_PAIR(1));
+    wprintw(w_cpu, "%d queued", login_queue);
+    wattroff(w_cpu, login_queue > 0 ? COLOR_PAIR(3) : COLOR_PAIR(1));
+    wprintw(w_cpu, "  (max wait %d)", login_wait_max);
+    wrefresh(w_cpu);
+
+    // ── MEMORY PANEL ───────────────────────────────────
+    werase(w_mem);
+    draw_box(w_mem, " MEMORY PAGING ");
+
+    mvwprintw(w_mem, 2, 2, "Usage  :");
+    draw_bar(w_mem, 2, 11, bar_w, mem_pct,
+             mem_pct > 85.0f ? 4 : 2);
+    mvwprintw(w_mem, 2, 11 + bar_w + 1, "%5.1f%%", mem_pct);
+
+    mvwprintw(w_mem, 3, 2, "Frames : %d / %d",
+              frames_used, cfg->memory_frames);
+    mvwprintw(w_mem, 4, 2, "Faults : ");
+    wattron(w_mem, COLOR_PAIR(4));
+    wprintw(w_mem, "%d", page_faults);
+    wattroff(w_mem, COLOR_PAIR(4));
+
+    mvwprintw(w_mem, 5, 2, "Hit Rate: ");
+    wattron(w_mem, COLOR_PAIR(1));
+    wprintw(w_mem, "%.1f%%  [%s]", hit_rate,
+            cfg->page_algo == LRU ? "LRU" : "FIFO");
+    wattroff(w_mem, COLOR_PAIR(1));
+    wrefresh(w_mem);
+
+    // ── I/O PANEL ──────────────────────────────────────
+    werase(w_io);
+    draw_box(w_io, " I/O BUFFER ");
+
+    // ADAPTIVE: the flush threshold over the last ticks, oldest left
+    if (cfg->flush_policy == FLUSH_ADAPTIVE) {
+        static const char levels[] = " .:-=+*#";
+        int width = getmaxx(w_io) - 28;
+        if (width > FLUSH_HISTORY) width = FLUSH_HISTORY;
+        if (width > hist_len)      width = hist_len;
+        mvwprintw(w_io, 1, 2, "Flush@ %2d%% ", flush_thr);
+        wattron(w_io, COLOR_PAIR(5));
+        for (int i = hist_len - width; i < hist_len; i++) {
+            int lvl = flush_hist[i % FLUSH_HISTORY] * 7 / 80;
+            waddch(w_io, levels[lvl > 7 ? 7 : lvl]);
         }
-        wrefresh(w_logs);
+        wattroff(w_io, COLOR_PAIR(5));
+        wprintw(w_io, " %4.1f/tick", submit_rate);
+    }
 
-        usleep(REFRESH_MS * 1000);
+    mvwprintw(w_io, 2, 2, "Buffer :");
+    draw_bar(w_io, 2, 11, bar_w, buf_pct,
+             buf_pct > 80.0f ? 4 : 3);
+    mvwprintw(w_io, 2, 11 + bar_w + 1, "%5.1f%%", buf_pct);
+
+    // Sharded: one fill per shard, hot shards in red
+    int shards = io_buffer_shards(ctx);
+    if (shards > 1) {
+        mvwprintw(w_io, 3, 2, "Shards  :");
+        for (int i = 0; i < shards; i++) {
+            wattron(w_io, shard_fill[i] > 80 ? COLOR_PAIR(4) : COLOR_PAIR(1));
+            wprintw(w_io, " %2d%%", shard_fill[i]);
+            wattroff(w_io, shard_fill[i] > 80 ? COLOR_PAIR(4) : COLOR_PAIR(1));
+        }
+    } else {
+        mvwprintw(w_io, 3, 2, "Queued  : %d / %d", buf_count, buf_cap);
+    }
+    if (buf_grows > 0)
+        wprintw(w_io, "  (grown x%d)", buf_grows);
+    mvwprintw(w_io, 4, 2, "Total   : %d submitted", total_subs);
+    mvwprintw(w_io, 5, 2, "Dropped : ");
+    wattron(w_io, dropped_subs > 0 ? COLOR_PAIR(4) : COLOR_PAIR(1));
+    wprintw(w_io, "%d  |  Flushes: %d",
+            dropped_subs, flush_count);
+    wattroff(w_io, COLOR_PAIR(4));
+    if (cfg->submit_policy == SUBMIT_BLOCK) {
+        float credit = io_buffer_credit(ctx);
+        mvwprintw(w_io, 6, 2, "Delayed : %d  |  Credit: ", delayed_subs);
+        wattron(w_io, credit < 0.5f ? COLOR_PAIR(4) : COLOR_PAIR(1));
+        wprintw(w_io, "%3.0f%%", credit * 100.0f);
+        wattroff(w_io, credit < 0.5f ? COLOR_PAIR(4) : COLOR_PAIR(1));
+    }
+    // Durability SLO: submit → durable, then where the p99 goes
+    IOPhaseStats ph[IO_PHASES];
+    io_buffer_phase_stats(ctx, ph);
+    mvwprintw(w_io, 7, 2, "Durable : p50 %.1f  p99 ",
+              ph[PHASE_TOTAL].p50_us / 1000.0);
+    wattron(w_io, ph[PHASE_TOTAL].p99_us > cfg->flush_target_ms * 1000L
+                  ? COLOR_PAIR(4) : COLOR_PAIR(1));
+    wprintw(w_io, "%.1f", ph[PHASE_TOTAL].p99_us / 1000.0);
+    wattroff(w_io, COLOR_PAIR(4));
+    wprintw(w_io, "  max %.1f ms", ph[PHASE_TOTAL].max_us / 1000.0);
+    mvwprintw(w_io, 8, 2, "p99 ms  : q %.1f  fmt %.2f  wr %.2f",
+              ph[PHASE_QUEUE].p99_us / 1000.0, ph[PHASE_FORMAT].p99_us / 1000.0,
+              ph[PHASE_WRITE].p99_us / 1000.0);
+    if (cfg->durability != DURABILITY_NONE)
+        wprintw(w_io, "  sync %.2f", ph[PHASE_SYNC].p99_us / 1000.0);
+    wrefresh(w_io);
+
+    // ── INTERRUPT PANEL ────────────────────────────────
+    werase(w_int);
+    draw_box(w_int, " INTERRUPTS ");
+    mvwprintw(w_int, 2, 2, "Timeouts fired : ");
+    wattron(w_int, COLOR_PAIR(4) | A_BOLD);
+    wprintw(w_int, "%d", timeouts);
+    wattroff(w_int, COLOR_PAIR(4) | A_BOLD);
+    wprintw(w_int, "   Overloads: ");
+    wattron(w_int, COLOR_PAIR(5));
+    wprintw(w_int, "%d", overloads);
+    wattroff(w_int, COLOR_PAIR(5));
+
+    mvwprintw(w_int, 3, 2, "Queue : %d / %d  coalesced %d",
+              int_depth, int_cap, int_coalesced);
+
+    // Pending per level, most urgent first; masked levels in red
+    const char *level_tags[INT_LEVELS] = { "INFO", "NORM", "HIGH", "CRIT" };
+    mvwprintw(w_int, 4, 2, "Pending:");
+    for (int level = INT_LEVELS - 1; level >= 0; level--) {
+        int masked = int_masked & (1 << level);
+        if (masked) wattron(w_int, COLOR_PAIR(4));
+        wprintw(w_int, " %s %d%s", level_tags[level], int_levels[level],
+                masked ? "(M)" : "");
+        if (masked) wattroff(w_int, COLOR_PAIR(4));
+    }
+    mvwprintw(w_int, 5, 2, "Overflows : ");
+    wattron(w_int, int_overflows > 0 ? COLOR_PAIR(4) : COLOR_PAIR(1));
+    wprintw(w_int, "%d", int_overflows);
+    wattroff(w_int, int_overflows > 0 ? COLOR_PAIR(4) : COLOR_PAIR(1));
+    wprintw(w_int, "  (timeouts re-armed: %d)", int_to_over);
+    mvwprintw(w_int, 6, 2, "p99 latency: dispatch %ldus  bottom-half %ldus",
+              hist_percentile(interrupt_dispatch_hist(ctx, INT_EXAM_TIMEOUT), 99.0),
+              hist_percentile(interrupt_bh_hist(ctx, INT_EXAM_TIMEOUT), 99.0));
+    wrefresh(w_int);
+
+    // ── PROCESS LIST ───────────────────────────────────
+    werase(w_procs);
+    draw_box(w_procs, " ACTIVE PROCESSES ");
+    mvwprintw(w_procs, 1, 2,
+              "%-6s %-10s %-8s %-8s",
+              "PID", "STATE", "REMAIN", "PRIORITY");
+
+    const char *state_names[] = {
+        "NEW", "READY", "RUNNING", "WAITING", "TERMINATED"
+    };
+    int shown = 0;
+    for (int i = 0; i < snap_count; i++) {
+        PCB *p = &procs[i];
+
+        int pair = (p->pid == running_pid) ? 1 : 6;
+        wattron(w_procs, COLOR_PAIR(pair));
+        mvwprintw(w_procs, 2 + shown, 2,
+                  "%-6d %-10s %-8d %-8d",
+                  p->pid,
+                  state_names[p->state],
+                  p->deadline_tick > tick ? p->deadline_tick - tick : 0,
+                  p->priority);
+        wattroff(w_procs, COLOR_PAIR(pair));
+        shown++;
+    }
+    if (active > 5)
+        mvwprintw(w_procs, 7, 2,
+                  "... and %d more active processes", active - 5);
+    wrefresh(w_procs);
+
+    // ── LOG FEED ───────────────────────────────────────
+    werase(w_logs);
+    draw_box(w_logs, " RECENT EVENTS ");
+    for (int i = 0; i < 3; i++) {
+        int idx = (state->log_index - 3 + i + MAX_LOG_QUEUE) % 3;
+        int pair = (strstr(logs[idx], "ERROR") || strstr(logs[idx], "TIMEOUT"))
+                   ? 4
+                   : (strstr(logs[idx], "WARN") ? 3 : 6);
+        wattron(w_logs, COLOR_PAIR(pair));
+        mvwprintw(w_logs, i + 1, 2, "%-*.*s",
+                  max_x - 4, max_x - 4, logs[idx]);
+        wattroff(w_logs, COLOR_PAIR(pair));
     }
+    wrefresh(w_logs);
+}
 
-    // Clean up ncurses
-    delwin(w_header);
-    delwin(w_cpu);
-    delwin(w_mem);
-    delwin(w_io);
-    delwin(w_int);
-    delwin(w_procs);
-    delwin(w_logs);
-    endwin();
+void *dashboard_thread(void *arg) {
+    SimContext *ctx = arg;
+    Dashboard  *d   = ctx->dash;
 
+    if (dashboard_open(ctx) != 0) return NULL;
+    while (__atomic_load_n(&d->running, __ATOMIC_ACQUIRE)) {
+        if (dashboard_input(ctx)) break;
+        dashboard_draw(ctx);
+        usleep(REFRESH_MS * 1000);
+    }
+    dashboard_close(ctx);
     return NULL;
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <string.h>
+#include "histogram.h"
+
+// ─── Bucket mapping ──────────────────────────────────────
+static int bucket_of(long v) {
+    if (v < 0)  v = 0;
+    if (v < 16) return (int)v;
+    int msb   = 63 - __builtin_clzl((unsigned long)v);
+    int shift = msb - 3;
+    int sub   = (int)((v >> shift) & 7);
+    return 16 + (msb - 4) * 8 + sub;
+}
+
+// Largest value that maps into bucket b
+static long bucket_upper(int b) {
+    if (b < 16) return b;
+    int msb   = (b - 16) / 8 + 4;
+    int sub   = (b - 16) % 8;
+    int shift = msb - 3;
+    return ((long)(9 + sub) << shift) - 1;
+}
+
+void hist_reset(Histogram *h) {
+    memset(h, 0, sizeof(Histogram));
+}
+
+void hist_record(Histogram *h, long value) {
+    hist_record_n(h, value, 1);
+}
+
+void hist_record_n(Histogram *h, long value, long n) {
+    if (n <= 0) return;
+    if (value < 0) value = 0;
+    __atomic_fetch_add(&h->counts[bucket_of(value)], n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->count, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sum, value * n, __ATOMIC_RELAXED);
+
+    long cur = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (value > cur &&
+           !__atomic_compare_exchange_n(&h->max, &cur, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+// ─── Percentile (pct in 0..100), reported as bucket upper bound
+long hist_percentile(const Histogram *h, double pct) {
+    long total = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+    if (total == 0) return 0;
+
+    long rank = (long)(total * pct / 100.0 + 0.5);
+    if (rank < 1)     rank = 1;
+    if (rank > total) rank = total;
+
+    long seen = 0;
+    long max  = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += __atomic_load_n(&h->counts[b], __ATOMIC_RELAXED);
+        if (seen >= rank) {
+            long upper = bucket_upper(b);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+long hist_mean(const Histogram *h) {
+    long total = __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+    if (total == 0) return 0;
+    return __atomic_load_n(&h->sum, __ATOMIC_RELAXED) / total;
+}
@@ -5,229 +5,694 @@
 #include <signal.h>
 #include <time.h>
 #include "interrupt.h"
+#include "tick_clock.h"
 #include "logger.h"
 #include "scheduler.h"
 #include "memory.h"
 #include "io_buffer.h"
-
-// ─── Interrupt Vector Table ───────────────────────────────
-static IVTEntry ivt[MAX_INTERRUPTS];
-static int      ivt_size = 0;
-static pthread_mutex_t ivt_lock = PTHREAD_MUTEX_INITIALIZER;
-
-// ─── Interrupt queue (raised but not yet handled) ─────────
+#include "timer_wheel.h"
+#include "workqueue.h"
+#include "histogram.h"
+
+// ─── Interrupt queues (raised but not yet handled) ────────
+// One bounded lock-free MPMC ring (Vyukov) per priority level: every
+// cell carries a sequence number telling producers/consumers whose
+// turn it is, so raising an interrupt is a single CAS and never blocks.
 typedef struct {
     int interrupt_id;
     int pid;
-    long timestamp;
+    long raised_us;
 } PendingInterrupt;
 
-static PendingInterrupt int_queue[64];
-static int int_q_head = 0, int_q_tail = 0, int_q_count = 0;
-static pthread_mutex_t int_q_lock = PTHREAD_MUTEX_INITIALIZER;
-static sem_t           int_ready;
+typedef struct {
+    long             seq;
+    PendingInterrupt data;
+} IntCell;
+
+typedef struct {
+    IntCell *cells;
+    long     mask;
+    long     enq_pos __attribute__((aligned(64)));
+    long     deq_pos __attribute__((aligned(64)));
+} IntRing;
+
+// ─── Expired exams awaiting the bulk bottom half ─────────
+// Timeout top halves only append here. After each dispatch pass the
+// interrupt thread defers one bottom half that takes everything
+// collected so far, so an end-of-exam storm becomes a single batch.
+typedef struct {
+    int  pid;
+    long raised_us;
+} ExpiredExam;
+
+typedef struct Interrupts {
+    // Interrupt Vector Table, direct-indexed by interrupt ID. Written
+    // only by interrupt_init(), so dispatch reads it without ivt_lock.
+    IVTEntry        ivt[MAX_INTERRUPTS];
+    int             ivt_size;
+    pthread_mutex_t ivt_lock;
+
+    IntRing         rings[INT_LEVELS];
+    unsigned        level_mask;       // bit L set = level L masked
+    int             storm_masked;     // mask applied by the storm guard
+
+    // One pending bit per (interrupt, pid): re-raising something already
+    // queued is coalesced instead of taking another slot. pid -1 → col 0.
+    unsigned char   int_pending[MAX_INTERRUPTS][MAX_STUDENTS + 2];
+
+    // Per-vector accounting
+    long            int_raised[MAX_INTERRUPTS];
+    long            int_handled[MAX_INTERRUPTS];
+    long            int_coalesced[MAX_INTERRUPTS];
+    long            int_overflows[MAX_INTERRUPTS];
+    long            int_preemptions;  // dispatched ahead of lower pending work
+
+    // Latency: raise → top half, raise → bottom half done
+    Histogram       dispatch_hist[MAX_INTERRUPTS];
+    Histogram       bh_hist[MAX_INTERRUPTS];
+    Histogram       batch_hist;           // whole timeout batch, start → done
+    long            current_raised_us;    // set by dispatch() for handlers
+
+    // Back-pressure window opened by INT_OVERLOAD (0 = inactive)
+    long            overload_until_us;
+
+    ExpiredExam     expired_batch[MAX_STUDENTS + 1];
+    int             expired_count;
+    int             batch_scheduled;
+    pthread_mutex_t batch_lock;
+} Interrupts;
 
 // ─── Timestamp ────────────────────────────────────────────
-static long now_ms() {
+static long now_us() {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+static int int_q_push(IntRing *r, const PendingInterrupt *pi) {
+    IntCell *cell;
+    long pos = __atomic_load_n(&r->enq_pos, __ATOMIC_RELAXED);
+
+    while (1) {
+        cell = &r->cells[pos & r->mask];
+        long seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        long dif = seq - pos;
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&r->enq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (dif < 0) {
+            return -1;  // full
+        } else {
+            pos = __atomic_load_n(&r->enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->data = *pi;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int int_q_pop(IntRing *r, PendingInterrupt *out) {
+    IntCell *cell;
+    long pos = __atomic_load_n(&r->deq_pos, __ATOMIC_RELAXED);
+
+    while (1) {
+        cell = &r->cells[pos & r->mask];
+        long seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        long dif = seq - (pos + 1);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&r->deq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (dif < 0) {
+            return -1;  // empty
+        } else {
+            pos = __atomic_load_n(&r->deq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    *out = cell->data;
+    __atomic_store_n(&cell->seq, pos + r->mask + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static long int_q_depth(IntRing *r) {
+    return __atomic_load_n(&r->enq_pos, __ATOMIC_RELAXED)
+         - __atomic_load_n(&r->deq_pos, __ATOMIC_RELAXED);
+}
+
+static unsigned char *pending_bit(Interrupts *in, int interrupt_id, int pid) {
+    if (interrupt_id < 0 || interrupt_id >= MAX_INTERRUPTS) return NULL;
+    if (pid < -1 || pid > MAX_STUDENTS) return NULL;
+    return &in->int_pending[interrupt_id][pid + 1];
 }
 
 // ════════════════════════════════════════════════════════
 //  INTERRUPT HANDLERS
 // ════════════════════════════════════════════════════════
 
-// Handler 0: Exam timeout — save partial, terminate process
-static void handle_exam_timeout(int pid, SystemState *state) {
-    char msg[128];
-    snprintf(msg, sizeof(msg), "TIMEOUT: PID %d exam expired — saving partial submission", pid);
-    log_event("WARN", "INTERRUPT", msg);
-
-    // Save whatever the student had to I/O buffer as partial
-    char answer[64];
-    snprintf(answer, sizeof(answer), "PARTIAL_PID%d", pid);
-    io_buffer_submit(pid, 0, answer, 1);
+// Handlers are top halves: O(1) bookkeeping only. Anything that calls
+// into I/O, memory or the scheduler is deferred to the work queue.
+
+// Bottom half 0: save partials, free memory, terminate — in bulk
+static void timeout_batch_bottom_half(SimContext *ctx, int unused_pid, long unused_raised) {
+    (void)unused_pid;
+    (void)unused_raised;
+    Interrupts *in = ctx->intr;
+
+    ExpiredExam batch[MAX_STUDENTS + 1];
+    pthread_mutex_lock(&in->batch_lock);
+    int queued = in->expired_count;
+    memcpy(batch, in->expired_batch, sizeof(ExpiredExam) * queued);
+    in->expired_count   = 0;
+    in->batch_scheduled = 0;
+    pthread_mutex_unlock(&in->batch_lock);
+    if (queued == 0) return;
+
+    // An exam can complete after its timer fired and before this runs:
+    // completion cancels the timer, but the pid is already queued here.
+    // It has its real answers, so it gets no partial
+    unsigned char live[MAX_STUDENTS + 1] = {0};
+    pthread_mutex_lock(&ctx->state.lock);
+    const ProcTable *t = &ctx->state.procs;
+    for (int i = 0; i < t->count; i++)
+        if (t->pid[i] >= 0 && t->pid[i] <= MAX_STUDENTS && t->state[i] != TERMINATED)
+            live[t->pid[i]] = 1;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    int n = 0;
+    for (int i = 0; i < queued; i++)
+        if (batch[i].pid >= 0 && batch[i].pid <= MAX_STUDENTS && live[batch[i].pid])
+            batch[n++] = batch[i];
+    if (n == 0) return;
+
+    long start = now_us();
+
+    int        pids[MAX_STUDENTS + 1];
+    int        mem_ids[MAX_STUDENTS + 1];
+    SubmitRequest partials[MAX_STUDENTS + 1];
+    char          answers[MAX_STUDENTS + 1][24];
+    memset(partials, 0, sizeof(SubmitRequest) * n);
+    for (int i = 0; i < n; i++) {
+        pids[i]    = batch[i].pid;
+        mem_ids[i] = batch[i].pid - 1;
+        // Save whatever the student had to I/O buffer as partial
+        snprintf(answers[i], sizeof(answers[i]), "PARTIAL_PID%d", batch[i].pid);
+        partials[i].pid        = batch[i].pid;
+        partials[i].is_partial = 1;
+        partials[i].answer     = answers[i];
+    }
 
-    // Free memory pages
-    memory_free_process(pid - 1);
+    io_buffer_submit_batch(ctx, partials, n);
+    memory_free_processes(ctx, mem_ids, n);
+    scheduler_terminate_processes(ctx, pids, n);
 
-    // Terminate the process
-    scheduler_terminate_process(pid);
+    long done    = now_us();
+    long elapsed = done - start;
+    for (int i = 0; i < n; i++)
+        hist_record(&in->bh_hist[INT_EXAM_TIMEOUT], done - batch[i].raised_us);
+    hist_record(&in->batch_hist, elapsed);
 
+    SystemState *state = &ctx->state;
     pthread_mutex_lock(&state->lock);
-    state->timeouts_fired++;
+    state->timeouts_fired  += n;
+    state->timeout_batches++;
+    if (n > state->timeout_batch_max) {
+        state->timeout_batch_max    = n;
+        state->timeout_batch_max_us = elapsed;
+    }
     pthread_mutex_unlock(&state->lock);
+
+    char msg[160];
+    int  len = snprintf(msg, sizeof(msg),
+                        "TIMEOUT batch: %d exams expired — partials saved, terminated in %ldus",
+                        n, elapsed);
+    if (queued > n)
+        snprintf(msg + len, sizeof(msg) - len, " (%d completed first)", queued - n);
+    log_event(ctx, "WARN", "INTERRUPT", msg);
 }
 
-// Handler 1: System overload — pause new logins
-static void handle_overload(int pid, SystemState *state) {
-    (void)pid;
-    log_event("WARN", "INTERRUPT", "OVERLOAD: Buffer critical — pausing new submissions");
+// Called by the interrupt thread after each dispatch pass
+static void flush_timeout_batch(SimContext *ctx) {
+    Interrupts *in = ctx->intr;
+    pthread_mutex_lock(&in->batch_lock);
+    int defer = in->expired_count > 0 && !in->batch_scheduled;
+    if (defer) in->batch_scheduled = 1;
+    pthread_mutex_unlock(&in->batch_lock);
 
-    pthread_mutex_lock(&state->lock);
-    state->overload_signals++;
-    pthread_mutex_unlock(&state->lock);
+    if (defer) workqueue_defer(ctx, timeout_batch_bottom_half, -1, 0);
+}
 
-    // Simulate brief pause — back-pressure
-    usleep(TIME_TICK_MS * 2000);
+// Handler 0: Exam timeout
+static void handle_exam_timeout(SimContext *ctx, int pid) {
+    Interrupts *in = ctx->intr;
+
+    // Each pid's deadline fires at most once (the wheel holds one entry
+    // per pid, re-armed only when its raise was refused), and the batch
+    // holds every pid, so it cannot be full here
+    pthread_mutex_lock(&in->batch_lock);
+    if (in->expired_count < MAX_STUDENTS + 1) {
+        in->expired_batch[in->expired_count].pid       = pid;
+        in->expired_batch[in->expired_count].raised_us = in->current_raised_us;
+        in->expired_count++;
+    }
+    pthread_mutex_unlock(&in->batch_lock);
+}
+
+// Handler 1: System overload — open a back-pressure window of two
+// ticks. io_buffer_credit() reads 0 while it is open, so submitters
+// hold their answers and admission lets nobody in; the interrupt
+// thread closes it when it expires. Nothing sleeps here.
+static void handle_overload(SimContext *ctx, int pid) {
+    (void)pid;
+    log_event(ctx, "WARN", "INTERRUPT", "OVERLOAD: Buffer critical — pausing new submissions and logins");
 
-    log_event("INFO", "INTERRUPT", "OVERLOAD resolved — resuming normal operation");
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.overload_signals++;
+    ctx->state.overload_active = 1;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    ctx->intr->overload_until_us = now_us() + TIME_TICK_MS * 2000L;
 }
 
-// Handler 2: Page fault notification
-static void handle_page_fault(int pid, SystemState *state) {
-    (void)state;
-    char msg[64];
-    snprintf(msg, sizeof(msg), "PAGE FAULT raised for PID %d", pid);
-    log_event("INFO", "INTERRUPT", msg);
-    // Actual handling done in memory.c — this just logs it centrally
+// Handler 2: Page fault notification. The fault is handled and
+// logged in memory.c; dispatch counts it per vector
+static void handle_page_fault(SimContext *ctx, int pid) {
+    (void)ctx;
+    (void)pid;
 }
 
 // Handler 3: Submission complete
-static void handle_submit_complete(int pid, SystemState *state) {
-    (void)state;
+static void handle_submit_complete(SimContext *ctx, int pid) {
     char msg[64];
     snprintf(msg, sizeof(msg), "Submission complete for PID %d", pid);
-    log_event("INFO", "INTERRUPT", msg);
+    log_event(ctx, "INFO", "INTERRUPT", msg);
 }
 
 // ─── Register handler in IVT ──────────────────────────────
-static void ivt_register(int id, const char *name, handler_fn handler) {
-    pthread_mutex_lock(&ivt_lock);
-    if (ivt_size < MAX_INTERRUPTS) {
-        ivt[ivt_size].interrupt_id = id;
-        strncpy(ivt[ivt_size].name, name, sizeof(ivt[ivt_size].name) - 1);
-        ivt[ivt_size].handler = handler;
-        ivt_size++;
-    }
-    pthread_mutex_unlock(&ivt_lock);
+static void ivt_register(Interrupts *in, int id, const char *name, int priority,
+                         handler_fn handler) {
+    if (id < 0 || id >= MAX_INTERRUPTS) return;
+
+    pthread_mutex_lock(&in->ivt_lock);
+    if (!in->ivt[id].handler) in->ivt_size++;
+    in->ivt[id].interrupt_id = id;
+    strncpy(in->ivt[id].name, name, sizeof(in->ivt[id].name) - 1);
+    in->ivt[id].priority = priority;
+    in->ivt[id].handler  = handler;
+    pthread_mutex_unlock(&in->ivt_lock);
 }
 
 // ─── Init: register all handlers ─────────────────────────
-void interrupt_init() {
-    sem_init(&int_ready, 0, 0);
-
-    ivt_register(INT_EXAM_TIMEOUT,    "EXAM_TIMEOUT",    handle_exam_timeout);
-    ivt_register(INT_OVERLOAD,        "OVERLOAD",        handle_overload);
-    ivt_register(INT_PAGE_FAULT,      "PAGE_FAULT",      handle_page_fault);
-    ivt_register(INT_SUBMIT_COMPLETE, "SUBMIT_COMPLETE", handle_submit_complete);
+// Also creates the deadline timer wheel, which the scheduler arms
+void interrupt_init(SimContext *ctx) {
+    Interrupts *in = calloc(1, sizeof(Interrupts));
+    ctx->intr  = in;
+    ctx->wheel = timer_wheel_create(0);
+    pthread_mutex_init(&in->ivt_lock,   NULL);
+    pthread_mutex_init(&in->batch_lock, NULL);
+
+    // Round capacity up to a power of two so slots can be masked
+    long cap = 2;
+    int  want = ctx->config.int_queue_capacity > 0 ? ctx->config.int_queue_capacity : 256;
+    while (cap < want) cap <<= 1;
+    for (int level = 0; level < INT_LEVELS; level++) {
+        in->rings[level].cells = calloc(cap, sizeof(IntCell));
+        in->rings[level].mask  = cap - 1;
+        for (long i = 0; i < cap; i++) in->rings[level].cells[i].seq = i;
+        in->rings[level].enq_pos = in->rings[level].deq_pos = 0;
+    }
+    for (int i = 0; i < MAX_INTERRUPTS; i++) {
+        hist_reset(&in->dispatch_hist[i]);
+        hist_reset(&in->bh_hist[i]);
+    }
+    hist_reset(&in->batch_hist);
+
+    ivt_register(in, INT_EXAM_TIMEOUT,    "EXAM_TIMEOUT",    INT_PRIO_CRITICAL, handle_exam_timeout);
+    ivt_register(in, INT_OVERLOAD,        "OVERLOAD",        INT_PRIO_HIGH,     handle_overload);
+    ivt_register(in, INT_PAGE_FAULT,      "PAGE_FAULT",      INT_PRIO_NORMAL,   handle_page_fault);
+    ivt_register(in, INT_SUBMIT_COMPLETE, "SUBMIT_COMPLETE", INT_PRIO_INFO,     handle_submit_complete);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg),
+             "Interrupt vector table initialized (%d handlers, %d levels)",
+             in->ivt_size, INT_LEVELS);
+    log_event(ctx, "INFO", "INTERRUPT", msg);
+}
 
-    log_event("INFO", "INTERRUPT", "Interrupt vector table initialized (4 handlers)");
+// Called after every thread that could raise has been joined
+void interrupt_shutdown(SimContext *ctx) {
+    Interrupts *in = ctx->intr;
+    if (!in) return;
+    for (int level = 0; level < INT_LEVELS; level++) {
+        free(in->rings[level].cells);
+        in->rings[level].cells = NULL;
+    }
+    timer_wheel_destroy(ctx->wheel);
+    ctx->wheel = NULL;
+    pthread_mutex_destroy(&in->ivt_lock);
+    pthread_mutex_destroy(&in->batch_lock);
+    free(in);
+    ctx->intr = NULL;
 }
 
-// ─── Raise an interrupt (thread-safe, non-blocking) ──────
-void interrupt_raise(int interrupt_id, int pid) {
-    pthread_mutex_lock(&int_q_lock);
+// ─── Masking (masked levels stay queued, just not dispatched)
+void interrupt_mask_level(SimContext *ctx, int level) {
+    if (level < 0 || level >= INT_LEVELS) return;
+    __atomic_fetch_or(&ctx->intr->level_mask, 1u << level, __ATOMIC_RELEASE);
+}
 
-    if (int_q_count < 64) {
-        PendingInterrupt *pi = &int_queue[int_q_tail];
-        pi->interrupt_id     = interrupt_id;
-        pi->pid              = pid;
-        pi->timestamp        = now_ms();
+void interrupt_unmask_level(SimContext *ctx, int level) {
+    if (level < 0 || level >= INT_LEVELS) return;
+    __atomic_fetch_and(&ctx->intr->level_mask, ~(1u << level), __ATOMIC_RELEASE);
+}
 
-        int_q_tail  = (int_q_tail + 1) % 64;
-        int_q_count++;
-        sem_post(&int_ready);
+// ─── Raise an interrupt (lock-free, non-blocking) ────────
+// Returns 0 if queued or coalesced into one already pending,
+// -1 if the queue overflowed and the interrupt was not recorded.
+int interrupt_raise(SimContext *ctx, int interrupt_id, int pid) {
+    Interrupts *in = ctx->intr;
+    if (interrupt_id < 0 || interrupt_id >= MAX_INTERRUPTS || !in->ivt[interrupt_id].handler)
+        return -1;
+    __atomic_fetch_add(&in->int_raised[interrupt_id], 1, __ATOMIC_RELAXED);
+
+    unsigned char *bit = pending_bit(in, interrupt_id, pid);
+    if (bit && __atomic_exchange_n(bit, 1, __ATOMIC_ACQ_REL)) {
+        __atomic_fetch_add(&in->int_coalesced[interrupt_id], 1, __ATOMIC_RELAXED);
+        return 0;
     }
 
-    pthread_mutex_unlock(&int_q_lock);
+    PendingInterrupt pi = {
+        .interrupt_id = interrupt_id,
+        .pid          = pid,
+        .raised_us    = now_us()
+    };
+    if (int_q_push(&in->rings[in->ivt[interrupt_id].priority], &pi) == 0) return 0;
+
+    if (bit) __atomic_store_n(bit, 0, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&in->int_overflows[interrupt_id], 1, __ATOMIC_RELAXED);
+    return -1;
 }
 
-// ─── Dispatch: look up IVT and call handler ───────────────
-static void dispatch(PendingInterrupt *pi) {
-    pthread_mutex_lock(&ivt_lock);
+// ─── Dispatch: direct IVT lookup, call handler ───────────
+static void dispatch(SimContext *ctx, PendingInterrupt *pi) {
+    Interrupts *in = ctx->intr;
+    IVTEntry   *v  = &in->ivt[pi->interrupt_id];
+
+    long waited = now_us() - pi->raised_us;
+    hist_record(&in->dispatch_hist[pi->interrupt_id], waited);
+    __atomic_fetch_add(&in->int_handled[pi->interrupt_id], 1, __ATOMIC_RELAXED);
+
+    // L0/L1 vectors come one per page fault or completion: they would
+    // flood the log queue in a storm, and the per-vector counters in
+    // the summary already show them
+    if (v->priority >= INT_PRIO_HIGH) {
+        char msg[128];
+        snprintf(msg, sizeof(msg),
+                 "Dispatching INT_%d (%s, L%d) for PID %d at %ldms (+%ldus)",
+                 pi->interrupt_id, v->name, v->priority, pi->pid,
+                 pi->raised_us / 1000, waited);
+        log_event(ctx, "INFO", "INTERRUPT", msg);
+    }
 
-    for (int i = 0; i < ivt_size; i++) {
-        if (ivt[i].interrupt_id == pi->interrupt_id) {
-            char msg[128];
-            snprintf(msg, sizeof(msg),
-                     "Dispatching INT_%d (%s) for PID %d at %ldms",
-                     pi->interrupt_id, ivt[i].name, pi->pid, pi->timestamp);
-            log_event("INFO", "INTERRUPT", msg);
+    in->current_raised_us = pi->raised_us;
+    v->handler(ctx, pi->pid);
+}
 
-            pthread_mutex_unlock(&ivt_lock);
-            ivt[i].handler(pi->pid, &g_state);
-            return;
+// ─── Pick the next interrupt: highest unmasked level first ─
+// Re-scanned from the top after every handler, so anything more urgent
+// raised meanwhile preempts the lower-priority work still queued.
+static int dispatch_next(SimContext *ctx) {
+    Interrupts *in = ctx->intr;
+    unsigned masked = __atomic_load_n(&in->level_mask, __ATOMIC_ACQUIRE);
+    PendingInterrupt pi;
+
+    for (int level = INT_LEVELS - 1; level >= 0; level--) {
+        if (masked & (1u << level)) continue;
+        if (int_q_pop(&in->rings[level], &pi) != 0) continue;
+
+        for (int lower = level - 1; lower >= 0; lower--) {
+            if (!(masked & (1u << lower)) && int_q_depth(&in->rings[lower]) > 0) {
+                in->int_preemptions++;
+                break;
+            }
         }
+
+        // Pending bit is cleared before the handler runs so a
+        // re-raise during handling queues again
+        unsigned char *bit = pending_bit(in, pi.interrupt_id, pi.pid);
+        if (bit) __atomic_store_n(bit, 0, __ATOMIC_RELEASE);
+        dispatch(ctx, &pi);
+        return 1;
     }
+    return 0;
+}
 
-    pthread_mutex_unlock(&ivt_lock);
-    log_event("WARN", "INTERRUPT", "Unknown interrupt ID received");
+// ─── Storm guard: mask informational levels while timeouts pile up
+static void check_storm_mask(SimContext *ctx) {
+    Interrupts *in = ctx->intr;
+    int threshold = ctx->config.storm_mask_threshold;
+    if (threshold <= 0) return;
+
+    long pending = int_q_depth(&in->rings[INT_PRIO_CRITICAL]);
+    if (!in->storm_masked && pending >= threshold) {
+        interrupt_mask_level(ctx, INT_PRIO_NORMAL);
+        interrupt_mask_level(ctx, INT_PRIO_INFO);
+        in->storm_masked = 1;
+
+        char msg[96];
+        snprintf(msg, sizeof(msg),
+                 "Timeout storm (%ld pending) — masking PAGE_FAULT/SUBMIT_COMPLETE", pending);
+        log_event(ctx, "WARN", "INTERRUPT", msg);
+    } else if (in->storm_masked && pending == 0) {
+        interrupt_unmask_level(ctx, INT_PRIO_NORMAL);
+        interrupt_unmask_level(ctx, INT_PRIO_INFO);
+        in->storm_masked = 0;
+        log_event(ctx, "INFO", "INTERRUPT", "Timeout storm drained — unmasking all levels");
+    }
 }
 
 // ─── Check for overload condition ─────────────────────────
-static void check_overload() {
-    pthread_mutex_lock(&g_io_buffer.lock);
-    float fill = (float)g_io_buffer.count / BUFFER_CAPACITY;
-    pthread_mutex_unlock(&g_io_buffer.lock);
+static void check_overload(SimContext *ctx) {
+    float fill = io_buffer_fill(ctx);
 
     if (fill >= 0.95f) {
-        interrupt_raise(INT_OVERLOAD, -1);
+        interrupt_raise(ctx, INT_OVERLOAD, -1);
     }
 }
 
 // ─── Check for process timeouts ───────────────────────────
-static void check_timeouts() {
-    pthread_mutex_lock(&g_state.lock);
-
-    for (int i = 0; i < g_state.process_count; i++) {
-        PCB *p = &g_state.processes[i];
-        if (p->state == RUNNING || p->state == READY) {
-            p->remaining_time--;
-            if (p->remaining_time <= 0) {
-                // Raise timeout interrupt — handled asynchronously
-                int pid = p->pid;
-                p->state = TERMINATED;
-                pthread_mutex_unlock(&g_state.lock);
-                interrupt_raise(INT_EXAM_TIMEOUT, pid);
-                pthread_mutex_lock(&g_state.lock);
-            }
-        }
+// Deadlines live in the timer wheel; only expiring buckets are touched
+// A timeout that can't be queued is re-armed for the next tick rather
+// than lost — deadlines are the one interrupt we must never drop.
+static void on_deadline(void *arg, int pid) {
+    SimContext *ctx = arg;
+    if (interrupt_raise(ctx, INT_EXAM_TIMEOUT, pid) != 0) {
+        pthread_mutex_lock(&ctx->state.lock);
+        int tick = ctx->state.current_tick;
+        pthread_mutex_unlock(&ctx->state.lock);
+        timer_wheel_arm(ctx->wheel, pid, tick + 1);
     }
+}
+
+static void check_timeouts(SimContext *ctx) {
+    pthread_mutex_lock(&ctx->state.lock);
+    int tick = ctx->state.current_tick;
+    pthread_mutex_unlock(&ctx->state.lock);
 
-    pthread_mutex_unlock(&g_state.lock);
+    int fired = timer_wheel_advance(ctx->wheel, tick, on_deadline, ctx);
+    if (fired > 1) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%d exam deadlines expired at tick %d", fired, tick);
+        log_event(ctx, "WARN", "INTERRUPT", msg);
+    }
 }
 
-// ─── Interrupt thread: monitors system + dispatches ───────
-void *interrupt_thread(void *arg) {
-    (void)arg;
-    log_event("INFO", "INTERRUPT", "Interrupt handler thread started");
+// ─── Queue depth + loss counters for the dashboard ───────
+static void publish_queue_stats(SimContext *ctx) {
+    Interrupts  *in    = ctx->intr;
+    SystemState *state = &ctx->state;
+    long depth = 0, coalesced = 0, overflows = 0;
+    int  level_depth[INT_LEVELS];
+    for (int level = 0; level < INT_LEVELS; level++) {
+        level_depth[level] = (int)int_q_depth(&in->rings[level]);
+        depth += level_depth[level];
+    }
+    for (int i = 0; i < MAX_INTERRUPTS; i++) {
+        coalesced += __atomic_load_n(&in->int_coalesced[i], __ATOMIC_RELAXED);
+        overflows += __atomic_load_n(&in->int_overflows[i], __ATOMIC_RELAXED);
+    }
 
-    int tick_counter = 0;
+    pthread_mutex_lock(&state->lock);
+    state->int_queue_depth     = (int)depth;
+    state->int_queue_capacity  = (int)(in->rings[0].mask + 1) * INT_LEVELS;
+    for (int level = 0; level < INT_LEVELS; level++)
+        state->int_level_depth[level] = level_depth[level];
+    state->int_masked_levels   = (int)__atomic_load_n(&in->level_mask, __ATOMIC_RELAXED);
+    state->int_preemptions     = (int)in->int_preemptions;
+    state->int_coalesced       = (int)coalesced;
+    state->int_overflows       = (int)overflows;
+    state->int_timeout_overflows =
+        (int)__atomic_load_n(&in->int_overflows[INT_EXAM_TIMEOUT], __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&state->lock);
+}
 
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int running = g_state.simulation_running;
-        pthread_mutex_unlock(&g_state.lock);
+// ─── Close the overload window once it has run its course
+static void check_overload_window(SimContext *ctx) {
+    Interrupts *in = ctx->intr;
+    if (in->overload_until_us == 0 || now_us() < in->overload_until_us) return;
 
-        if (!running) break;
+    in->overload_until_us = 0;
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.overload_active = 0;
+    pthread_mutex_unlock(&ctx->state.lock);
+    log_event(ctx, "INFO", "INTERRUPT", "OVERLOAD resolved — resuming normal operation");
+}
 
-        // Check system conditions every tick
-        check_timeouts();
-        check_overload();
+const Histogram *interrupt_dispatch_hist(SimContext *ctx, int interrupt_id) {
+    return &ctx->intr->dispatch_hist[interrupt_id];
+}
 
-        // Dispatch any pending interrupts
-        while (1) {
-            if (sem_trywait(&int_ready) != 0) break;
+const Histogram *interrupt_bh_hist(SimContext *ctx, int interrupt_id) {
+    return &ctx->intr->bh_hist[interrupt_id];
+}
 
-            pthread_mutex_lock(&int_q_lock);
-            if (int_q_count == 0) {
-                pthread_mutex_unlock(&int_q_lock);
-                break;
-            }
-            PendingInterrupt pi = int_queue[int_q_head];
-            int_q_head  = (int_q_head + 1) % 64;
-            int_q_count--;
-            pthread_mutex_unlock(&int_q_lock);
+const Histogram *interrupt_timeout_batch_hist(SimContext *ctx) {
+    return &ctx->intr->batch_hist;
+}
+
+const char *interrupt_name(SimContext *ctx, int interrupt_id) {
+    Interrupts *in = ctx->intr;
+    if (interrupt_id < 0 || interrupt_id >= MAX_INTERRUPTS || !in->ivt[interrupt_id].handler)
+        return "UNKNOWN";
+    return in->ivt[interrupt_id].name;
+}
+
+void interrupt_vector_stats(SimContext *ctx, int interrupt_id, InterruptStats *out) {
+    Interrupts *in = ctx->intr;
+    memset(out, 0, sizeof(InterruptStats));
+    if (interrupt_id < 0 || interrupt_id >= MAX_INTERRUPTS) return;
+    out->priority  = in->ivt[interrupt_id].priority;
+    out->raised    = __atomic_load_n(&in->int_raised[interrupt_id],    __ATOMIC_RELAXED);
+    out->handled   = __atomic_load_n(&in->int_handled[interrupt_id],   __ATOMIC_RELAXED);
+    out->coalesced = __atomic_load_n(&in->int_coalesced[interrupt_id], __ATOMIC_RELAXED);
+    out->overflows = __atomic_load_n(&in->int_overflows[interrupt_id], __ATOMIC_RELAXED);
+}
+
+// ─── Snapshot ────────────────────────────────────────────
+// With the world stopped nothing raises or dispatches, so each ring is
+// read straight from deq_pos to enq_pos. Raise times are monotonic and
+// shifted on restore; a queued timeout batch is deferred again by the
+// next dispatch pass, since the work queue itself is not saved.
+void interrupt_snapshot(SimContext *ctx, SnapWriter *w) {
+    Interrupts *in = ctx->intr;
+    snap_put(w, &in->level_mask,        sizeof(in->level_mask));
+    snap_put(w, &in->storm_masked,      sizeof(in->storm_masked));
+    snap_put(w, &in->int_preemptions,   sizeof(in->int_preemptions));
+    snap_put(w, &in->overload_until_us, sizeof(in->overload_until_us));
+    snap_put(w, in->int_raised,    sizeof(in->int_raised));
+    snap_put(w, in->int_handled,   sizeof(in->int_handled));
+    snap_put(w, in->int_coalesced, sizeof(in->int_coalesced));
+    snap_put(w, in->int_overflows, sizeof(in->int_overflows));
+    snap_put(w, in->dispatch_hist, sizeof(in->dispatch_hist));
+    snap_put(w, in->bh_hist,       sizeof(in->bh_hist));
+    snap_put(w, &in->batch_hist,   sizeof(in->batch_hist));
+
+    pthread_mutex_lock(&in->batch_lock);
+    snap_put(w, &in->expired_count, sizeof(in->expired_count));
+    snap_put(w, in->expired_batch,  sizeof(ExpiredExam) * in->expired_count);
+    pthread_mutex_unlock(&in->batch_lock);
+
+    for (int level = 0; level < INT_LEVELS; level++) {
+        IntRing *r    = &in->rings[level];
+        long     head = r->deq_pos;
+        long     n    = 0;
+        while (n < int_q_depth(r) &&
+               r->cells[(head + n) & r->mask].seq == head + n + 1)
+            n++;
+        snap_put(w, &n, sizeof(n));
+        for (long i = 0; i < n; i++)
+            snap_put(w, &r->cells[(head + i) & r->mask].data, sizeof(PendingInterrupt));
+    }
+}
 
-            dispatch(&pi);
+void interrupt_restore(SimContext *ctx, SnapReader *r) {
+    Interrupts *in = ctx->intr;
+    snap_get(r, &in->level_mask,        sizeof(in->level_mask));
+    snap_get(r, &in->storm_masked,      sizeof(in->storm_masked));
+    snap_get(r, &in->int_preemptions,   sizeof(in->int_preemptions));
+    snap_get(r, &in->overload_until_us, sizeof(in->overload_until_us));
+    snap_get(r, in->int_raised,    sizeof(in->int_raised));
+    snap_get(r, in->int_handled,   sizeof(in->int_handled));
+    snap_get(r, in->int_coalesced, sizeof(in->int_coalesced));
+    snap_get(r, in->int_overflows, sizeof(in->int_overflows));
+    snap_get(r, in->dispatch_hist, sizeof(in->dispatch_hist));
+    snap_get(r, in->bh_hist,       sizeof(in->bh_hist));
+    snap_get(r, &in->batch_hist,   sizeof(in->batch_hist));
+    if (in->overload_until_us) in->overload_until_us += r->rebase_us;
+
+    snap_get(r, &in->expired_count, sizeof(in->expired_count));
+    if (in->expired_count < 0 || in->expired_count > MAX_STUDENTS + 1) r->failed = 1;
+    if (r->failed) return;
+    snap_get(r, in->expired_batch, sizeof(ExpiredExam) * in->expired_count);
+    for (int i = 0; i < in->expired_count; i++) in->expired_batch[i].raised_us += r->rebase_us;
+    in->batch_scheduled = 0;
+
+    // A smaller INT_QUEUE_CAPACITY this run counts what no longer fits
+    memset(in->int_pending, 0, sizeof(in->int_pending));
+    for (int level = 0; level < INT_LEVELS; level++) {
+        long n;
+        snap_get(r, &n, sizeof(n));
+        for (long i = 0; i < n && !r->failed; i++) {
+            PendingInterrupt pi;
+            snap_get(r, &pi, sizeof(pi));
+            if (r->failed) return;
+            if (pi.interrupt_id < 0 || pi.interrupt_id >= MAX_INTERRUPTS) {
+                r->failed = 1;
+                return;
+            }
+            pi.raised_us += r->rebase_us;
+            if (int_q_push(&in->rings[level], &pi) != 0) {
+                in->int_overflows[pi.interrupt_id]++;
+                continue;
+            }
+            unsigned char *bit = pending_bit(in, pi.interrupt_id, pi.pid);
+            if (bit) *bit = 1;
         }
+    }
+}
 
-        tick_counter++;
-        usleep(TIME_TICK_MS * 1000);
+// ─── Interrupt phase: monitors system + dispatches ────────
+// Last phase of every tick: sees everything the others raised
+void interrupt_step(SimContext *ctx, int tick) {
+    (void)tick;
+    snapshot_enter(ctx);
+    check_timeouts(ctx);
+    check_overload(ctx);
+    check_overload_window(ctx);
+
+    // Dispatch pending interrupts, most urgent unmasked level first
+    check_storm_mask(ctx);
+    while (dispatch_next(ctx))
+        check_storm_mask(ctx);
+    flush_timeout_batch(ctx);
+    snapshot_leave(ctx);
+
+    publish_queue_stats(ctx);
+}
+
+// ─── Interrupt thread ─────────────────────────────────────
+void *interrupt_thread(void *arg) {
+    SimContext *ctx = arg;
+    log_event(ctx, "INFO", "INTERRUPT", "Interrupt handler thread started");
+
+    int tick = -1;
+    while ((tick = tick_phase_begin(ctx, TICK_INTERRUPTS, tick)) >= 0) {
+        interrupt_step(ctx, tick);
+        tick_phase_end(ctx, TICK_INTERRUPTS);
     }
 
-    log_event("INFO", "INTERRUPT", "Interrupt thread exiting");
+    log_event(ctx, "INFO", "INTERRUPT", "Interrupt thread exiting");
     return NULL;
-}
\ No newline at end of file
+}
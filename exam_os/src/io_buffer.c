@@ -2,14 +2,100 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
 #include <time.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
 #include "io_buffer.h"
+#include "tick_clock.h"
 #include "logger.h"
+#include "interrupt.h"
+#include "histogram.h"
+#include "answer_arena.h"
+#include "wal.h"
+#include "rng.h"
+#include "trace.h"
 
 #define FLUSH_THRESHOLD 0.80  // flush when 80% full
+#define GROW_THRESHOLD  0.95  // sustained fill that counts as pressure
+#define GROW_AFTER_TICKS 3    // consecutive pressured ticks before doubling
+#define FLUSH_BATCH     256   // slots claimed per consumer pass
+#define FLUSH_CHUNKS    16    // formatted batches gathered per writev
+#define LINE_BYTES      224   // upper bound for one formatted line, inline answer included
+#define INLINE_ANSWER   128   // longer answers are written from their slab
+#define IOV_LIMIT       1024  // iovecs per writev (IOV_MAX on Linux)
+#define CREDIT_SOFT     0.50  // BLOCK: fill where credits start shrinking
+#define THRESHOLD_MIN   0.05  // ADAPTIVE: floor for the flush trigger
+#define AIMD_STEP       0.02  // ADAPTIVE: additive step per tick
+#define AIMD_DECREASE   0.50  // ADAPTIVE: multiplicative cut on congestion
+#define RATE_ALPHA      0.25  // EWMA weight of the latest tick's arrivals
 
-static FILE *disk_file   = NULL;
-static int   io_running  = 1;
+#define MERGED_FILE     "submissions.txt"   // paths are under output_dir
+#define STORE_DIR       "store"
+#define WAL_DIR         "wal"
+#define COMPACT_TICKS   20    // ticks between compaction passes
+
+typedef struct IOState {
+    int       num_shards;
+    sem_t     shutdown;           // posted by io_buffer_shutdown()
+
+    // ─── Submit-path accounting (lock-free; published per tick) ─
+    long      submitted;
+    long      dropped;
+    Histogram submit_hist;      // enqueue latency, ns
+    Histogram storm_hist;       // same, demo storm only
+    long      storm_count;
+    long      storm_ns;
+    int       storm_active;     // io thread only
+    int       storm_triggered;  // demo storm already ran (io thread)
+    Rng       storm_rng;        // RNG_STORM (I/O phase)
+    Rng       rng[MAX_STUDENTS];   // RNG_SUBMIT, by pid - 1 (I/O phase)
+
+    // ─── Flush-path accounting (shared by all flushers) ──────
+    Histogram flush_size_hist;  // submissions per flush
+    Histogram flush_lat_hist;   // format + writev + sync, µs
+    Histogram sync_lat_hist;    // fdatasync alone, µs
+    Histogram phase_hist[IO_PHASES];   // per submission, µs
+    int       thr_min_pct, thr_max_pct;   // io thread only
+
+    // ─── Blocking back-pressure (SUBMIT_POLICY = BLOCK) ──────
+    // Producers that find their shard full sleep on its space_cond until
+    // the flusher frees slots or their deadline passes; a waiting producer
+    // kicks the flusher so it drains now rather than at its next tick.
+    long      delayed;
+    Histogram wait_hist;        // added latency of delayed submits, µs
+
+    // ─── Coalescing (COALESCE = ON) ──────────────────────────
+    // A per-shard hash of (pid, question) → ring position of the queued
+    // submission. A newer answer for a key still in the ring replaces the
+    // queued answer in place (text, timestamps, partial flag) instead of
+    // taking a slot, so only the final version is written. Producers and
+    // the flusher serialize on coalesce_lock: the ring is no longer
+    // lock-free in this mode, the price of finding the queued slot.
+    long      coalesced;
+
+    // ─── Write-ahead log (WAL = ON) ──────────────────────────
+    // Every accepted submission is logged per shard and the submitter
+    // waits for its group commit. Flushers checkpoint the LSN their
+    // segment has durably reached; a log left without a CLOSE record is
+    // replayed from its checkpoint at the next start.
+    int       recovering;       // this run resumes a crashed one
+    long      recovered;        // submissions replayed from the WAL
+    long      recover_ms;
+    WalStats  wal_totals;       // closed logs, summed
+    long      wal_failed;       // accepted, but the log failed before they were durable
+
+    long      seg_len[MAX_IO_SHARDS];   // recorded for the snapshot's segment pass
+} IOState;
+
+static int flush_buffer(IOBuffer *b);
+static int ring_pop_batch(IOBuffer *b, Submission *out, int max);
+static long try_push(IOBuffer *b, const Submission *s);
+static int write_all(int fd, struct iovec *iov, int cnt);
+static size_t format_batch(IOBuffer *b, char *chunk, const Submission *batch, int n,
+                           struct iovec *iov, int *iovcnt);
 
 // ─── Timestamp ────────────────────────────────────────────
 static long now_ms() {
@@ -18,195 +104,1688 @@ static long now_ms() {
     return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
 }
 
+static long now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+static long now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static int round_pow2(int n) {
+    int cap = 2;
+    while (cap < n && cap < MAX_BUFFER_CAPACITY) cap <<= 1;
+    return cap;
+}
+
+// Multiplicative hash so consecutive pids spread across shards
+static int shard_index(int pid, int shards) {
+    unsigned h = (unsigned)pid * 2654435761u;
+    return (int)((h >> 16) % (unsigned)shards);
+}
+
+static IOBuffer *shard_for(SimContext *ctx, int pid) {
+    IOState *io = ctx->io_state;
+    return &ctx->io[shard_index(pid, io->num_shards)];
+}
+
+void io_buffer_store_dir(const Config *cfg, int pid, char *out, size_t len) {
+    int shards = cfg->io_shards;
+    if (shards < 1)             shards = 1;
+    if (shards > MAX_IO_SHARDS) shards = MAX_IO_SHARDS;
+    snprintf(out, len, "%s/" STORE_DIR "/shard%d", cfg->output_dir, shard_index(pid, shards));
+}
+
+static void segment_path(SimContext *ctx, char *out, size_t len, int shard) {
+    IOState *io = ctx->io_state;
+    if (io->num_shards == 1) snprintf(out, len, "%s/" MERGED_FILE, ctx->config.output_dir);
+    else snprintf(out, len, "%s/submissions.shard%d.txt", ctx->config.output_dir, shard);
+}
+
+static void ring_alloc(IOBuffer *b, int capacity) {
+    b->cells    = calloc(capacity, sizeof(SubmitCell));
+    b->capacity = capacity;
+    b->mask     = capacity - 1;
+    for (long i = 0; i < capacity; i++) b->cells[i].seq = i;
+    b->enq_pos = b->deq_pos = 0;
+}
+
+static long ring_depth(IOBuffer *b) {
+    return __atomic_load_n(&b->enq_pos, __ATOMIC_RELAXED)
+         - __atomic_load_n(&b->deq_pos, __ATOMIC_RELAXED);
+}
+
+// Copy counters into the SystemState for the dashboard and report
+static void publish_stats(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    int depth = 0, capacity = 0, fill[MAX_IO_SHARDS];
+    for (int i = 0; i < io->num_shards; i++) {
+        int d = (int)ring_depth(&ctx->io[i]);
+        depth    += d;
+        capacity += ctx->io[i].capacity;
+        fill[i]   = d * 100 / ctx->io[i].capacity;
+    }
+
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.buffer_count        = depth;
+    ctx->state.buffer_capacity     = capacity;
+    for (int i = 0; i < io->num_shards; i++) ctx->state.shard_fill[i] = fill[i];
+    ctx->state.total_submissions   = (int)__atomic_load_n(&io->submitted, __ATOMIC_RELAXED);
+    ctx->state.dropped_submissions = (int)__atomic_load_n(&io->dropped,   __ATOMIC_RELAXED);
+    ctx->state.delayed_submissions = (int)__atomic_load_n(&io->delayed,   __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&ctx->state.lock);
+}
+
+static void wal_dir(SimContext *ctx, char *out, size_t len, int shard) {
+    snprintf(out, len, "%s/" WAL_DIR "/shard%d", ctx->config.output_dir, shard);
+}
+
+// ─── Recovery: replay what a crashed run never wrote ────
+// Records above each log's checkpoint go through the rings and out to
+// the segments (and store) like a flush, minus completions and stats.
+// Everything is synced before the old logs are dropped. A snapshot
+// restore queues its submissions the same way.
+static void replay_flush(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    struct iovec iov[2 * FLUSH_BATCH + 1];
+    const char  *answers[FLUSH_BATCH];
+    int n;
+    while ((n = ring_pop_batch(b, b->batch, FLUSH_BATCH)) > 0) {
+        int iovcnt = 0;
+        format_batch(b, b->chunks, b->batch, n, iov, &iovcnt);
+        for (int i = 0; i < n; i++) {
+            answers[i]  = arena_get(&b->arena, b->batch[i].answer);
+            b->slabs[i] = b->batch[i].answer.slab;
+        }
+        store_append(b->store, b->batch, answers, n);
+        if (write_all(b->fd, iov, iovcnt) != 0)
+            log_event(ctx, "ERROR", "IO", "WAL replay: segment write failed");
+        arena_release(&b->arena, b->slabs, n);
+    }
+}
+
+// Queue a submission before the flushers run: a full ring or arena is
+// drained in place. Logged if this run already has its WAL open.
+static int requeue(IOBuffer *b, Submission *s, const char *text) {
+    if (arena_put(&b->arena, text, &s->answer) != 0) {
+        replay_flush(b);
+        if (arena_put(&b->arena, text, &s->answer) != 0) return -1;
+    }
+    s->lsn = 0;
+    if (b->wal) {
+        s->lsn = ++b->next_lsn;
+        wal_append(b->wal, s->lsn, 0, s, text);
+    }
+    while (try_push(b, s) < 0) replay_flush(b);
+    return 0;
+}
+
+static void replay_record(void *arg, const WalRecordHeader *h, const char *answer) {
+    SimContext *ctx = arg;
+    IOState    *io  = ctx->io_state;
+    char text[MAX_ANSWER_BYTES + 1];
+    int  len = h->len < MAX_ANSWER_BYTES ? (int)h->len : MAX_ANSWER_BYTES;
+    memcpy(text, answer, len);
+    text[len] = '\0';
+
+    IOBuffer  *b = shard_for(ctx, h->pid);
+    Submission s;
+    memset(&s, 0, sizeof(s));
+    s.pid         = h->pid;
+    s.question_id = h->question_id;
+    s.timestamp   = h->timestamp;
+    s.submit_us   = now_us();
+    s.is_partial  = h->is_partial;
+    if (requeue(b, &s, text) == 0) io->recovered++;
+}
+
+static void recover_from_wal(SimContext *ctx, const WalScan *scans) {
+    IOState *io = ctx->io_state;
+    long t0 = now_us();
+    long pending = 0;
+    for (int i = 0; i < MAX_IO_SHARDS; i++) {
+        if (!scans[i].crashed) continue;
+        char dir[256];
+        wal_dir(ctx, dir, sizeof(dir), i);
+        wal_replay(dir, scans[i].checkpoint, replay_record, ctx);
+        pending += scans[i].pending;
+    }
+    for (int i = 0; i < io->num_shards; i++) {
+        IOBuffer *b = &ctx->io[i];
+        replay_flush(b);
+        if (b->fd != STDERR_FILENO) fdatasync(b->fd);
+        store_sync(b->store);
+    }
+    io->recover_ms = (now_us() - t0) / 1000;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Recovered a crashed run: %ld of %ld logged submissions replayed in %ld ms",
+             io->recovered, pending, io->recover_ms);
+    log_event(ctx, "WARN", "IO", msg);
+}
+
 // ─── Init ─────────────────────────────────────────────────
-void io_buffer_init() {
-    g_io_buffer.head  = 0;
-    g_io_buffer.tail  = 0;
-    g_io_buffer.count = 0;
+// Each of IO_SHARDS shards gets a BUFFER_CAPACITY ring, rounded up to
+// a power of two so slot indices are a mask instead of a modulo, and
+// its own output segment. One shard writes submissions.txt directly.
+// After a crash (WAL = ON) the outputs are kept and appended to; a
+// snapshot restore supersedes the crashed run and discards its log.
+void io_buffer_init(SimContext *ctx) {
+    IOState *io = calloc(1, sizeof(IOState));
+    ctx->io_state  = io;
+    sem_init(&io->shutdown, 0, 0);
+    io->num_shards = ctx->config.io_shards;
+    if (io->num_shards < 1)             io->num_shards = 1;
+    if (io->num_shards > MAX_IO_SHARDS) io->num_shards = MAX_IO_SHARDS;
+    rng_seed(&io->storm_rng, ctx->config.seed, RNG_STORM, 0);
+    for (int i = 0; i < MAX_STUDENTS; i++)
+        rng_seed(&io->rng[i], ctx->config.seed, RNG_SUBMIT, i + 1);
+
+    WalScan scans[MAX_IO_SHARDS];
+    io->recovering = io->recovered = io->recover_ms = io->wal_failed = 0;
+    memset(&io->wal_totals, 0, sizeof(io->wal_totals));
+    for (int i = 0; i < MAX_IO_SHARDS; i++) {
+        char dir[256];
+        wal_dir(ctx, dir, sizeof(dir), i);
+        if (ctx->config.wal_enabled && wal_scan(dir, &scans[i]) == 0 && scans[i].crashed)
+            io->recovering = !ctx->config.restore_path[0];
+        else
+            scans[i].crashed = 0;
+    }
+
+    int want = ctx->config.buffer_capacity > 0 ? ctx->config.buffer_capacity : 256;
+    for (int i = 0; i < io->num_shards; i++) {
+        IOBuffer *b = &ctx->io[i];
+        memset(b, 0, sizeof(IOBuffer));
+        b->ctx = ctx;
+        ring_alloc(b, round_pow2(want));
+        b->max_capacity = ctx->config.buffer_max_capacity > b->capacity
+                          ? round_pow2(ctx->config.buffer_max_capacity)
+                          : b->capacity;
+        b->id           = i;
+        b->threshold    = FLUSH_THRESHOLD;
+        b->last_sync_ms = now_ms();
+        b->batch  = malloc(sizeof(Submission) * FLUSH_BATCH);
+        b->chunks = malloc((size_t)FLUSH_CHUNKS * FLUSH_BATCH * LINE_BYTES);
+        b->pids   = malloc(sizeof(int) * FLUSH_CHUNKS * FLUSH_BATCH);
+        b->pending_cap = FLUSH_CHUNKS * FLUSH_BATCH;
+        b->pending     = malloc(sizeof(PendingSync) * b->pending_cap);
+        b->slabs       = malloc(sizeof(int) * FLUSH_CHUNKS * FLUSH_BATCH);
+        arena_init(&b->arena);
+        if (ctx->config.coalesce) {
+            // Keys in the index never exceed queued slots: load <= 1/2
+            long slots = round_pow2(b->max_capacity * 2);
+            b->coalesce      = calloc(slots, sizeof(CoalesceSlot));
+            b->coalesce_mask = slots - 1;
+        }
+        pthread_mutex_init(&b->coalesce_lock, NULL);
+        pthread_mutex_init(&b->wal_lock, NULL);
+        pthread_mutex_init(&b->space_lock, NULL);
+        pthread_cond_init(&b->space_cond, NULL);
+        sem_init(&b->kick, 0, 0);
+
+        // Raw fd, no stdio: every byte we count as flushed went to write()
+        char path[256];
+        segment_path(ctx, path, sizeof(path), i);
+        b->fd = open(path, O_WRONLY | O_CREAT | (io->recovering ? O_APPEND : O_TRUNC), 0644);
+        if (b->fd < 0) {
+            fprintf(stderr, "WARNING: Could not open %s\n", path);
+            b->fd = STDERR_FILENO;
+        }
+        char header[64];
+        int  len = io->num_shards == 1
+                   ? snprintf(header, sizeof(header), "=== EXAM SUBMISSIONS ===\n\n")
+                   : snprintf(header, sizeof(header), "=== EXAM SUBMISSIONS (shard %d/%d) ===\n\n",
+                              i, io->num_shards);
+        if (lseek(b->fd, 0, SEEK_END) == 0 && write(b->fd, header, len) < 0)
+            log_event(ctx, "ERROR", "IO", "Could not write submissions header");
 
-    sem_init(&g_io_buffer.empty_slots, 0, BUFFER_CAPACITY);
-    sem_init(&g_io_buffer.filled_slots, 0, 0);
-    pthread_mutex_init(&g_io_buffer.lock, NULL);
+        if (ctx->config.store_enabled) {
+            snprintf(path, sizeof(path), "%s/" STORE_DIR "/shard%d", ctx->config.output_dir, i);
+            b->store = store_open(path, (long)ctx->config.store_segment_kb * 1024, io->recovering);
+            if (!b->store) log_event(ctx, "ERROR", "IO", "Could not open the binary store");
+        }
+    }
+
+    io->submitted = io->dropped = io->delayed = io->coalesced = 0;
+    io->storm_count = io->storm_ns = 0;
+    hist_reset(&io->submit_hist);
+    hist_reset(&io->storm_hist);
+    hist_reset(&io->flush_size_hist);
+    hist_reset(&io->flush_lat_hist);
+    hist_reset(&io->sync_lat_hist);
+    hist_reset(&io->wait_hist);
+    for (int i = 0; i < IO_PHASES; i++) hist_reset(&io->phase_hist[i]);
+    io->thr_min_pct = 100;
+    io->thr_max_pct = 0;
+
+    // Old logs go only once their records are safely in the outputs
+    if (io->recovering) recover_from_wal(ctx, scans);
+    for (int i = 0; i < MAX_IO_SHARDS; i++) {
+        char dir[256];
+        wal_dir(ctx, dir, sizeof(dir), i);
+        if (ctx->config.wal_enabled && i < io->num_shards) {
+            ctx->io[i].wal = wal_open(dir, ctx->config.wal_commit_ms);
+            if (!ctx->io[i].wal) log_event(ctx, "ERROR", "IO", "Could not open the write-ahead log");
+        } else if (scans[i].crashed) {
+            wal_remove(dir);
+        }
+    }
+
+    publish_stats(ctx);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "I/O buffer initialized (%d x %d slots of %zu bytes, max %d)",
+             io->num_shards, ctx->io[0].capacity, sizeof(SubmitCell),
+             ctx->io[0].max_capacity);
+    log_event(ctx, "INFO", "IO", msg);
+}
+
+void io_buffer_shutdown(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    sem_post(&io->shutdown);   // flushers drain once more and exit
+}
 
-    disk_file = fopen("output/submissions.txt", "w");
-    if (!disk_file) {
-        fprintf(stderr, "WARNING: Could not open submissions file\n");
-        disk_file = stderr;
+void io_buffer_destroy(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    if (!io) return;
+    sem_destroy(&io->shutdown);
+    for (int i = 0; i < io->num_shards; i++) {
+        IOBuffer *b = &ctx->io[i];
+        sem_destroy(&b->kick);
+        pthread_cond_destroy(&b->space_cond);
+        pthread_mutex_destroy(&b->space_lock);
+        free(b->cells);
+        free(b->batch);
+        free(b->chunks);
+        free(b->pids);
+        free(b->pending);
+        free(b->slabs);
+        arena_destroy(&b->arena);
+        free(b->coalesce);
+        b->coalesce = NULL;
+        pthread_mutex_destroy(&b->coalesce_lock);
+        pthread_mutex_destroy(&b->wal_lock);
+        store_close(b->store);
+        b->store = NULL;
+        b->cells = NULL;
     }
-    fprintf(disk_file, "=== EXAM SUBMISSIONS ===\n\n");
-    fflush(disk_file);
+    free(io);
+    ctx->io_state = NULL;
+}
 
-    log_event("INFO", "IO", "I/O buffer initialized");
+// ─── Producer side ───────────────────────────────────────
+// Producers announce themselves in `writers` before touching the
+// ring, so the flusher can wait them out when it swaps in a larger
+// one. Outside a resize that is one uncontended atomic add.
+static void enter_ring(IOBuffer *b) {
+    while (1) {
+        __atomic_add_fetch(&b->writers, 1, __ATOMIC_SEQ_CST);
+        if (!__atomic_load_n(&b->resizing, __ATOMIC_SEQ_CST)) return;
+        __atomic_sub_fetch(&b->writers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&b->resizing, __ATOMIC_ACQUIRE))
+            sched_yield();
+    }
 }
 
-void io_buffer_shutdown() {
-    io_running = 0;
-    sem_post(&g_io_buffer.filled_slots); // wake flusher thread to exit
+static void leave_ring(IOBuffer *b) {
+    __atomic_sub_fetch(&b->writers, 1, __ATOMIC_RELEASE);
+}
+
+// Claim one slot and publish s into it. Returns its position, or -1
+// if the ring is full.
+static long ring_push(IOBuffer *b, const Submission *s) {
+    SubmitCell *cell;
+    long pos = __atomic_load_n(&b->enq_pos, __ATOMIC_RELAXED);
+
+    while (1) {
+        cell = &b->cells[pos & b->mask];
+        long seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        long dif = seq - pos;
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&b->enq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (dif < 0) {
+            return -1;  // full
+        } else {
+            pos = __atomic_load_n(&b->enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->sub = *s;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return pos;
+}
+
+static long try_push(IOBuffer *b, const Submission *s) {
+    enter_ring(b);
+    long pos = ring_push(b, s);
+    leave_ring(b);
+    return pos;
+}
+
+// BLOCK policy: wait for a slot until submit_wait_ms (0 = forever).
+// A flusher never waits on itself — it drains its ring and retries.
+static long push_blocking(IOBuffer *b, const Submission *s) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    long t0       = now_us();
+    long limit_us = ctx->config.submit_wait_ms * 1000L;
+    long rc       = -1;
+
+    if (pthread_equal(pthread_self(), b->flusher)) {
+        do {
+            flush_buffer(b);
+            rc = try_push(b, s);
+        } while (rc < 0 && (limit_us == 0 || now_us() - t0 < limit_us));
+    } else {
+        sem_post(&b->kick);
+        pthread_mutex_lock(&b->space_lock);
+        b->space_waiters++;
+        while ((rc = try_push(b, s)) < 0) {
+            if (limit_us > 0 && now_us() - t0 >= limit_us) break;
+            // Re-check at least every tick even without a wake-up
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += TIME_TICK_MS * 1000000L;
+            ts.tv_sec  += ts.tv_nsec / 1000000000L;
+            ts.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&b->space_cond, &b->space_lock, &ts);
+        }
+        b->space_waiters--;
+        pthread_mutex_unlock(&b->space_lock);
+    }
+
+    __atomic_store_n(&b->congested, 1, __ATOMIC_RELAXED);
+    if (rc >= 0) {
+        __atomic_add_fetch(&io->delayed, 1, __ATOMIC_RELAXED);
+        hist_record(&io->wait_hist, now_us() - t0);
+    }
+    return rc;
+}
+
+// Called by a flusher after releasing slots
+static void wake_space_waiters(IOBuffer *b) {
+    if (!__atomic_load_n(&b->space_waiters, __ATOMIC_ACQUIRE)) return;
+    pthread_mutex_lock(&b->space_lock);
+    pthread_cond_broadcast(&b->space_cond);
+    pthread_mutex_unlock(&b->space_lock);
+}
+
+static long coalesce_home(IOBuffer *b, int pid, int qid) {
+    unsigned h = (unsigned)pid * 2654435761u ^ (unsigned)qid * 0x85EBCA77u;
+    return (h ^ (h >> 15)) & b->coalesce_mask;
+}
+
+// Index probe: the slot holding (pid, qid), or the empty one ending its run
+static long coalesce_find(IOBuffer *b, int pid, int qid) {
+    long i = coalesce_home(b, pid, qid);
+    while (b->coalesce[i].pid != 0 &&
+           (b->coalesce[i].pid != pid || b->coalesce[i].question_id != qid))
+        i = (i + 1) & b->coalesce_mask;
+    return i;
+}
+
+// Linear-probing delete by backward shift: no tombstones, so probe
+// runs stay as short as the live keys make them
+static void coalesce_delete(IOBuffer *b, long i) {
+    CoalesceSlot *t = b->coalesce;
+    long mask = b->coalesce_mask, j = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (t[j].pid == 0) break;
+        // t[j] may fill the hole only if its home is not in (i, j]
+        long home = coalesce_home(b, t[j].pid, t[j].question_id);
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            t[i] = t[j];
+            i = j;
+        }
+    }
+    t[i].pid = 0;
+}
+
+// Caller holds coalesce_lock. Replace the queued answer for s's key, if
+// any; the flusher only reads cells under the same lock. The cell keeps
+// its own LSN, returned in *carrier: the checkpoint must not pass
+// submissions queued between the two.
+static int coalesce_replace(IOBuffer *b, const Submission *s, long *carrier) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    CoalesceSlot *c = &b->coalesce[coalesce_find(b, s->pid, s->question_id)];
+    if (c->pid == 0) return 0;
+
+    Submission *q   = &b->cells[c->pos & b->mask].sub;
+    int         old = q->answer.slab;
+    *carrier      = q->lsn;
+    q->answer     = s->answer;
+    q->timestamp  = s->timestamp;
+    q->submit_us  = s->submit_us;
+    q->is_partial = s->is_partial;
+    arena_release(&b->arena, &old, 1);
+    __atomic_add_fetch(&io->coalesced, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Caller holds coalesce_lock; s was just published at pos
+static void coalesce_track(IOBuffer *b, const Submission *s, long pos) {
+    CoalesceSlot *c = &b->coalesce[coalesce_find(b, s->pid, s->question_id)];
+    c->pid         = s->pid;
+    c->question_id = s->question_id;
+    c->pos         = pos;
+}
+
+// Caller holds coalesce_lock; out[0..n) were popped from pos onwards
+static void coalesce_forget(IOBuffer *b, const Submission *out, long pos, int n) {
+    for (int i = 0; i < n; i++) {
+        long k = coalesce_find(b, out[i].pid, out[i].question_id);
+        if (b->coalesce[k].pid != 0 && b->coalesce[k].pos == pos + i)
+            coalesce_delete(b, k);
+    }
+}
+
+// Queue s, its answer already in the arena. Returns 0 when queued, 1
+// when it replaced a queued answer (COALESCE, its LSN in *carrier), -1
+// when refused. A submit that had to wait for space is queued but not
+// indexed.
+static int push_submission(IOBuffer *b, Submission *s, long *carrier) {
+    SimContext *ctx = b->ctx;
+    long pos;
+    if (b->coalesce) {
+        pthread_mutex_lock(&b->coalesce_lock);
+        if (coalesce_replace(b, s, carrier)) {
+            pthread_mutex_unlock(&b->coalesce_lock);
+            return 1;
+        }
+        pos = try_push(b, s);
+        if (pos >= 0) coalesce_track(b, s, pos);
+        pthread_mutex_unlock(&b->coalesce_lock);
+    } else {
+        pos = try_push(b, s);
+    }
+    if (pos < 0 && ctx->config.submit_policy == SUBMIT_BLOCK)
+        pos = push_blocking(b, s);
+    return pos < 0 ? -1 : 0;
+}
+
+// Copy the answer into the shard's arena, then queue the handle; a
+// refused push hands the answer straight back. With WAL on, an
+// accepted submission is logged with the next LSN under wal_lock;
+// the caller then waits for s->lsn with wal_wait().
+static int enqueue(IOBuffer *b, Submission *s, const char *text) {
+    if (arena_put(&b->arena, text, &s->answer) != 0) return -1;
+
+    s->lsn = 0;
+    if (b->wal) {
+        pthread_mutex_lock(&b->wal_lock);
+        s->lsn = b->next_lsn + 1;
+    }
+    long carrier = 0;
+    int  rc = push_submission(b, s, &carrier);
+    if (b->wal) {
+        if (rc >= 0) {
+            b->next_lsn = s->lsn;
+            wal_append(b->wal, s->lsn, carrier, s, text);
+        } else {
+            s->lsn = 0;
+        }
+        pthread_mutex_unlock(&b->wal_lock);
+    }
+    if (rc < 0) arena_release(&b->arena, &s->answer.slab, 1);
+    return rc;
+}
+
+// The shard's log failed before these n submissions were durable:
+// they are counted as failed rather than submitted
+static void count_wal_failures(IOBuffer *b, int n, int pid, int question_id) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    __atomic_add_fetch(&io->wal_failed, n, __ATOMIC_RELAXED);
+
+    char msg[160];
+    if (n == 1)
+        snprintf(msg, sizeof(msg), "WAL FAILED: PID %d Q%d not durable — shard %d log: %s",
+                 pid, question_id, b->id, strerror(wal_error(b->wal)));
+    else
+        snprintf(msg, sizeof(msg), "WAL FAILED: %d submissions not durable — shard %d log: %s",
+                 n, b->id, strerror(wal_error(b->wal)));
+    log_event(ctx, "ERROR", "IO", msg);
+}
+
+// Full ring, no slot after any BLOCK wait: count against the shard
+static void count_drops(IOBuffer *b, int n) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    __atomic_add_fetch(&io->dropped,  n, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&b->drops, n, __ATOMIC_RELAXED);
+    __atomic_store_n(&b->congested, 1, __ATOMIC_RELAXED);
 }
 
 // ─── Producer: called by exam processes ──────────────────
-int io_buffer_submit(int pid, int question_id,
+// DROP policy never blocks: a full ring (or answer arena) drops and
+// counts the submission. BLOCK waits for a slot up to submit_wait_ms.
+int io_buffer_submit(SimContext *ctx, int pid, int question_id,
                      const char *answer, int is_partial) {
-    // Non-blocking try — if buffer full, drop submission
-    int rc = sem_trywait(&g_io_buffer.empty_slots);
-    if (rc != 0) {
-        pthread_mutex_lock(&g_state.lock);
-        g_state.dropped_submissions++;
-        pthread_mutex_unlock(&g_state.lock);
-
-        char msg[128];
+    IOState *io = ctx->io_state;
+    long t0 = now_ns();
+    IOBuffer *b = shard_for(ctx, pid);
+
+    Submission s;
+    s.pid         = pid;
+    s.question_id = question_id;
+    s.timestamp   = now_ms();
+    s.submit_us   = now_us();
+    s.is_partial  = is_partial;
+
+    int rc = enqueue(b, &s, answer ? answer : "EMPTY");
+    int lost = rc >= 0 && wal_wait(b->wal, s.lsn) != 0;
+    if (lost)         count_wal_failures(b, 1, pid, question_id);
+    else if (rc >= 0) __atomic_add_fetch(&io->submitted, 1, __ATOMIC_RELAXED);
+    else              count_drops(b, 1);
+    long took = now_ns() - t0;
+    hist_record(&io->submit_hist, took);
+    if (io->storm_active) hist_record(&io->storm_hist, took);
+    if (lost) return -1;
+
+    char msg[128];
+    if (rc < 0) {
         snprintf(msg, sizeof(msg),
                  "DROP: PID %d Q%d — buffer full!", pid, question_id);
-        log_event("ERROR", "IO", msg);
+        log_event(ctx, "ERROR", "IO", msg);
         return -1;
     }
+    snprintf(msg, sizeof(msg), "PID %d submitted Q%d%s%s",
+             pid, question_id, is_partial ? " (PARTIAL/timeout)" : "",
+             rc == 1 ? " (coalesced)" : "");
+    log_event(ctx, "INFO", "IO", msg);
+    return 0;
+}
 
-    pthread_mutex_lock(&g_io_buffer.lock);
+// ─── Vectored producer: enqueue a whole batch at once ────
+// Each submission goes to its pid's shard; those that don't fit are
+// dropped (and counted), or under BLOCK waited for. One log line for
+// the batch. Returns how many were accepted.
+int io_buffer_submit_batch(SimContext *ctx, const SubmitRequest *reqs, int n) {
+    IOState *io = ctx->io_state;
+    long now = now_ms(), now_u = now_us();
+    int  accepted = 0;
+    long wait_lsn[MAX_IO_SHARDS] = { 0 };
+    int  shard_accepted[MAX_IO_SHARDS] = { 0 };
 
-    Submission *s   = &g_io_buffer.buffer[g_io_buffer.tail];
-    s->pid          = pid;
-    s->question_id  = question_id;
-    s->timestamp    = now_ms();
-    s->is_partial   = is_partial;
-    strncpy(s->answer, answer ? answer : "EMPTY", sizeof(s->answer) - 1);
+    for (int i = 0; i < n; i++) {
+        IOBuffer  *b = shard_for(ctx, reqs[i].pid);
+        Submission s;
+        s.pid         = reqs[i].pid;
+        s.question_id = reqs[i].question_id;
+        s.is_partial  = reqs[i].is_partial;
+        s.timestamp   = now;
+        s.submit_us   = now_u;
 
-    g_io_buffer.tail  = (g_io_buffer.tail + 1) % BUFFER_CAPACITY;
-    g_io_buffer.count++;
+        if (enqueue(b, &s, reqs[i].answer ? reqs[i].answer : "EMPTY") >= 0) {
+            accepted++;
+            shard_accepted[b->id]++;
+            if (s.lsn > wait_lsn[b->id]) wait_lsn[b->id] = s.lsn;
+        } else {
+            count_drops(b, 1);
+        }
+    }
+    // One durability wait per shard covers the whole batch; a failed
+    // log fails every submission the batch put on that shard
+    int queued = accepted;
+    for (int i = 0; i < io->num_shards; i++) {
+        if (wait_lsn[i] > 0 && wal_wait(ctx->io[i].wal, wait_lsn[i]) != 0) {
+            count_wal_failures(&ctx->io[i], shard_accepted[i], 0, 0);
+            accepted -= shard_accepted[i];
+        }
+    }
+    __atomic_add_fetch(&io->submitted, accepted, __ATOMIC_RELAXED);
 
-    // Update shared state for dashboard
-    pthread_mutex_lock(&g_state.lock);
-    g_state.buffer_count       = g_io_buffer.count;
-    g_state.total_submissions++;
-    pthread_mutex_unlock(&g_state.lock);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "Batch of %d submissions queued%s", accepted,
+             accepted < queued ? " — rest NOT DURABLE, log failed!"
+             : accepted < n    ? " — rest DROPPED, buffer full!" : "");
+    log_event(ctx, accepted < n ? "ERROR" : "INFO", "IO", msg);
+    return accepted;
+}
 
-    pthread_mutex_unlock(&g_io_buffer.lock);
-    sem_post(&g_io_buffer.filled_slots);
+// Fill of the fullest shard: that is the one about to drop or block
+float io_buffer_fill(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    float worst = 0.0f;
+    for (int i = 0; i < io->num_shards; i++) {
+        float f = (float)ring_depth(&ctx->io[i]) / ctx->io[i].capacity;
+        if (f > worst) worst = f;
+    }
+    return worst;
+}
 
-    char msg[128];
-    snprintf(msg, sizeof(msg), "PID %d submitted Q%d%s",
-             pid, question_id, is_partial ? " (PARTIAL/timeout)" : "");
-    log_event("INFO", "IO", msg);
+// Credit signal for submitters and admission: 1.0 = go ahead, shrinking
+// linearly to 0.0 as fill goes from CREDIT_SOFT to full. BLOCK only —
+// under DROP a full buffer already sheds load by itself. Either way an
+// open overload window (INT_OVERLOAD) holds everything at 0.
+float io_buffer_credit(SimContext *ctx) {
+    if (__atomic_load_n(&ctx->state.overload_active, __ATOMIC_RELAXED)) return 0.0f;
+    if (ctx->config.submit_policy != SUBMIT_BLOCK) return 1.0f;
+    float fill = io_buffer_fill(ctx);
+    if (fill <= CREDIT_SOFT) return 1.0f;
+    float credit = (1.0f - fill) / (1.0f - CREDIT_SOFT);
+    return credit > 0.0f ? credit : 0.0f;
+}
 
+int io_buffer_shards(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    return io->num_shards;
+}
+
+void io_buffer_arena_stats(SimContext *ctx, IOArenaStats *out) {
+    IOState *io = ctx->io_state;
+    memset(out, 0, sizeof(IOArenaStats));
+    for (int i = 0; i < io->num_shards; i++) {
+        AnswerArena *a = &ctx->io[i].arena;
+        out->slabs     += arena_slabs(a);
+        out->recycled  += __atomic_load_n(&a->recycled,  __ATOMIC_RELAXED);
+        out->truncated += __atomic_load_n(&a->truncated, __ATOMIC_RELAXED);
+        out->exhausted += __atomic_load_n(&a->exhausted, __ATOMIC_RELAXED);
+        out->bytes     += __atomic_load_n(&a->bytes,     __ATOMIC_RELAXED);
+    }
+}
+
+void io_buffer_submit_stats(SimContext *ctx, IOSubmitStats *out) {
+    IOState *io = ctx->io_state;
+    out->submitted   = __atomic_load_n(&io->submitted, __ATOMIC_RELAXED);
+    out->dropped     = __atomic_load_n(&io->dropped,   __ATOMIC_RELAXED);
+    out->p50_ns      = hist_percentile(&io->submit_hist, 50.0);
+    out->p99_ns      = hist_percentile(&io->submit_hist, 99.0);
+    out->storm_count = io->storm_count;
+    out->storm_ns    = io->storm_ns;
+    out->storm_p99_ns = hist_percentile(&io->storm_hist, 99.0);
+    out->delayed      = __atomic_load_n(&io->delayed, __ATOMIC_RELAXED);
+    out->wait_p50_us  = hist_percentile(&io->wait_hist, 50.0);
+    out->wait_p99_us  = hist_percentile(&io->wait_hist, 99.0);
+    out->wait_max_us  = io->wait_hist.max;
+    out->coalesced    = __atomic_load_n(&io->coalesced, __ATOMIC_RELAXED);
+}
+
+// ─── Grow: double the ring, keeping queued items in order ─
+// Runs on the shard's flusher, its only consumer. Raising `resizing`
+// and waiting for `writers` to drain guarantees every claimed slot is
+// published before the copy, and no producer sees the old ring after.
+static void grow_buffer(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    int old_cap = b->capacity;
+    int new_cap = old_cap * 2;
+    SubmitCell *ring = calloc(new_cap, sizeof(SubmitCell));
+    if (!ring) return;
+
+    if (b->coalesce) pthread_mutex_lock(&b->coalesce_lock);
+    __atomic_store_n(&b->resizing, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&b->writers, __ATOMIC_SEQ_CST) > 0)
+        sched_yield();
+
+    // Positions stay as they are: queued items move to their slot in
+    // the bigger ring, and every other slot is primed for the position
+    // it serves next. enq_pos and deq_pos are never rewritten, so
+    // ring_depth() on another thread can't see a torn pair mid-grow
+    long head  = b->deq_pos;
+    long count = b->enq_pos - head;
+    long mask  = new_cap - 1;
+    for (long p = head; p < head + new_cap; p++) {
+        SubmitCell *cell = &ring[p & mask];
+        if (p < head + count) {
+            cell->sub = b->cells[p & b->mask].sub;
+            cell->seq = p + 1;
+        } else {
+            cell->seq = p;
+        }
+    }
+    free(b->cells);
+    b->cells    = ring;
+    b->capacity = new_cap;
+    b->mask     = mask;
+
+    __atomic_store_n(&b->resizing, 0, __ATOMIC_SEQ_CST);
+    if (b->coalesce) pthread_mutex_unlock(&b->coalesce_lock);
+    wake_space_waiters(b);
+
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.buffer_grows++;
+    pthread_mutex_unlock(&ctx->state.lock);
+    publish_stats(ctx);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "Sustained pressure — shard %d grown %d -> %d slots",
+             b->id, old_cap, new_cap);
+    log_event(ctx, "WARN", "IO", msg);
+}
+
+// Called once per tick: grow after GROW_AFTER_TICKS ticks in a row
+// that were near-full or dropped a submission
+static void check_growth(IOBuffer *b, float fill) {
+    if (b->capacity >= b->max_capacity) return;
+
+    long drops      = __atomic_load_n(&b->drops, __ATOMIC_RELAXED);
+    int  pressured  = fill >= GROW_THRESHOLD || drops > b->last_drops;
+    b->last_drops   = drops;
+    b->pressure_ticks = pressured ? b->pressure_ticks + 1 : 0;
+
+    if (b->pressure_ticks >= GROW_AFTER_TICKS) {
+        grow_buffer(b);
+        b->pressure_ticks = 0;
+    }
+}
+
+// ─── Consumer: claim every published slot at once ────────
+// Single consumer, so deq_pos needs no CAS: scan forward while cells
+// are ready, copy them out, then release the whole run.
+static int ring_pop_batch(IOBuffer *b, Submission *out, int max) {
+    if (b->coalesce) pthread_mutex_lock(&b->coalesce_lock);
+    long pos = b->deq_pos;
+    int  n   = 0;
+
+    while (n < max) {
+        SubmitCell *cell = &b->cells[(pos + n) & b->mask];
+        if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + n + 1) break;
+        out[n++] = cell->sub;
+    }
+    for (int i = 0; i < n; i++) {
+        SubmitCell *cell = &b->cells[(pos + i) & b->mask];
+        __atomic_store_n(&cell->seq, pos + i + b->capacity, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&b->deq_pos, pos + n, __ATOMIC_RELEASE);
+    if (b->coalesce) {
+        coalesce_forget(b, out, pos, n);
+        pthread_mutex_unlock(&b->coalesce_lock);
+    }
+    if (n > 0) wake_space_waiters(b);
+    return n;
+}
+
+// ─── Durability ──────────────────────────────────────────
+// Written submissions wait in b->pending until they are durable: at
+// the sync that covers them, or right after the write under NONE.
+// written_us is filled in once the writev returns
+static void pending_add(IOBuffer *b, const Submission *batch, int n) {
+    if (b->pending_count + n > b->pending_cap) {
+        int cap = b->pending_cap * 2;
+        while (cap < b->pending_count + n) cap *= 2;
+        PendingSync *p = realloc(b->pending, sizeof(PendingSync) * cap);
+        if (!p) return;   // untracked, still written
+        b->pending     = p;
+        b->pending_cap = cap;
+    }
+    for (int i = 0; i < n; i++) {
+        b->pending[b->pending_count].submit_us  = batch[i].submit_us;
+        b->pending[b->pending_count].written_us = 0;
+        b->pending_count++;
+    }
+}
+
+static void pending_complete(IOBuffer *b, long durable_us, int synced) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    for (int i = 0; i < b->pending_count; i++) {
+        if (synced)
+            hist_record(&io->phase_hist[PHASE_SYNC], durable_us - b->pending[i].written_us);
+        hist_record(&io->phase_hist[PHASE_TOTAL], durable_us - b->pending[i].submit_us);
+    }
+    b->pending_count = 0;
+}
+
+// A failed sync leaves what it covered in doubt: those submissions are
+// not durable, so they stay out of the sync and total histograms
+static void sync_disk(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    if (!b->unsynced) return;
+    int failed = 0;
+    if (b->fd != STDERR_FILENO) {
+        long t0 = now_us();
+        int  seg_rc   = fdatasync(b->fd);
+        int  seg_err  = errno;
+        int  store_rc = store_sync(b->store);
+        hist_record(&io->sync_lat_hist, now_us() - t0);
+
+        failed = seg_rc != 0 || store_rc != 0;
+        if (failed) {
+            char msg[160];
+            snprintf(msg, sizeof(msg), "Shard %d sync FAILED (%s): %d submissions not durable",
+                     b->id, seg_rc != 0 ? strerror(seg_err) : "binary store",
+                     b->pending_count);
+            log_event(ctx, "ERROR", "IO", msg);
+        } else {
+            pthread_mutex_lock(&ctx->state.lock);
+            ctx->state.sync_count++;
+            pthread_mutex_unlock(&ctx->state.lock);
+        }
+    }
+    b->last_sync_ms = now_ms();
+    b->unsynced     = 0;
+    if (failed) b->pending_count = 0;
+    else        pending_complete(b, now_us(), 1);
+
+    // The checkpoint lets the WAL drop what it covers, so it only moves
+    // past data a sync has confirmed. After a failed sync, pages it
+    // covered may be gone even if a later sync succeeds: keep every
+    // record from there on for recovery
+    if (failed) b->sync_failed = 1;
+    if (!b->sync_failed) wal_checkpoint(b->wal, b->written_lsn);
+}
+
+// GROUP mode: sync once the oldest unsynced write is group_commit_ms
+// old. NONE with a WAL syncs on the same cadence only so the
+// checkpoint can advance; its latency still ends at the write
+static void group_commit_check(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    int periodic = ctx->config.durability == DURABILITY_GROUP ||
+                   (ctx->config.durability == DURABILITY_NONE && b->wal);
+    if (!periodic || !b->unsynced) return;
+    if (now_ms() - b->last_sync_ms >= ctx->config.group_commit_ms) sync_disk(b);
+}
+
+// writev until every iovec is on disk (or the fd is broken)
+static int write_all(int fd, struct iovec *iov, int cnt) {
+    while (cnt > 0) {
+        ssize_t w = writev(fd, iov, cnt);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (cnt > 0 && (size_t)w >= iov->iov_len) {
+            w -= iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + w;
+            iov->iov_len -= w;
+        }
+    }
     return 0;
 }
 
+// Format n submissions into chunk and append the iovecs covering them.
+// Short answers are copied inline; longer ones (essays) are pointed at
+// in their arena slab, so the chunk never holds more than LINE_BYTES
+// per item. Returns the bytes described.
+static size_t format_batch(IOBuffer *b, char *chunk, const Submission *batch, int n,
+                           struct iovec *iov, int *iovcnt) {
+    char  *seg = chunk, *p = chunk;
+    size_t bytes = 0;
+
+    for (int i = 0; i < n; i++) {
+        const char *text = arena_get(&b->arena, batch[i].answer);
+        int         len  = batch[i].answer.len;
+
+        p += snprintf(p, LINE_BYTES - INLINE_ANSWER - 1, "[%ld ms] PID=%-3d Q=%-2d %s ANSWER=",
+                      batch[i].timestamp, batch[i].pid, batch[i].question_id,
+                      batch[i].is_partial ? "[PARTIAL]" : "        ");
+        if (len <= INLINE_ANSWER) {
+            memcpy(p, text, len);
+            p += len;
+        } else {
+            iov[(*iovcnt)++] = (struct iovec){ seg, (size_t)(p - seg) };
+            iov[(*iovcnt)++] = (struct iovec){ (void *)text, (size_t)len };
+            bytes += (p - seg) + len;
+            seg = p;
+        }
+        *p++ = '\n';
+    }
+    if (p > seg) {
+        iov[(*iovcnt)++] = (struct iovec){ seg, (size_t)(p - seg) };
+        bytes += p - seg;
+    }
+    return bytes;
+}
+
 // ─── Flush batch to disk ──────────────────────────────────
-static int flush_buffer() {
-    pthread_mutex_lock(&g_io_buffer.lock);
-    int count = g_io_buffer.count;
-    pthread_mutex_unlock(&g_io_buffer.lock);
+// Each claimed batch is formatted into one chunk (plus essay iovecs);
+// up to FLUSH_CHUNKS chunks go out in a single writev, followed by the
+// sync the durability mode asks for. With STORE on, each batch is also
+// appended to the shard's binary store before its answers go back to
+// the arena; completions are raised only after the sync.
+// Every submission's queue/format/write time is recorded on the way.
+static int flush_buffer(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    IOState *io = ctx->io_state;
+    struct iovec iov[IOV_LIMIT];
+    long deq_us[FLUSH_CHUNKS];
+    int  chunk_items[FLUSH_CHUNKS];
+    int  flushed = 0, n, failed = 0;
+    long t0 = now_us();
+    long oldest = 0;
 
-    if (count == 0) return 0;
+    do {
+        int    chunks = 0, items = 0, iovcnt = 0;
+        size_t bytes  = 0;
+        long   top_lsn = 0;
+        int    pend_base = b->pending_count;   // this pass's entries start here
+        // A batch needs at most 2 iovecs per item plus one
+        while (chunks < FLUSH_CHUNKS && iovcnt + 2 * FLUSH_BATCH + 1 <= IOV_LIMIT &&
+               (n = ring_pop_batch(b, b->batch, FLUSH_BATCH)) > 0) {
+            deq_us[chunks]      = now_us();
+            chunk_items[chunks] = n;
+            if (flushed == 0 && items == 0) oldest = b->batch[0].timestamp;
+            for (int i = 0; i < n; i++)
+                hist_record(&io->phase_hist[PHASE_QUEUE], deq_us[chunks] - b->batch[i].submit_us);
 
-    int flushed = 0;
-    while (flushed < count) {
-        // Wait for an item
-        if (sem_trywait(&g_io_buffer.filled_slots) != 0) break;
+            char *chunk = b->chunks + (size_t)chunks * FLUSH_BATCH * LINE_BYTES;
+            bytes += format_batch(b, chunk, b->batch, n, iov, &iovcnt);
+            if (b->store) {
+                const char *answers[FLUSH_BATCH];
+                for (int i = 0; i < n; i++) answers[i] = arena_get(&b->arena, b->batch[i].answer);
+                if (store_append(b->store, b->batch, answers, n) != 0) failed += n;
+            }
+            for (int i = 0; i < n; i++) {
+                b->pids[items + i]  = b->batch[i].pid;
+                b->slabs[items + i] = b->batch[i].answer.slab;
+                if (b->batch[i].lsn > top_lsn) top_lsn = b->batch[i].lsn;
+            }
+            pending_add(b, b->batch, n);
+            items += n;
+            chunks++;
+        }
+        if (chunks == 0) break;
 
-        pthread_mutex_lock(&g_io_buffer.lock);
-        Submission s = g_io_buffer.buffer[g_io_buffer.head];
-        g_io_buffer.head  = (g_io_buffer.head + 1) % BUFFER_CAPACITY;
-        g_io_buffer.count--;
+        long w0 = now_us();
+        int  lost = write_all(b->fd, iov, iovcnt) != 0;
+        if (lost) failed += items;
+        else if (top_lsn > b->written_lsn) b->written_lsn = top_lsn;
+        long w1 = now_us();
+        arena_release(&b->arena, b->slabs, items);
 
-        pthread_mutex_lock(&g_state.lock);
-        g_state.buffer_count = g_io_buffer.count;
-        pthread_mutex_unlock(&g_state.lock);
+        for (int c = 0; c < chunks; c++)
+            hist_record_n(&io->phase_hist[PHASE_FORMAT], w0 - deq_us[c], chunk_items[c]);
+        hist_record_n(&io->phase_hist[PHASE_WRITE], w1 - w0, items);
+        if (lost) {
+            // Never durable: no submit-to-durable latency, no completion
+            b->pending_count = pend_base;
+        } else {
+            b->unsynced += (long)bytes;
+            for (int i = b->pending_count - 1; i >= pend_base; i--)
+                b->pending[i].written_us = w1;
+        }
 
-        pthread_mutex_unlock(&g_io_buffer.lock);
-        sem_post(&g_io_buffer.empty_slots);
+        if (ctx->config.durability == DURABILITY_NONE) {
+            // Written is as far as NONE goes: survives a process crash
+            pending_complete(b, w1, 0);
+            group_commit_check(b);
+        }
+        else if (ctx->config.durability == DURABILITY_FDATASYNC) sync_disk(b);
+        else group_commit_check(b);
 
-        // Write to simulated disk
-        fprintf(disk_file, "[%ld ms] PID=%-3d Q=%-2d %s ANSWER=%s\n",
-                s.timestamp, s.pid, s.question_id,
-                s.is_partial ? "[PARTIAL]" : "        ",
-                s.answer);
-        flushed++;
-    }
+        if (!lost)
+            for (int i = 0; i < items; i++)
+                interrupt_raise(ctx, INT_SUBMIT_COMPLETE, b->pids[i]);
+        flushed += items;
+    } while (n > 0);
 
     if (flushed > 0) {
-        fflush(disk_file);
+        hist_record(&io->flush_size_hist, flushed);
+        hist_record(&io->flush_lat_hist, now_us() - t0);
 
-        pthread_mutex_lock(&g_state.lock);
-        g_state.flush_count++;
-        pthread_mutex_unlock(&g_state.lock);
+        // Ring order is submit order, so the first item is the oldest
+        if (now_ms() - oldest > ctx->config.flush_target_ms) {
+            b->late_flushes++;
+            __atomic_store_n(&b->congested, 1, __ATOMIC_RELAXED);
+        }
 
-        char msg[64];
-        snprintf(msg, sizeof(msg), "Flushed %d submissions to disk", flushed);
-        log_event("INFO", "IO", msg);
+        pthread_mutex_lock(&ctx->state.lock);
+        ctx->state.flush_count++;
+        pthread_mutex_unlock(&ctx->state.lock);
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Shard %d flushed %d submissions to disk%s",
+                 b->id, flushed, failed ? " — WRITE FAILED for some" : "");
+        log_event(ctx, failed ? "ERROR" : "INFO", "IO", msg);
     }
+    publish_stats(ctx);
 
     return flushed;
 }
 
-// ─── Demo mode: submission storm ─────────────────────────
-static void trigger_submission_storm() {
-    log_event("WARN", "IO", "SUBMISSION STORM triggered — 30 simultaneous submissions!");
+void io_buffer_flush_stats(SimContext *ctx, IOFlushStats *out) {
+    IOState *io = ctx->io_state;
+    out->size_p50   = hist_percentile(&io->flush_size_hist, 50.0);
+    out->size_p99   = hist_percentile(&io->flush_size_hist, 99.0);
+    out->size_max   = io->flush_size_hist.max;
+    out->lat_p50_us = hist_percentile(&io->flush_lat_hist, 50.0);
+    out->lat_p99_us = hist_percentile(&io->flush_lat_hist, 99.0);
+    out->sync_p99_us = hist_percentile(&io->sync_lat_hist, 99.0);
+    out->threshold_min_pct = io->thr_min_pct <= io->thr_max_pct ? io->thr_min_pct : 0;
+    out->threshold_max_pct = io->thr_max_pct;
+    out->late_flushes = 0;
+    for (int i = 0; i < io->num_shards; i++) out->late_flushes += ctx->io[i].late_flushes;
+}
+
+void io_buffer_phase_stats(SimContext *ctx, IOPhaseStats out[IO_PHASES]) {
+    IOState *io = ctx->io_state;
+    for (int i = 0; i < IO_PHASES; i++) {
+        out[i].count  = io->phase_hist[i].count;
+        out[i].p50_us = hist_percentile(&io->phase_hist[i], 50.0);
+        out[i].p99_us = hist_percentile(&io->phase_hist[i], 99.0);
+        out[i].max_us = io->phase_hist[i].max;
+    }
+}
+
+// Sleep one tick; GROUP mode wakes every group_commit_ms to sync, and
+// a producer blocked on a full ring can kick us into flushing early
+static void tick_sleep(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    int slice = TIME_TICK_MS;
+    if (ctx->config.durability == DURABILITY_GROUP &&
+        ctx->config.group_commit_ms > 0 && ctx->config.group_commit_ms < slice)
+        slice = ctx->config.group_commit_ms;
+
+    long end = now_us() + TIME_TICK_MS * 1000L;
+    long now;
+    while ((now = now_us()) < end) {
+        long wait_us = end - now < slice * 1000L ? end - now : slice * 1000L;
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += wait_us * 1000L;
+        ts.tv_sec  += ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        if (sem_timedwait(&b->kick, &ts) == 0) {
+            while (sem_trywait(&b->kick) == 0) ;   // coalesce kicks
+            if (__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)) return;
+            snapshot_enter(ctx);
+            flush_buffer(b);
+            snapshot_leave(ctx);
+        }
+        group_commit_check(b);
+    }
+}
+
+// ─── Adaptive flush controller ───────────────────────────
+// Arrivals per tick, smoothed; the ring positions count them for free
+static void update_rate(IOBuffer *b) {
+    long enq = __atomic_load_n(&b->enq_pos, __ATOMIC_RELAXED);
+    b->rate     = RATE_ALPHA * (enq - b->last_enq) + (1.0f - RATE_ALPHA) * b->rate;
+    b->last_enq = enq;
+}
+
+// Age of the oldest queued submission, ms (0 if the ring is empty)
+static long oldest_age_ms(IOBuffer *b) {
+    long pos = b->deq_pos;
+    SubmitCell *cell = &b->cells[pos & b->mask];
+    if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != pos + 1) return 0;
+    return now_ms() - cell->sub.timestamp;
+}
+
+// AIMD on the flush threshold. Halve it on congestion: a flush missed
+// flush_target_ms, a submit was dropped or delayed, or two ticks of
+// arrivals would no longer fit above it. Otherwise step it toward the
+// batch one latency budget of arrivals fills — larger batches mean
+// fewer writes — within THRESHOLD_MIN..FLUSH_THRESHOLD.
+static void adapt_threshold(IOBuffer *b) {
+    SimContext *ctx = b->ctx;
+    float budget  = (float)ctx->config.flush_target_ms / TIME_TICK_MS;
+    float desired = b->rate * budget / b->capacity;
+    float ceiling = 1.0f - 2.0f * b->rate / b->capacity;
+    if (desired > FLUSH_THRESHOLD) desired = FLUSH_THRESHOLD;
+    if (desired < THRESHOLD_MIN)   desired = THRESHOLD_MIN;
+
+    if (__atomic_exchange_n(&b->congested, 0, __ATOMIC_RELAXED) ||
+        b->threshold > ceiling)
+        b->threshold *= AIMD_DECREASE;
+    else if (b->threshold < desired)
+        b->threshold += AIMD_STEP;
+    else if (b->threshold > desired + AIMD_STEP)
+        b->threshold -= AIMD_STEP;
+
+    if (b->threshold < THRESHOLD_MIN)   b->threshold = THRESHOLD_MIN;
+    if (b->threshold > FLUSH_THRESHOLD) b->threshold = FLUSH_THRESHOLD;
+}
+
+// FIXED: 80% full or every 15 ticks. ADAPTIVE: the controller's
+// threshold, the oldest item about to miss its target (one tick of
+// slack for the write), or the next two ticks of arrivals not fitting.
+static int flush_due(IOBuffer *b, float fill, int tick) {
+    SimContext *ctx = b->ctx;
+    if (ctx->config.flush_policy == FLUSH_FIXED)
+        return fill >= FLUSH_THRESHOLD || tick % 15 == 0;
+
+    return fill >= b->threshold
+        || oldest_age_ms(b) >= ctx->config.flush_target_ms - TIME_TICK_MS
+        || ring_depth(b) + 2.0f * b->rate >= b->capacity;
+}
+
+// io thread, once per tick: mean threshold for the dashboard plot
+static void record_threshold(SimContext *ctx) {
+    IOState *io = ctx->io_state;
+    float thr = 0.0f, rate = 0.0f;
+    for (int i = 0; i < io->num_shards; i++) {
+        thr  += ctx->io[i].threshold;
+        rate += ctx->io[i].rate;
+    }
+    int pct = (int)(thr / io->num_shards * 100.0f + 0.5f);
+    if (pct < io->thr_min_pct) io->thr_min_pct = pct;
+    if (pct > io->thr_max_pct) io->thr_max_pct = pct;
+
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.flush_threshold_pct = pct;
+    ctx->state.submit_rate         = rate;
+    ctx->state.flush_history[ctx->state.flush_history_len % FLUSH_HISTORY] = pct;
+    ctx->state.flush_history_len++;
+    pthread_mutex_unlock(&ctx->state.lock);
+}
+
+// ─── Shard flusher thread ────────────────────────────────
+// Flushes its ring when flush_due() says so, grows it under sustained
+// pressure, and drains it one last time on shutdown.
+static void *flusher_thread(void *arg) {
+    IOBuffer   *b   = arg;
+    SimContext *ctx = b->ctx;
+    IOState    *io  = ctx->io_state;
+
+    while (!__atomic_load_n(&b->stop, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&ctx->state.lock);
+        int running = ctx->state.simulation_running;
+        int tick    = ctx->state.current_tick;
+        pthread_mutex_unlock(&ctx->state.lock);
+
+        // A snapshot sees the ring and segment between flushes only
+        snapshot_enter(ctx);
+        float fill = (float)ring_depth(b) / b->capacity;
+        check_growth(b, fill);
+        update_rate(b);
+
+        // After the simulation stops, deferred timeout work may still
+        // submit partials: flush every tick until told to stop
+        if (!running || flush_due(b, fill, tick))
+            flush_buffer(b);
+        if (ctx->config.flush_policy == FLUSH_ADAPTIVE) adapt_threshold(b);
+        snapshot_leave(ctx);
+
+        tick_sleep(b);
+    }
+
+    flush_buffer(b);
+    if (ctx->config.durability != DURABILITY_NONE || b->wal) sync_disk(b);
+    if (b->fd >= 0 && b->fd != STDERR_FILENO) close(b->fd);
+
+    // Everything logged is in the segment now: end the log cleanly
+    if (b->wal) {
+        WalStats st;
+        wal_stats(b->wal, &st);
+        wal_close(b->wal);
+        b->wal = NULL;
+        __atomic_add_fetch(&io->wal_totals.records, st.records, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&io->wal_totals.commits, st.commits, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&io->wal_totals.bytes,   st.bytes,   __ATOMIC_RELAXED);
+        long p99 = __atomic_load_n(&io->wal_totals.commit_p99_us, __ATOMIC_RELAXED);
+        while (st.commit_p99_us > p99 &&
+               !__atomic_compare_exchange_n(&io->wal_totals.commit_p99_us, &p99, st.commit_p99_us,
+                                            0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            ;
+    }
+    return NULL;
+}
+
+// ─── Merge: segments → one submissions.txt, in time order ─
+// Segments are each in enqueue order, so a k-way merge on the
+// timestamp prefix rebuilds the single-file view. Usable offline
+// via `./exam_os --merge`.
+typedef struct {
+    FILE  *in;
+    char  *line;         // getline buffer: essays make lines multi-KB
+    size_t cap;
+    long   ts;
+    int    live;
+} SegmentCursor;
+
+// Advance to the next submission line, skipping headers
+static void cursor_next(SegmentCursor *c) {
+    c->live = 0;
+    while (c->in && getline(&c->line, &c->cap, c->in) > 0) {
+        if (sscanf(c->line, "[%ld ms]", &c->ts) == 1) {
+            c->live = 1;
+            return;
+        }
+    }
+}
+
+int io_buffer_merge_segments(const char *out_dir, int shards) {
+    if (shards <= 1) return 0;
+    if (shards > MAX_IO_SHARDS) shards = MAX_IO_SHARDS;
+
+    SegmentCursor seg[MAX_IO_SHARDS];
+    for (int i = 0; i < shards; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/submissions.shard%d.txt", out_dir, i);
+        seg[i].in   = fopen(path, "r");
+        seg[i].line = NULL;
+        seg[i].cap  = 0;
+        cursor_next(&seg[i]);
+    }
+
+    char merged_path[256];
+    snprintf(merged_path, sizeof(merged_path), "%s/" MERGED_FILE, out_dir);
+    int   merged = -1;
+    FILE *out    = fopen(merged_path, "w");
+    if (out) {
+        fprintf(out, "=== EXAM SUBMISSIONS ===\n\n");
+        merged = 0;
+        while (1) {
+            int pick = -1;
+            for (int i = 0; i < shards; i++)
+                if (seg[i].live && (pick < 0 || seg[i].ts < seg[pick].ts)) pick = i;
+            if (pick < 0) break;
+            fputs(seg[pick].line, out);
+            merged++;
+            cursor_next(&seg[pick]);
+        }
+        fclose(out);
+    }
+
+    for (int i = 0; i < shards; i++) {
+        if (seg[i].in) fclose(seg[i].in);
+        free(seg[i].line);
+    }
+    return merged;
+}
+
+// ─── Simulated answers ───────────────────────────────────
+// Question ESSAY_QUESTION is a free-text essay of 1-4 KB; the rest
+// are short answers. want > 0 pads or cuts the text to that many
+// bytes: an essay's drawn length, or the size a replayed trace gives
+#define ESSAY_QUESTION  10
+
+static void compose_answer(Rng *rng, char *out, size_t size, int pid, int question_id,
+                           size_t want) {
+    static const char *words[] = { "process", "thread", "page", "frame", "buffer",
+                                   "deadline", "scheduler", "interrupt", "fault", "quantum" };
+    size_t len = question_id == ESSAY_QUESTION
+                 ? (size_t)snprintf(out, size, "ESSAY_PID%d:", pid)
+                 : (size_t)snprintf(out, size, "ANS_%d", (int)rng_below(rng, 1000));
+    if (want == 0) return;
+    if (want > size - 1) want = size - 1;
+    while (len < want) {
+        len += snprintf(out + len, size - len, " %s", words[rng_below(rng, 10)]);
+    }
+    out[want] = '\0';
+}
 
-    pthread_mutex_lock(&g_state.lock);
-    int count = g_state.process_count;
-    pthread_mutex_unlock(&g_state.lock);
+// ─── Demo mode: submission storm ─────────────────────────
+// Timed so the summary can report storm throughput and tail latency
+static void trigger_submission_storm(SimContext *ctx, int storms) {
+    IOState *io = ctx->io_state;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "SUBMISSION STORM triggered — %d simultaneous submissions!", storms);
+    log_event(ctx, "WARN", "IO", msg);
 
-    int storms = count < 30 ? count : 30;
+    long start = now_ns();
+    io->storm_active = 1;
     for (int i = 0; i < storms; i++) {
         char answer[64];
-        snprintf(answer, sizeof(answer), "ANS_%d_%d", i, rand() % 100);
-        io_buffer_submit(i + 1, rand() % 10 + 1, answer, 0);
+        snprintf(answer, sizeof(answer), "ANS_%d_%d", i, (int)rng_below(&io->storm_rng, 100));
+        io_buffer_submit(ctx, i + 1, rng_below(&io->storm_rng, 9) + 1, answer, 0);
     }
+    io->storm_active = 0;
+    io->storm_ns    = now_ns() - start;
+    io->storm_count = storms;
 }
 
-// ─── I/O flusher thread ───────────────────────────────────
-void *io_buffer_thread(void *arg) {
-    (void)arg;
-    log_event("INFO", "IO", "I/O buffer thread started");
+// ─── Store compactor ──────────────────────────────────────
+// Off the flush path: every COMPACT_TICKS ticks each shard's store
+// rewrites its mostly-overwritten sealed segments.
+static void *compactor_thread(void *arg) {
+    SimContext *ctx = arg;
+    IOState    *io  = ctx->io_state;
+    int tick = -1;
+    while ((tick = tick_clock_wait(ctx, tick)) >= 0) {
+        if (tick % COMPACT_TICKS) continue;
+        for (int i = 0; i < io->num_shards; i++) {
+            if (!store_compact(ctx->io[i].store)) continue;
+            StoreStats st;
+            store_stats(ctx->io[i].store, &st);
+            char msg[112];
+            snprintf(msg, sizeof(msg), "Shard %d store compacted: %ld live keys, %ld segments, %ld KB reclaimed",
+                     i, st.live, st.segments, st.reclaimed_bytes / 1024);
+            log_event(ctx, "INFO", "IO", msg);
+        }
+    }
+    return NULL;
+}
 
-    int storm_triggered = 0;
+// Summed over the closed logs; worst shard's commit p99
+void io_buffer_wal_stats(SimContext *ctx, IOWalStats *out) {
+    IOState *io = ctx->io_state;
+    out->records       = io->wal_totals.records;
+    out->commits       = io->wal_totals.commits;
+    out->bytes         = io->wal_totals.bytes;
+    out->commit_p99_us = io->wal_totals.commit_p99_us;
+    out->failed        = __atomic_load_n(&io->wal_failed, __ATOMIC_RELAXED);
+    out->recovered     = io->recovered;
+    out->recover_ms    = io->recover_ms;
+    out->recovering    = io->recovering;
+}
 
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int running = g_state.simulation_running;
-        int tick    = g_state.current_tick;
-        int count   = g_state.process_count;
-        pthread_mutex_unlock(&g_state.lock);
-
-        if (!running) {
-            // Final flush before exit
-            flush_buffer();
-            break;
-        }
-
-        // Demo mode: trigger submission storm at tick 30
-        if (g_config.demo_mode && tick >= 30 && !storm_triggered && count >= 10) {
-            trigger_submission_storm();
-            storm_triggered = 1;
-        }
-
-        // Simulate random submissions from active processes
-        pthread_mutex_lock(&g_state.lock);
-        int pid     = g_state.running_pid;
-        int prcount = g_state.process_count;
-        pthread_mutex_unlock(&g_state.lock);
-
-        if (pid > 0 && prcount > 0) {
-            // 30% chance a process submits an answer each tick
-            if (rand() % 100 < 30) {
-                char answer[64];
-                snprintf(answer, sizeof(answer), "ANS_%d", rand() % 1000);
-                io_buffer_submit(pid, rand() % 10 + 1, answer, 0);
+void io_buffer_store_stats(SimContext *ctx, StoreStats *out) {
+    IOState *io = ctx->io_state;
+    memset(out, 0, sizeof(StoreStats));
+    for (int i = 0; i < io->num_shards; i++) {
+        StoreStats st;
+        store_stats(ctx->io[i].store, &st);
+        out->records         += st.records;
+        out->live            += st.live;
+        out->segments        += st.segments;
+        out->compactions     += st.compactions;
+        out->reclaimed_bytes += st.reclaimed_bytes;
+    }
+}
+
+// ─── Snapshot ────────────────────────────────────────────
+// Taken with the world stopped: no producer is mid-enqueue and no
+// flusher mid-flush, so each ring holds only published submissions and
+// each segment ends where its last flush left it. Queued answers are
+// saved as text; their arena slabs are rebuilt by re-queueing them.
+void io_buffer_snapshot(SimContext *ctx, SnapWriter *w) {
+    IOState *io = ctx->io_state;
+    long counters[] = { io->submitted, io->dropped, io->delayed, io->coalesced, io->storm_count, io->storm_ns };
+    snap_put(w, counters, sizeof(counters));
+    snap_put(w, &io->storm_triggered, sizeof(io->storm_triggered));
+    snap_put(w, &io->thr_min_pct,     sizeof(io->thr_min_pct));
+    snap_put(w, &io->thr_max_pct,     sizeof(io->thr_max_pct));
+    snap_put(w, &io->submit_hist,     sizeof(io->submit_hist));
+    snap_put(w, &io->storm_hist,      sizeof(io->storm_hist));
+    snap_put(w, &io->flush_size_hist, sizeof(io->flush_size_hist));
+    snap_put(w, &io->flush_lat_hist,  sizeof(io->flush_lat_hist));
+    snap_put(w, &io->sync_lat_hist,   sizeof(io->sync_lat_hist));
+    snap_put(w, &io->wait_hist,       sizeof(io->wait_hist));
+    snap_put(w, io->phase_hist,       sizeof(io->phase_hist));
+    snap_put(w, &io->storm_rng,       sizeof(io->storm_rng));
+    snap_put(w, io->rng,              sizeof(io->rng));
+
+    for (int i = 0; i < io->num_shards; i++) {
+        IOBuffer   *b = &ctx->io[i];
+        struct stat st;
+        io->seg_len[i] = b->fd != STDERR_FILENO && fstat(b->fd, &st) == 0 ? (long)st.st_size : 0;
+
+        snap_put(w, &b->threshold,    sizeof(b->threshold));
+        snap_put(w, &b->rate,         sizeof(b->rate));
+        snap_put(w, &b->late_flushes, sizeof(b->late_flushes));
+        snap_put(w, &b->drops,        sizeof(b->drops));
+
+        long head = b->deq_pos, n = 0;
+        while (n < ring_depth(b) && b->cells[(head + n) & b->mask].seq == head + n + 1)
+            n++;
+        snap_put(w, &n, sizeof(n));
+        for (long k = 0; k < n; k++) {
+            const Submission *q = &b->cells[(head + k) & b->mask].sub;
+            snap_put(w, q, sizeof(*q));
+            snap_put(w, arena_get(&b->arena, q->answer), q->answer.len);
+        }
+    }
+}
+
+// Segments only grow, so the prefixes recorded with the world stopped
+// can be read back while it runs
+void io_buffer_snapshot_segments(SimContext *ctx, SnapWriter *w) {
+    IOState *io = ctx->io_state;
+    char buf[64 * 1024];
+    for (int i = 0; i < io->num_shards; i++) {
+        char path[256];
+        segment_path(ctx, path, sizeof(path), i);
+        snap_put(w, &io->seg_len[i], sizeof(io->seg_len[i]));
+
+        int  fd   = io->seg_len[i] > 0 ? open(path, O_RDONLY) : -1;
+        long done = 0;
+        while (fd >= 0 && done < io->seg_len[i]) {
+            long    want = io->seg_len[i] - done < (long)sizeof(buf) ? io->seg_len[i] - done : (long)sizeof(buf);
+            ssize_t n    = pread(fd, buf, want, done);
+            if (n <= 0) break;
+            snap_put(w, buf, n);
+            done += n;
+        }
+        if (fd >= 0) close(fd);
+        if (done != io->seg_len[i]) w->failed = 1;
+    }
+}
+
+// "[ts ms] PID=p Q=q [PARTIAL] ANSWER=text", as format_batch writes it
+static int parse_line(const char *p, const char *eol, Submission *s, const char **answer) {
+    char   head[96];
+    size_t n = (size_t)(eol - p) < sizeof(head) - 1 ? (size_t)(eol - p) : sizeof(head) - 1;
+    memcpy(head, p, n);
+    head[n] = '\0';
+
+    int off = 0;
+    memset(s, 0, sizeof(*s));
+    if (sscanf(head, "[%ld ms] PID=%d Q=%d %n", &s->timestamp, &s->pid, &s->question_id, &off) != 3 ||
+        off == 0)
+        return -1;
+    if (strncmp(head + off, "[PARTIAL] ", 10) == 0) {
+        s->is_partial = 1;
+        off += 10;
+    }
+    if (strncmp(head + off, "ANSWER=", 7) != 0) return -1;
+    off += 7;
+    *answer       = p + off;
+    s->answer.len = (int)(eol - p - off);
+    return 0;
+}
+
+// The store held exactly the segment's records (one flush writes
+// both), so it is rebuilt from the restored segment, in order
+static long rebuild_store(IOBuffer *b, const char *data, size_t len) {
+    if (!b->store) return 0;
+    Submission  subs[FLUSH_BATCH];
+    const char *answers[FLUSH_BATCH];
+    const char *p = data, *end = data + len;
+    int  n = 0;
+    long total = 0;
+
+    while (p < end) {
+        const char *eol = memchr(p, '\n', end - p);
+        if (!eol) eol = end;
+        if (parse_line(p, eol, &subs[n], &answers[n]) == 0 && ++n == FLUSH_BATCH) {
+            store_append(b->store, subs, answers, n);
+            total += n;
+            n = 0;
+        }
+        p = eol + 1;
+    }
+    if (n > 0) store_append(b->store, subs, answers, n);
+    store_sync(b->store);
+    return total + n;
+}
+
+void io_buffer_restore_segments(SimContext *ctx, SnapReader *r) {
+    IOState *io = ctx->io_state;
+    for (int i = 0; i < io->num_shards && !r->failed; i++) {
+        IOBuffer *b = &ctx->io[i];
+        long      len;
+        snap_get(r, &len, sizeof(len));
+        if (len < 0 || (size_t)len > r->len - r->pos) r->failed = 1;
+        if (r->failed) return;
+        const char *data = r->data + r->pos;
+        r->pos += len;
+
+        struct iovec iov = { (void *)data, (size_t)len };
+        if (b->fd != STDERR_FILENO &&
+            (ftruncate(b->fd, 0) != 0 || lseek(b->fd, 0, SEEK_SET) < 0 ||
+             write_all(b->fd, &iov, 1) != 0 || fdatasync(b->fd) != 0))
+            log_event(ctx, "ERROR", "IO", "Snapshot restore: segment write failed");
+
+        long stored = rebuild_store(b, data, len);
+        if (b->store) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "Shard %d store rebuilt from its segment (%ld records)",
+                     i, stored);
+            log_event(ctx, "INFO", "IO", msg);
+        }
+    }
+}
+
+void io_buffer_restore(SimContext *ctx, SnapReader *r) {
+    IOState *io = ctx->io_state;
+    long counters[6];
+    snap_get(r, counters, sizeof(counters));
+    io->submitted   = counters[0];
+    io->dropped     = counters[1];
+    io->delayed     = counters[2];
+    io->coalesced   = counters[3];
+    io->storm_count = counters[4];
+    io->storm_ns    = counters[5];
+    snap_get(r, &io->storm_triggered, sizeof(io->storm_triggered));
+    snap_get(r, &io->thr_min_pct,     sizeof(io->thr_min_pct));
+    snap_get(r, &io->thr_max_pct,     sizeof(io->thr_max_pct));
+    snap_get(r, &io->submit_hist,     sizeof(io->submit_hist));
+    snap_get(r, &io->storm_hist,      sizeof(io->storm_hist));
+    snap_get(r, &io->flush_size_hist, sizeof(io->flush_size_hist));
+    snap_get(r, &io->flush_lat_hist,  sizeof(io->flush_lat_hist));
+    snap_get(r, &io->sync_lat_hist,   sizeof(io->sync_lat_hist));
+    snap_get(r, &io->wait_hist,       sizeof(io->wait_hist));
+    snap_get(r, io->phase_hist,       sizeof(io->phase_hist));
+    snap_get(r, &io->storm_rng,       sizeof(io->storm_rng));
+    snap_get(r, io->rng,              sizeof(io->rng));
+
+    char text[MAX_ANSWER_BYTES + 1];
+    for (int i = 0; i < io->num_shards && !r->failed; i++) {
+        IOBuffer *b = &ctx->io[i];
+        snap_get(r, &b->threshold,    sizeof(b->threshold));
+        snap_get(r, &b->rate,         sizeof(b->rate));
+        snap_get(r, &b->late_flushes, sizeof(b->late_flushes));
+        snap_get(r, &b->drops,        sizeof(b->drops));
+        b->last_drops = b->drops;
+
+        long n;
+        snap_get(r, &n, sizeof(n));
+        for (long k = 0; k < n && !r->failed; k++) {
+            Submission s;
+            snap_get(r, &s, sizeof(s));
+            if (s.answer.len < 0 || s.answer.len > MAX_ANSWER_BYTES) r->failed = 1;
+            if (r->failed) return;
+            snap_get(r, text, s.answer.len);
+            text[s.answer.len] = '\0';
+            s.submit_us += r->rebase_us;
+            if (requeue(b, &s, text) != 0) count_drops(b, 1);
+        }
+        b->last_enq = b->enq_pos;
+        if (b->wal && wal_wait(b->wal, b->next_lsn) != 0) {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "Snapshot restore: shard %d log failed, queue not durable: %s",
+                     b->id, strerror(wal_error(b->wal)));
+            log_event(ctx, "ERROR", "IO", msg);
+        }
+    }
+    publish_stats(ctx);
+}
+
+// ─── I/O phase: simulated submitters ──────────────────────
+void io_buffer_step(SimContext *ctx, int tick) {
+    IOState *io = ctx->io_state;
+    pthread_mutex_lock(&ctx->state.lock);
+    int count = ctx->state.procs.count;
+    int pid   = ctx->state.running_pid;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    snapshot_enter(ctx);
+    record_threshold(ctx);
+
+    // Demo mode: trigger submission storm at tick 30, or when the
+    // replayed trace has it
+    int storms = 0;
+    if (trace_replaying(ctx))
+        storms = trace_storm(ctx, tick);
+    else if (ctx->config.demo_mode && tick >= 30 && !io->storm_triggered && count >= 10)
+        storms = count < 30 ? count : 30;
+    if (storms > 0) {
+        trace_record(ctx, tick, 0, TRACE_STORM, 0, storms, 0);
+        trigger_submission_storm(ctx, storms);
+        io->storm_triggered = 1;
+    }
+
+    // Simulate random submissions from active processes
+    if (pid > 0 && count > 0) {
+        // 30% chance a process submits an answer each tick, scaled
+        // down by back-pressure credits as the buffer fills. Every
+        // draw is taken up front: throttling, which depends on flush
+        // timing, must not shift this student's later answers. A
+        // replay draws them too and overrides them with the trace, so
+        // the answer text matches the captured run's
+        Rng        *rng = &io->rng[pid - 1];
+        TraceSubmit sub;
+        sub.roll     = rng_below(rng, 100);
+        sub.question = rng_below(rng, 10) + 1;
+        Rng text;
+        rng_seed(&text, rng_next(rng), RNG_SUBMIT, pid);
+        int from_trace = trace_submission(ctx, pid, &sub);
+        if (from_trace == 0) sub.roll = 100;
+        if (sub.question == ESSAY_QUESTION) {
+            int drawn = 1024 + rng_below(&text, 3072);
+            if (from_trace < 0) sub.bytes = drawn;
+        } else if (from_trace < 0) {
+            sub.bytes = 0;
+        }
+
+        if (sub.roll < 30) {
+            // The intent is traced, throttled or not: back-pressure is
+            // policy, and the replay decides it again
+            char answer[MAX_ANSWER_BYTES + 1];
+            compose_answer(&text, answer, sizeof(answer), pid, sub.question, sub.bytes);
+            trace_record(ctx, tick, pid, TRACE_SUBMIT, sub.roll, sub.question,
+                         (int)strlen(answer));
+            if (sub.roll >= 30 * io_buffer_credit(ctx)) {
+                pthread_mutex_lock(&ctx->state.lock);
+                ctx->state.throttled_submissions++;
+                pthread_mutex_unlock(&ctx->state.lock);
+            } else {
+                io_buffer_submit(ctx, pid, sub.question, answer, 0);
             }
         }
+    }
+    snapshot_leave(ctx);
+}
 
-        // Flush if above threshold or every 15 ticks
-        pthread_mutex_lock(&g_io_buffer.lock);
-        float fill = (float)g_io_buffer.count / BUFFER_CAPACITY;
-        pthread_mutex_unlock(&g_io_buffer.lock);
+// ─── I/O thread: I/O phase + shard lifecycle ─────────────
+void *io_buffer_thread(void *arg) {
+    SimContext *ctx = arg;
+    IOState    *io  = ctx->io_state;
+    log_event(ctx, "INFO", "IO", "I/O buffer thread started");
 
-        if (fill >= FLUSH_THRESHOLD || tick % 15 == 0)
-            flush_buffer();
+    for (int i = 0; i < io->num_shards; i++)
+        pthread_create(&ctx->io[i].flusher, NULL, flusher_thread, &ctx->io[i]);
+    pthread_t compactor;
+    if (ctx->config.store_enabled) pthread_create(&compactor, NULL, compactor_thread, ctx);
 
-        usleep(TIME_TICK_MS * 1000);
+    // Under RUNTIME = REACTOR the event loop runs the I/O phase and
+    // this thread only owns the shards' lifecycle
+    int tick = -1;
+    while (ctx->config.runtime == RUNTIME_THREADS &&
+           (tick = tick_phase_begin(ctx, TICK_IO, tick)) >= 0) {
+        io_buffer_step(ctx, tick);
+        tick_phase_end(ctx, TICK_IO);
     }
 
-    if (disk_file && disk_file != stderr) fclose(disk_file);
-    log_event("INFO", "IO", "I/O buffer thread exiting");
+    // Keep the flushers up until io_buffer_shutdown(): deferred
+    // timeout work may still submit partials after the last tick
+    while (sem_wait(&io->shutdown) != 0 && errno == EINTR) ;
+
+    if (ctx->config.store_enabled) pthread_join(compactor, NULL);
+
+    // Final drain: every shard flushes, syncs and closes its segment
+    for (int i = 0; i < io->num_shards; i++) {
+        __atomic_store_n(&ctx->io[i].stop, 1, __ATOMIC_RELEASE);
+        sem_post(&ctx->io[i].kick);
+    }
+    for (int i = 0; i < io->num_shards; i++)
+        pthread_join(ctx->io[i].flusher, NULL);
+    publish_stats(ctx);
+
+    if (io->num_shards > 1) {
+        int merged = io_buffer_merge_segments(ctx->config.output_dir, io->num_shards);
+        char msg[256];
+        snprintf(msg, sizeof(msg), "Merged %d shard segments into %s/" MERGED_FILE " (%d submissions)",
+                 io->num_shards, ctx->config.output_dir, merged);
+        log_event(ctx, merged < 0 ? "ERROR" : "INFO", "IO", msg);
+    }
+
+    log_event(ctx, "INFO", "IO", "I/O buffer thread exiting");
     return NULL;
-}
\ No newline at end of file
+}
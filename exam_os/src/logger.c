@@ -3,15 +3,27 @@
 #include <string.h>
 #include <time.h>
 #include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
 #include "logger.h"
+#include "admission.h"
+#include "interrupt.h"
+#include "io_buffer.h"
+#include "snapshot.h"
+#include "tick_clock.h"
+#include "reactor.h"
+#include "trace.h"
 
 // ─── Internal log queue ──────────────────────────────────
-static LogEntry   log_queue[MAX_LOG_QUEUE];
-static int        q_head = 0, q_tail = 0, q_count = 0;
-static pthread_mutex_t q_lock = PTHREAD_MUTEX_INITIALIZER;
-static sem_t           q_ready;
-static FILE           *log_file = NULL;
-static int             logger_running = 1;
+typedef struct Logger {
+    LogEntry        log_queue[MAX_LOG_QUEUE];
+    int             q_head, q_tail, q_count;
+    pthread_mutex_t q_lock;
+    sem_t           q_ready;
+    int             notify_fd;     // RUNTIME = REACTOR: eventfd instead of q_ready
+    FILE           *log_file;
+    int             running;
+} Logger;
 
 // ─── Get nanosecond timestamp ────────────────────────────
 static long get_timestamp_ns() {
@@ -20,118 +32,392 @@ static long get_timestamp_ns() {
     return ts.tv_sec * 1000000000L + ts.tv_nsec;
 }
 
-void logger_init() {
-    sem_init(&q_ready, 0, 0);
-    log_file = fopen("output/system_log.txt", "w");
-    if (!log_file) {
+void logger_init(SimContext *ctx) {
+    Logger *lg = calloc(1, sizeof(Logger));
+    ctx->logger = lg;
+    pthread_mutex_init(&lg->q_lock, NULL);
+    sem_init(&lg->q_ready, 0, 0);
+    lg->notify_fd = -1;
+    lg->running   = 1;
+
+    char path[192];
+    snprintf(path, sizeof(path), "%s/system_log.txt", ctx->config.output_dir);
+    lg->log_file = fopen(path, "w");
+    if (!lg->log_file) {
         fprintf(stderr, "WARNING: Could not open log file. Logging to stderr.\n");
-        log_file = stderr;
+        lg->log_file = stderr;
     }
-    fprintf(log_file, "=== EXAM OS SIMULATION LOG ===\n\n");
-    fflush(log_file);
+    fprintf(lg->log_file, "=== EXAM OS SIMULATION LOG ===\n\n");
+    fflush(lg->log_file);
+}
+
+void logger_shutdown(SimContext *ctx) {
+    ctx->logger->running = 0;
+    sem_post(&ctx->logger->q_ready);  // wake thread so it can exit
+}
+
+// Before any thread logs: the reactor drains the queue instead of
+// the logger thread
+void logger_notify_fd(SimContext *ctx, int fd) {
+    ctx->logger->notify_fd = fd;
 }
 
-void logger_shutdown() {
-    logger_running = 0;
-    sem_post(&q_ready);  // wake thread so it can exit
+// After the logger thread (or the reactor) has been joined
+void logger_destroy(SimContext *ctx) {
+    Logger *lg = ctx->logger;
+    if (!lg) return;
+    if (lg->log_file && lg->log_file != stderr) fclose(lg->log_file);
+    sem_destroy(&lg->q_ready);
+    pthread_mutex_destroy(&lg->q_lock);
+    free(lg);
+    ctx->logger = NULL;
 }
 
 // Called by any module — thread safe
-void log_event(const char *level, const char *subsystem, const char *message) {
-    pthread_mutex_lock(&q_lock);
+void log_event(SimContext *ctx, const char *level, const char *subsystem, const char *message) {
+    Logger *lg = ctx->logger;
+    pthread_mutex_lock(&lg->q_lock);
 
-    if (q_count < MAX_LOG_QUEUE) {
-        LogEntry *e = &log_queue[q_tail];
+    if (lg->q_count < MAX_LOG_QUEUE) {
+        LogEntry *e = &lg->log_queue[lg->q_tail];
         e->timestamp_ns = get_timestamp_ns();
         strncpy(e->level,     level,     sizeof(e->level)     - 1);
         strncpy(e->subsystem, subsystem, sizeof(e->subsystem) - 1);
         strncpy(e->message,   message,   sizeof(e->message)   - 1);
 
-        q_tail = (q_tail + 1) % MAX_LOG_QUEUE;
-        q_count++;
-        sem_post(&q_ready);
+        lg->q_tail = (lg->q_tail + 1) % MAX_LOG_QUEUE;
+        lg->q_count++;
+        if (lg->notify_fd >= 0) {
+            uint64_t one = 1;
+            // Fails only with the counter saturated: a wakeup is pending
+            ssize_t n = write(lg->notify_fd, &one, sizeof(one));
+            (void)n;
+        } else {
+            sem_post(&lg->q_ready);
+        }
     }
     // if queue full, silently drop (never block the caller)
 
-    pthread_mutex_unlock(&q_lock);
+    pthread_mutex_unlock(&lg->q_lock);
 
     // Also update dashboard recent logs
-    pthread_mutex_lock(&g_state.lock);
-    int idx = g_state.log_index % 3;
-    snprintf(g_state.recent_logs[idx], 255, "[%-9s] %-11s %s", level, subsystem, message);
-    g_state.log_index++;
-    pthread_mutex_unlock(&g_state.lock);
+    SystemState *state = &ctx->state;
+    pthread_mutex_lock(&state->lock);
+    int idx = state->log_index % 3;
+    snprintf(state->recent_logs[idx], 255, "[%-9s] %-11s %s", level, subsystem, message);
+    state->log_index++;
+    pthread_mutex_unlock(&state->lock);
+}
+
+static void write_entry(Logger *lg, const LogEntry *e) {
+    long ms = e->timestamp_ns / 1000000;
+    fprintf(lg->log_file, "[%8ld ms] [%-5s] [%-10s] %s\n",
+            ms, e->level, e->subsystem, e->message);
+}
+
+// Reactor: write out everything queued so far, one flush per batch
+void logger_drain(SimContext *ctx) {
+    Logger *lg = ctx->logger;
+    int wrote = 0;
+    while (1) {
+        pthread_mutex_lock(&lg->q_lock);
+        if (lg->q_count == 0) {
+            pthread_mutex_unlock(&lg->q_lock);
+            break;
+        }
+        LogEntry e = lg->log_queue[lg->q_head];
+        lg->q_head = (lg->q_head + 1) % MAX_LOG_QUEUE;
+        lg->q_count--;
+        pthread_mutex_unlock(&lg->q_lock);
+
+        if (lg->log_file) write_entry(lg, &e);
+        wrote = 1;
+    }
+    if (wrote && lg->log_file) fflush(lg->log_file);
 }
 
 // Runs in its own thread — drains queue and writes to file
 void *logger_thread(void *arg) {
-    (void)arg;
+    SimContext *ctx = arg;
+    Logger     *lg  = ctx->logger;
 
     while (1) {
-        sem_wait(&q_ready);
+        sem_wait(&lg->q_ready);
 
-        if (!logger_running && q_count == 0) break;
+        if (!lg->running && lg->q_count == 0) break;
 
-        pthread_mutex_lock(&q_lock);
-        if (q_count == 0) {
-            pthread_mutex_unlock(&q_lock);
+        pthread_mutex_lock(&lg->q_lock);
+        if (lg->q_count == 0) {
+            pthread_mutex_unlock(&lg->q_lock);
             continue;
         }
 
-        LogEntry e = log_queue[q_head];
-        q_head = (q_head + 1) % MAX_LOG_QUEUE;
-        q_count--;
-        pthread_mutex_unlock(&q_lock);
+        LogEntry e = lg->log_queue[lg->q_head];
+        lg->q_head = (lg->q_head + 1) % MAX_LOG_QUEUE;
+        lg->q_count--;
+        pthread_mutex_unlock(&lg->q_lock);
 
         // Write to file
-        long ms = e.timestamp_ns / 1000000;
-        fprintf(log_file, "[%8ld ms] [%-5s] [%-10s] %s\n",
-                ms, e.level, e.subsystem, e.message);
-        fflush(log_file);
+        write_entry(lg, &e);
+        fflush(lg->log_file);
     }
 
-    if (log_file && log_file != stderr) fclose(log_file);
+    if (lg->log_file && lg->log_file != stderr) fclose(lg->log_file);
+    lg->log_file = NULL;
     return NULL;
 }
 
+// Latency as ms: one decimal below 100 ms, whole ms above
+static void format_ms(char *out, size_t len, long us) {
+    if (us < 100000) snprintf(out, len, "%.1f", us / 1000.0);
+    else             snprintf(out, len, "%ld", us / 1000);
+}
+
 // Called at simulation end
-void logger_write_report() {
-    FILE *f = fopen("output/summary.txt", "w");
+void logger_write_report(SimContext *ctx) {
+    char path[192];
+    snprintf(path, sizeof(path), "%s/summary.txt", ctx->config.output_dir);
+    FILE *f = fopen(path, "w");
     if (!f) return;
 
-    pthread_mutex_lock(&g_state.lock);
+    SystemState  *state = &ctx->state;
+    const Config *cfg   = &ctx->config;
+    pthread_mutex_lock(&state->lock);
 
-    int total = g_state.page_faults + g_state.page_hits;
+    int total = state->page_faults + state->page_hits;
     float hit_rate = total > 0
-        ? (float)g_state.page_hits / total * 100.0f
+        ? (float)state->page_hits / total * 100.0f
         : 0.0f;
+    char line[64];
 
     fprintf(f, "╔══════════════════════════════════════════╗\n");
     fprintf(f, "║       EXAM OS SIMULATION REPORT          ║\n");
     fprintf(f, "╠══════════════════════════════════════════╣\n");
     fprintf(f, "║ CPU                                      ║\n");
-    fprintf(f, "║   Context Switches  : %-18d ║\n", g_state.context_switches);
-    fprintf(f, "║   Completed Exams   : %-18d ║\n", g_state.completed_processes);
-    fprintf(f, "║   Timeouts Fired    : %-18d ║\n", g_state.timeouts_fired);
+    fprintf(f, "║   Context Switches  : %-18d ║\n", state->context_switches);
+    fprintf(f, "║   Completed Exams   : %-18d ║\n", state->completed_processes);
+    fprintf(f, "║   Timeouts Fired    : %-18d ║\n", state->timeouts_fired);
+    fprintf(f, "║   Timeout Batches   : %-18d ║\n", state->timeout_batches);
+    snprintf(line, sizeof(line), "%d exams / %ldus",
+             state->timeout_batch_max, state->timeout_batch_max_us);
+    fprintf(f, "║   Largest Storm     : %-18s ║\n", line);
+    snprintf(line, sizeof(line), "%ld / %ld us",
+             hist_percentile(interrupt_timeout_batch_hist(ctx), 50.0),
+             hist_percentile(interrupt_timeout_batch_hist(ctx), 99.0));
+    fprintf(f, "║   Batch p50 / p99   : %-18s ║\n", line);
+    fprintf(f, "╠══════════════════════════════════════════╣\n");
+    fprintf(f, ctx->reactor ? "║ CLOCK (epoll reactor)                    ║\n"
+                            : "║ CLOCK (lockstep phases)                  ║\n");
+    TickClockStats ck;
+    tick_clock_stats(ctx, &ck);
+    fprintf(f, "║   Ticks Run         : %-18ld ║\n", ck.ticks);
+    fprintf(f, "║   Seed              : %-18llu ║\n", (unsigned long long)ctx->config.seed);
+    snprintf(line, sizeof(line), "%ld (max %ld us)", ck.overruns, ck.max_lag_us);
+    fprintf(f, "║   Overran Deadline  : %-18s ║\n", line);
+    snprintf(line, sizeof(line), "%ld / %ld us", ck.busy_p50_us, ck.busy_p99_us);
+    fprintf(f, "║   Tick Busy p50/p99 : %-18s ║\n", line);
+    if (ctx->reactor) {
+        ReactorStats rs;
+        reactor_stats(ctx, &rs);
+        snprintf(line, sizeof(line), "%ld (%ld log)", rs.wakeups, rs.log_events);
+        fprintf(f, "║   Loop Wakeups      : %-18s ║\n", line);
+        fprintf(f, "║   Ticks Folded      : %-18ld ║\n", rs.missed_ticks);
+    }
+    for (int p = 0; p < TICK_PHASES; p++) {
+        snprintf(line, sizeof(line), "%ld us", ck.phase_p99_us[p]);
+        fprintf(f, "║     %-10s p99  : %-18s ║\n", tick_phase_name(p), line);
+    }
+    TraceStats tr;
+    trace_stats(ctx, &tr);
+    if (tr.capturing || tr.replaying) {
+        fprintf(f, "╠══════════════════════════════════════════╣\n");
+        fprintf(f, tr.replaying ? "║ TRACE (replay)                           ║\n"
+                                : "║ TRACE (capture)                          ║\n");
+        if (tr.replaying) {
+            fprintf(f, "║   Events Replayed   : %-18ld ║\n", tr.replayed);
+            fprintf(f, "║   Fallback Ticks    : %-18ld ║\n", tr.fallback_ticks);
+        }
+        if (tr.capturing)
+            fprintf(f, "║   Events Captured   : %-18ld ║\n", tr.captured);
+    }
+    fprintf(f, "╠══════════════════════════════════════════╣\n");
+    fprintf(f, "║ LOGINS                                   ║\n");
+    fprintf(f, "║   Arrived           : %-18d ║\n", state->logins_arrived);
+    fprintf(f, "║   Admitted          : %-18d ║\n", state->logins_admitted);
+    fprintf(f, "║   Still Queued      : %-18d ║\n", state->login_queue_len);
+    snprintf(line, sizeof(line), "%ld / %ld ticks",
+             hist_percentile(admission_wait_hist(ctx), 50.0),
+             hist_percentile(admission_wait_hist(ctx), 99.0));
+    fprintf(f, "║   Wait p50 / p99    : %-18s ║\n", line);
+    snprintf(line, sizeof(line), "%d ticks", state->login_wait_max);
+    fprintf(f, "║   Wait max          : %-18s ║\n", line);
     fprintf(f, "╠══════════════════════════════════════════╣\n");
     fprintf(f, "║ MEMORY                                   ║\n");
-    fprintf(f, "║   Page Faults       : %-18d ║\n", g_state.page_faults);
-    fprintf(f, "║   Page Hits         : %-18d ║\n", g_state.page_hits);
+    fprintf(f, "║   Page Faults       : %-18d ║\n", state->page_faults);
+    fprintf(f, "║   Page Hits         : %-18d ║\n", state->page_hits);
     fprintf(f, "║   Hit Rate          : %-17.1f%% ║\n", hit_rate);
+    fprintf(f, "║   Dirty Write-backs : %-18d ║\n", state->dirty_evictions);
     fprintf(f, "╠══════════════════════════════════════════╣\n");
     fprintf(f, "║ I/O BUFFER                               ║\n");
-    fprintf(f, "║   Total Submissions : %-18d ║\n", g_state.total_submissions);
-    fprintf(f, "║   Dropped           : %-18d ║\n", g_state.dropped_submissions);
-    fprintf(f, "║   Flush Count       : %-18d ║\n", g_state.flush_count);
+    snprintf(line, sizeof(line), "%d (grew %dx)",
+             state->buffer_capacity, state->buffer_grows);
+    fprintf(f, "║   Capacity          : %-18s ║\n", line);
+    fprintf(f, "║   Total Submissions : %-18d ║\n", state->total_submissions);
+    fprintf(f, "║   Dropped           : %-18d ║\n", state->dropped_submissions);
+    fprintf(f, "║   Flush Count       : %-18d ║\n", state->flush_count);
+    IOFlushStats fl;
+    io_buffer_flush_stats(ctx, &fl);
+    snprintf(line, sizeof(line), "%ld / %ld (max %ld)",
+             fl.size_p50, fl.size_p99, fl.size_max);
+    fprintf(f, "║   Flush Size p50/p99: %-18s ║\n", line);
+    snprintf(line, sizeof(line), "%ld / %ld us", fl.lat_p50_us, fl.lat_p99_us);
+    fprintf(f, "║   Flush p50 / p99   : %-18s ║\n", line);
+    if (cfg->flush_policy == FLUSH_ADAPTIVE) {
+        snprintf(line, sizeof(line), "ADAPTIVE, %d ms", cfg->flush_target_ms);
+        fprintf(f, "║   Flush Policy      : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%d%% .. %d%%",
+                 fl.threshold_min_pct, fl.threshold_max_pct);
+        fprintf(f, "║   Threshold Range   : %-18s ║\n", line);
+        fprintf(f, "║   Late Flushes      : %-18ld ║\n", fl.late_flushes);
+    }
+    const char *durability[] = { "NONE", "FDATASYNC", "GROUP" };
+    snprintf(line, sizeof(line), "%s, %d syncs", durability[cfg->durability],
+             state->sync_count);
+    fprintf(f, "║   Durability        : %-18s ║\n", line);
+    if (state->sync_count > 0) {
+        snprintf(line, sizeof(line), "%ld us", fl.sync_p99_us);
+        fprintf(f, "║   fdatasync p99     : %-18s ║\n", line);
+    }
+    IOSubmitStats io;
+    io_buffer_submit_stats(ctx, &io);
+    if (cfg->submit_policy == SUBMIT_BLOCK) {
+        fprintf(f, "║   Delayed (blocked) : %-18ld ║\n", io.delayed);
+        snprintf(line, sizeof(line), "%ld / %ld / %ld",
+                 io.wait_p50_us, io.wait_p99_us, io.wait_max_us);
+        fprintf(f, "║   Wait p50/p99/max  : %-15s us ║\n", line);
+    }
+    // Credits throttle under BLOCK, and under any policy while an
+    // overload window is open
+    if (cfg->submit_policy == SUBMIT_BLOCK || state->overload_signals > 0) {
+        fprintf(f, "║   Throttled Submits : %-18d ║\n", state->throttled_submissions);
+        fprintf(f, "║   Held Login-Ticks  : %-18d ║\n", state->throttled_logins);
+    }
+    if (io.p99_ns >= 1000000)   // waiting on WAL commits
+        snprintf(line, sizeof(line), "%ld / %ld us", io.p50_ns / 1000, io.p99_ns / 1000);
+    else
+        snprintf(line, sizeof(line), "%ld / %ld ns", io.p50_ns, io.p99_ns);
+    fprintf(f, "║   Submit p50 / p99  : %-18s ║\n", line);
+    if (cfg->coalesce)
+        fprintf(f, "║   Coalesced Writes  : %-18ld ║\n", io.coalesced);
+    IOArenaStats ar;
+    io_buffer_arena_stats(ctx, &ar);
+    snprintf(line, sizeof(line), "%ld KB in %ld slabs", ar.bytes / 1024, ar.slabs);
+    fprintf(f, "║   Answer Text       : %-18s ║\n", line);
+    snprintf(line, sizeof(line), "%ld recycled", ar.recycled);
+    fprintf(f, "║   Arena Slabs       : %-18s ║\n", line);
+    if (ar.truncated > 0 || ar.exhausted > 0) {
+        snprintf(line, sizeof(line), "%ld cut, %ld dropped", ar.truncated, ar.exhausted);
+        fprintf(f, "║   Arena Overflow    : %-18s ║\n", line);
+    }
+    if (cfg->store_enabled) {
+        StoreStats st;
+        io_buffer_store_stats(ctx, &st);
+        snprintf(line, sizeof(line), "%ld / %ld keys", st.records, st.live);
+        fprintf(f, "║   Store Records     : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%ld segs, %ld compacts", st.segments, st.compactions);
+        fprintf(f, "║   Store Segments    : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%ld KB", st.reclaimed_bytes / 1024);
+        fprintf(f, "║   Store Reclaimed   : %-18s ║\n", line);
+    }
+    IOWalStats wal;
+    io_buffer_wal_stats(ctx, &wal);
+    if (cfg->wal_enabled) {
+        snprintf(line, sizeof(line), "%ld in %ld commits", wal.records, wal.commits);
+        fprintf(f, "║   WAL Records       : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%ld us", wal.commit_p99_us);
+        fprintf(f, "║   WAL Commit p99    : %-18s ║\n", line);
+        if (wal.failed > 0)
+            fprintf(f, "║   WAL Failed        : %-18ld ║\n", wal.failed);
+    }
+    if (wal.recovering) {
+        snprintf(line, sizeof(line), "%ld in %ld ms", wal.recovered, wal.recover_ms);
+        fprintf(f, "║   Crash Recovery    : %-18s ║\n", line);
+    }
+    if (io.storm_count > 0) {
+        snprintf(line, sizeof(line), "%ld in %ldus", io.storm_count, io.storm_ns / 1000);
+        fprintf(f, "║   Storm             : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%.0f/s",
+                 io.storm_ns > 0 ? io.storm_count * 1e9 / io.storm_ns : 0.0);
+        fprintf(f, "║   Storm Throughput  : %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%ld ns", io.storm_p99_ns);
+        fprintf(f, "║   Storm Submit p99  : %-18s ║\n", line);
+    }
+    fprintf(f, "╠══════════════════════════════════════════╣\n");
+    fprintf(f, "║ DURABILITY LATENCY (ms, p50/p99/max)     ║\n");
+    IOPhaseStats ph[IO_PHASES];
+    io_buffer_phase_stats(ctx, ph);
+    const char *phase_names[IO_PHASES] = {
+        "Queue           ", "Format          ", "Write           ",
+        "Sync            ", "Submit->Durable "
+    };
+    for (int i = 0; i < IO_PHASES; i++) {
+        char p50[24], p99[24], max[24], row[80];
+        format_ms(p50, sizeof(p50), ph[i].p50_us);
+        format_ms(p99, sizeof(p99), ph[i].p99_us);
+        format_ms(max, sizeof(max), ph[i].max_us);
+        if (ph[i].count > 0)
+            snprintf(row, sizeof(row), "%s / %s / %s", p50, p99, max);
+        else
+            snprintf(row, sizeof(row), "n/a");
+        fprintf(f, "║   %s  : %-18s ║\n", phase_names[i], row);
+    }
     fprintf(f, "╠══════════════════════════════════════════╣\n");
     fprintf(f, "║ INTERRUPTS                               ║\n");
-    fprintf(f, "║   Overload Signals  : %-18d ║\n", g_state.overload_signals);
+    fprintf(f, "║   Overload Signals  : %-18d ║\n", state->overload_signals);
+    fprintf(f, "║   Coalesced Raises  : %-18d ║\n", state->int_coalesced);
+    fprintf(f, "║   Queue Overflows   : %-18d ║\n", state->int_overflows);
+    fprintf(f, "║   Timeouts Re-armed : %-18d ║\n", state->int_timeout_overflows);
+    fprintf(f, "║   Preemptions       : %-18d ║\n", state->int_preemptions);
+    fprintf(f, "╠══════════════════════════════════════════╣\n");
+    fprintf(f, "║ INTERRUPT VECTORS  (latency p50 / p99 µs)║\n");
+    for (int id = 0; id < MAX_INTERRUPTS; id++) {
+        InterruptStats st;
+        interrupt_vector_stats(ctx, id, &st);
+        if (st.raised == 0) continue;
+
+        const Histogram *d = interrupt_dispatch_hist(ctx, id);
+        const Histogram *b = interrupt_bh_hist(ctx, id);
+        snprintf(line, sizeof(line), "%ld handled", st.handled);
+        fprintf(f, "║   %-15.15s L%d: %-18s ║\n",
+                interrupt_name(ctx, id), st.priority, line);
+        snprintf(line, sizeof(line), "%ld / %ld", st.coalesced, st.overflows);
+        fprintf(f, "║     coalesced / lost: %-18s ║\n", line);
+        snprintf(line, sizeof(line), "%ld / %ld",
+                 hist_percentile(d, 50.0), hist_percentile(d, 99.0));
+        fprintf(f, "║     dispatch        : %-18s ║\n", line);
+        if (b->count == 0) continue;
+        snprintf(line, sizeof(line), "%ld / %ld",
+                 hist_percentile(b, 50.0), hist_percentile(b, 99.0));
+        fprintf(f, "║     bottom half     : %-18s ║\n", line);
+    }
+    SnapshotStats snap;
+    snapshot_stats(ctx, &snap);
+    if (snap.taken > 0 || snap.restored_tick >= 0) {
+        fprintf(f, "╠══════════════════════════════════════════╣\n");
+        fprintf(f, "║ SNAPSHOTS                                ║\n");
+        if (snap.restored_tick >= 0)
+            fprintf(f, "║   Restored From Tick: %-18d ║\n", snap.restored_tick);
+        snprintf(line, sizeof(line), "%ld, last tick %d", snap.taken, snap.last_tick);
+        fprintf(f, "║   Taken             : %-18s ║\n", snap.taken > 0 ? line : "0");
+        if (snap.taken > 0) {
+            snprintf(line, sizeof(line), "%ld / %ld us", snap.pause_p50_us, snap.pause_max_us);
+            fprintf(f, "║   Pause p50 / max   : %-18s ║\n", line);
+            snprintf(line, sizeof(line), "%ld KB, p99 %ld ms", snap.last_bytes / 1024, snap.write_p99_ms);
+            fprintf(f, "║   Size / Write      : %-18s ║\n", line);
+        }
+    }
     fprintf(f, "╚══════════════════════════════════════════╝\n");
 
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_unlock(&state->lock);
     fclose(f);
-
-    // Print to terminal too
-    printf("\n");
-    system("cat output/summary.txt");
 }
\ No newline at end of file
@@ -2,47 +2,41 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <pthread.h>
 #include <time.h>
 #include "shared.h"
 #include "config.h"
-#include "logger.h"
-#include "scheduler.h"
-#include "memory.h"
+#include "sim.h"
+#include "sweep.h"
 #include "io_buffer.h"
-#include "interrupt.h"
-#include "dashboard.h"
-
-// ─── Global instances ─────────────────────────────────────
-SystemState g_state;
-IOBuffer    g_io_buffer;
-Config      g_config;
-
-// ─── Init global state ────────────────────────────────────
-static void state_init() {
-    memset(&g_state, 0, sizeof(SystemState));
-    g_state.running_pid        = -1;
-    g_state.simulation_running =  1;
-    g_state.current_tick       =  0;
-    for (int i = 0; i < 3; i++)
-        strncpy(g_state.recent_logs[i], "--- no events yet ---", 255);
-    pthread_mutex_init(&g_state.lock, NULL);
-}
-
-// ─── Simulation tick thread ───────────────────────────────
-// Central clock — increments tick every TIME_TICK_MS
-static void *tick_thread(void *arg) {
-    (void)arg;
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int running = g_state.simulation_running;
-        if (running) g_state.current_tick++;
-        pthread_mutex_unlock(&g_state.lock);
-
-        if (!running) break;
-        usleep(TIME_TICK_MS * 1000);
+#include "submission_store.h"
+#include "snapshot.h"
+#include "bench.h"
+#include "rng.h"
+#include "trace.h"
+
+// ─── --lookup PID QID: latest answer from the binary store ─
+static int lookup_submission(const Config *cfg, int pid, int qid) {
+    char dir[256];
+    io_buffer_store_dir(cfg, pid, dir, sizeof(dir));
+
+    StoreReader r;
+    if (store_reader_open(&r, dir) != 0) {
+        fprintf(stderr, "  No submission store at %s (run with STORE = ON)\n", dir);
+        return 1;
     }
-    return NULL;
+    StoreRecord rec;
+    int rc = store_lookup(&r, pid, qid, &rec);
+    if (rc == 0) {
+        printf("  PID=%d Q=%d%s at %ld ms (seq %lu%s)\n  ANSWER=%.*s\n",
+               rec.pid, rec.question_id, rec.is_partial ? " [PARTIAL]" : "",
+               (long)rec.timestamp, (unsigned long)rec.seq,
+               r.rebuilt ? ", index rebuilt" : "", rec.len, rec.answer);
+    } else {
+        printf("  PID=%d Q=%d: %s\n", pid, qid,
+               rc == -1 ? "no submission" : "record failed its CRC check");
+    }
+    store_reader_close(&r);
+    return rc == 0 ? 0 : 1;
 }
 
 // ─── Print startup banner ─────────────────────────────────
@@ -54,103 +48,116 @@ static void print_banner() {
     printf("  ╚═══════════════════════════════════════════╝\n\n");
 }
 
+// ─── Print <output_dir>/summary.txt ───────────────────────
+static void print_summary(const char *out_dir) {
+    char path[256], line[512];
+    snprintf(path, sizeof(path), "%s/summary.txt", out_dir);
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    while (fgets(line, sizeof(line), f)) fputs(line, stdout);
+    fclose(f);
+}
+
 int main(int argc, char *argv[]) {
-    srand(time(NULL));
+    // ─── Load config ──────────────────────────────────────
+    Config cfg;
+    config_load_defaults(&cfg);
+    config_parse_file(&cfg, "config.conf");
+    config_parse_args(&cfg, argc, argv);
+
+    // Its stdout is a trace file: nothing else may go there
+    if (cfg.trace_dump[0])
+        return trace_dump(cfg.trace_dump) == 0 ? 0 : 1;
+
+    if (config_check(&cfg) != 0) return 1;
 
     print_banner();
 
-    // ─── Load config ──────────────────────────────────────
-    config_load_defaults(&g_config);
-    config_parse_file(&g_config, "config.conf");
-    config_parse_args(&g_config, argc, argv);
-    config_print(&g_config);
+    // SEED = 0: a fresh seed, shown with the config and in the summary
+    // so the run can be repeated with --seed. A sweep picks it once, so
+    // every combination sees the same workload
+    if (cfg.seed == 0) cfg.seed = rng_clock_seed();
+
+    if (cfg.bench[0])
+        return bench_run(cfg.bench) == 0 ? 0 : 1;
+
+    if (cfg.merge_only) {
+        int merged = io_buffer_merge_segments(cfg.output_dir, cfg.io_shards);
+        if (merged < 0) return 1;
+        printf("  Merged %d submissions from %d segments into %s/submissions.txt\n",
+               merged, cfg.io_shards, cfg.output_dir);
+        return 0;
+    }
 
-    if (g_config.demo_mode)
+    if (cfg.lookup_pid > 0)
+        return lookup_submission(&cfg, cfg.lookup_pid, cfg.lookup_qid);
+
+    // A replay is checked before anything is written, and sets the
+    // students and seed of the run it came from
+    if (cfg.replay_path[0]) {
+        if (cfg.restore_path[0]) {
+            fprintf(stderr, "  --replay starts at tick 0 and cannot be combined with --restore\n");
+            return 1;
+        }
+        if (trace_check(cfg.replay_path, &cfg) != 0) return 1;
+    }
+    // A capture from a restored run would lack the logins before it
+    if (cfg.restore_path[0] && cfg.trace_capture) {
+        printf("  Not capturing a trace: the run starts from a snapshot\n");
+        cfg.trace_capture = 0;
+    }
+
+    if (cfg.sweep[0]) {
+        config_print(&cfg);
+        printf("\n");
+        return sweep_run(&cfg, cfg.sweep) == 0 ? 0 : 1;
+    }
+
+    // A snapshot is checked in full before anything is initialised:
+    // a bad one must not truncate the previous run's outputs
+    Snapshot *snap = NULL;
+    if (cfg.restore_path[0] && !(snap = snapshot_load(cfg.restore_path, &cfg)))
+        return 1;
+    // Its random streams pick up where they were: report that run's seed
+    if (snap) cfg.seed = snapshot_seed(snap);
+
+    config_print(&cfg);
+
+    if (cfg.demo_mode)
         printf("\n  [DEMO MODE] Submission storm at tick 30\n");
 
+    if (snap)
+        printf("\n  Restoring tick %d from %s\n", snapshot_tick(snap), cfg.restore_path);
+
     printf("\n  Starting simulation in 2 seconds...\n\n");
     sleep(2);
 
-    // ─── Init all subsystems ──────────────────────────────
-    state_init();
-    logger_init();
-    scheduler_init();
-    memory_init();
-    io_buffer_init();
-    interrupt_init();
-    dashboard_init();
-
-    // ─── Spawn all threads ────────────────────────────────
-    pthread_t t_tick, t_logger, t_scheduler,
-              t_memory, t_io, t_interrupt, t_dashboard;
-
-    pthread_create(&t_tick,      NULL, tick_thread,       NULL);
-    pthread_create(&t_logger,    NULL, logger_thread,     NULL);
-    pthread_create(&t_scheduler, NULL, scheduler_thread,  NULL);
-    pthread_create(&t_memory,    NULL, memory_thread,     NULL);
-    pthread_create(&t_io,        NULL, io_buffer_thread,  NULL);
-    pthread_create(&t_interrupt, NULL, interrupt_thread,  NULL);
-    pthread_create(&t_dashboard, NULL, dashboard_thread,  NULL);
-
-    // ─── Run until exam_duration ticks or 'q' pressed ────
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int tick    = g_state.current_tick;
-        int running = g_state.simulation_running;
-        int done    = g_state.completed_processes;
-        pthread_mutex_unlock(&g_state.lock);
-
-        // End conditions
-        if (!running) break;
-        if (tick >= g_config.exam_duration) {
-            pthread_mutex_lock(&g_state.lock);
-            g_state.simulation_running = 0;
-            pthread_mutex_unlock(&g_state.lock);
-            break;
-        }
-        if (done >= g_config.num_students) {
-            pthread_mutex_lock(&g_state.lock);
-            g_state.simulation_running = 0;
-            pthread_mutex_unlock(&g_state.lock);
-            break;
-        }
+    SimContext *ctx = sim_create(&cfg);
+    if (!ctx) {
+        snapshot_free(snap);
+        return 1;
+    }
 
-        usleep(TIME_TICK_MS * 1000);
+    // Every subsystem is at its defaults: overwrite them, then start
+    if (snap) {
+        int rc = snapshot_apply(ctx, snap);
+        snapshot_free(snap);
+        if (rc != 0) {
+            sim_destroy(ctx);
+            return 1;
+        }
     }
 
-    // ─── Shutdown sequence ────────────────────────────────
-    // Signal all threads to stop
-    pthread_mutex_lock(&g_state.lock);
-    g_state.simulation_running = 0;
-    pthread_mutex_unlock(&g_state.lock);
-
-    io_buffer_shutdown();
-    logger_shutdown();
-    dashboard_shutdown();
-
-    // Wait for all threads
-    pthread_join(t_dashboard, NULL);
-    pthread_join(t_interrupt, NULL);
-    pthread_join(t_io,        NULL);
-    pthread_join(t_memory,    NULL);
-    pthread_join(t_scheduler, NULL);
-    pthread_join(t_logger,    NULL);
-    pthread_join(t_tick,      NULL);
-
-    // ─── Write final report ───────────────────────────────
+    sim_run(ctx);
+
     printf("\n  Simulation complete. Writing report...\n");
-    logger_write_report();
+    print_summary(cfg.output_dir);
 
     printf("\n  Output files:\n");
-    printf("    output/system_log.txt   — full event log\n");
-    printf("    output/submissions.txt  — all submissions\n");
-    printf("    output/summary.txt      — final statistics\n\n");
-
-    // ─── Cleanup ──────────────────────────────────────────
-    pthread_mutex_destroy(&g_state.lock);
-    pthread_mutex_destroy(&g_io_buffer.lock);
-    sem_destroy(&g_io_buffer.empty_slots);
-    sem_destroy(&g_io_buffer.filled_slots);
+    printf("    %s/system_log.txt   — full event log\n", cfg.output_dir);
+    printf("    %s/submissions.txt  — all submissions\n", cfg.output_dir);
+    printf("    %s/summary.txt      — final statistics\n\n", cfg.output_dir);
 
+    sim_destroy(ctx);
     return 0;
-}
\ No newline at end of file
+}
@@ -4,7 +4,11 @@
 #include <unistd.h>
 #include <time.h>
 #include "memory.h"
+#include "tick_clock.h"
 #include "logger.h"
+#include "interrupt.h"
+#include "rng.h"
+#include "trace.h"
 
 // ─── Physical frame pool ──────────────────────────────────
 typedef struct {
@@ -14,13 +18,16 @@ typedef struct {
     long last_accessed; // for LRU
 } Frame;
 
-static Frame    frame_pool[MAX_FRAMES];
-static int      total_frames;
-static int      fifo_counter = 0;
-static pthread_mutex_t mem_lock = PTHREAD_MUTEX_INITIALIZER;
+typedef struct Memory {
+    Frame           frame_pool[MAX_FRAMES];
+    int             total_frames;
+    int             fifo_counter;
+    pthread_mutex_t mem_lock;
 
-// ─── Per-process page tables ──────────────────────────────
-static PageTableEntry page_tables[MAX_STUDENTS][MAX_PAGES];
+    // Per-process page tables
+    PageTableEntry  page_tables[MAX_STUDENTS][MAX_PAGES];
+    Rng             rng[MAX_STUDENTS];   // RNG_MEMORY, by pid - 1 (memory phase only)
+} Memory;
 
 // ─── Timestamp helper ─────────────────────────────────────
 static long now_ms() {
@@ -29,45 +36,58 @@ static long now_ms() {
     return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
 }
 
-void memory_init() {
-    total_frames = g_config.memory_frames;
-    if (total_frames > MAX_FRAMES) total_frames = MAX_FRAMES;
+void memory_init(SimContext *ctx) {
+    Memory *m = calloc(1, sizeof(Memory));
+    ctx->memory = m;
+    pthread_mutex_init(&m->mem_lock, NULL);
 
-    for (int i = 0; i < total_frames; i++) {
-        frame_pool[i].pid          = -1;
-        frame_pool[i].virtual_page = -1;
-        frame_pool[i].load_order   =  0;
-        frame_pool[i].last_accessed = 0;
+    m->total_frames = ctx->config.memory_frames;
+    if (m->total_frames > MAX_FRAMES) m->total_frames = MAX_FRAMES;
+
+    for (int i = 0; i < m->total_frames; i++) {
+        m->frame_pool[i].pid          = -1;
+        m->frame_pool[i].virtual_page = -1;
+        m->frame_pool[i].load_order   =  0;
+        m->frame_pool[i].last_accessed = 0;
     }
 
     for (int i = 0; i < MAX_STUDENTS; i++)
         for (int j = 0; j < MAX_PAGES; j++) {
-            page_tables[i][j].virtual_page  = j;
-            page_tables[i][j].frame_number  = -1;
-            page_tables[i][j].valid         =  0;
-            page_tables[i][j].dirty         =  0;
-            page_tables[i][j].last_accessed =  0;
-            page_tables[i][j].load_order    =  0;
+            m->page_tables[i][j].virtual_page  = j;
+            m->page_tables[i][j].frame_number  = -1;
+            m->page_tables[i][j].valid         =  0;
+            m->page_tables[i][j].dirty         =  0;
+            m->page_tables[i][j].last_accessed =  0;
+            m->page_tables[i][j].load_order    =  0;
         }
+    for (int i = 0; i < MAX_STUDENTS; i++)
+        rng_seed(&m->rng[i], ctx->config.seed, RNG_MEMORY, i + 1);
 
-    log_event("INFO", "MEMORY", "Memory subsystem initialized");
+    log_event(ctx, "INFO", "MEMORY", "Memory subsystem initialized");
+}
+
+void memory_destroy(SimContext *ctx) {
+    if (!ctx->memory) return;
+    pthread_mutex_destroy(&ctx->memory->mem_lock);
+    free(ctx->memory);
+    ctx->memory = NULL;
 }
 
 // ─── Find a free frame ────────────────────────────────────
-static int find_free_frame() {
-    for (int i = 0; i < total_frames; i++)
-        if (frame_pool[i].pid == -1) return i;
+static int find_free_frame(Memory *m) {
+    for (int i = 0; i < m->total_frames; i++)
+        if (m->frame_pool[i].pid == -1) return i;
     return -1;
 }
 
 // ─── FIFO eviction ────────────────────────────────────────
-static int evict_fifo() {
+static int evict_fifo(Memory *m) {
     int oldest_frame = 0;
-    int oldest_order = frame_pool[0].load_order;
+    int oldest_order = m->frame_pool[0].load_order;
 
-    for (int i = 1; i < total_frames; i++) {
-        if (frame_pool[i].load_order < oldest_order) {
-            oldest_order = frame_pool[i].load_order;
+    for (int i = 1; i < m->total_frames; i++) {
+        if (m->frame_pool[i].load_order < oldest_order) {
+            oldest_order = m->frame_pool[i].load_order;
             oldest_frame = i;
         }
     }
@@ -75,13 +95,13 @@ static int evict_fifo() {
 }
 
 // ─── LRU eviction ─────────────────────────────────────────
-static int evict_lru() {
+static int evict_lru(Memory *m) {
     int lru_frame = 0;
-    long lru_time = frame_pool[0].last_accessed;
+    long lru_time = m->frame_pool[0].last_accessed;
 
-    for (int i = 1; i < total_frames; i++) {
-        if (frame_pool[i].last_accessed < lru_time) {
-            lru_time  = frame_pool[i].last_accessed;
+    for (int i = 1; i < m->total_frames; i++) {
+        if (m->frame_pool[i].last_accessed < lru_time) {
+            lru_time  = m->frame_pool[i].last_accessed;
             lru_frame = i;
         }
     }
@@ -89,149 +109,250 @@ static int evict_lru() {
 }
 
 // ─── Load a page into a frame ─────────────────────────────
-static void load_page(int pid, int virtual_page, int frame) {
+static void load_page(SimContext *ctx, int pid, int virtual_page, int frame) {
+    Memory         *m  = ctx->memory;
+    Frame          *f  = &m->frame_pool[frame];
+    PageTableEntry (*pt)[MAX_PAGES] = m->page_tables;
+
     // Invalidate previous owner's page table entry
-    int prev_pid  = frame_pool[frame].pid;
-    int prev_page = frame_pool[frame].virtual_page;
+    int prev_pid  = f->pid;
+    int prev_page = f->virtual_page;
 
     if (prev_pid >= 0 && prev_pid < MAX_STUDENTS && prev_page >= 0) {
-        page_tables[prev_pid][prev_page].valid        = 0;
-        page_tables[prev_pid][prev_page].frame_number = -1;
+        pt[prev_pid][prev_page].valid        = 0;
+        pt[prev_pid][prev_page].frame_number = -1;
 
-        if (page_tables[prev_pid][prev_page].dirty) {
+        if (pt[prev_pid][prev_page].dirty) {
             char msg[128];
             snprintf(msg, sizeof(msg),
                      "Dirty eviction: PID %d page %d → disk write",
                      prev_pid, prev_page);
-            log_event("WARN", "MEMORY", msg);
-            page_tables[prev_pid][prev_page].dirty = 0;
+            log_event(ctx, "WARN", "MEMORY", msg);
+            pt[prev_pid][prev_page].dirty = 0;
+
+            pthread_mutex_lock(&ctx->state.lock);
+            ctx->state.dirty_evictions++;
+            pthread_mutex_unlock(&ctx->state.lock);
         }
     }
 
     // Load new page
-    frame_pool[frame].pid           = pid;
-    frame_pool[frame].virtual_page  = virtual_page;
-    frame_pool[frame].load_order    = fifo_counter++;
-    frame_pool[frame].last_accessed = now_ms();
+    f->pid           = pid;
+    f->virtual_page  = virtual_page;
+    f->load_order    = m->fifo_counter++;
+    f->last_accessed = now_ms();
 
-    page_tables[pid][virtual_page].frame_number  = frame;
-    page_tables[pid][virtual_page].valid         = 1;
-    page_tables[pid][virtual_page].last_accessed = now_ms();
-    page_tables[pid][virtual_page].load_order    = frame_pool[frame].load_order;
+    pt[pid][virtual_page].frame_number  = frame;
+    pt[pid][virtual_page].valid         = 1;
+    pt[pid][virtual_page].last_accessed = now_ms();
+    pt[pid][virtual_page].load_order    = f->load_order;
 
     // Simulate disk → memory load delay
     usleep(500);
 }
 
+// Caller holds mem_lock
+static void publish_frames_used(SimContext *ctx) {
+    Memory *m = ctx->memory;
+    pthread_mutex_lock(&ctx->state.lock);
+    int used = 0;
+    for (int i = 0; i < m->total_frames; i++)
+        if (m->frame_pool[i].pid != -1) used++;
+    ctx->state.frames_used = used;
+    pthread_mutex_unlock(&ctx->state.lock);
+}
+
 // ─── Core memory access (called per tick per running process)
-int memory_access(int pid, int virtual_page) {
+int memory_access(SimContext *ctx, int pid, int virtual_page, int write) {
     if (pid < 0 || pid >= MAX_STUDENTS) return -1;
     if (virtual_page < 0 || virtual_page >= MAX_PAGES) return -1;
 
-    pthread_mutex_lock(&mem_lock);
+    Memory *m = ctx->memory;
+    pthread_mutex_lock(&m->mem_lock);
 
-    PageTableEntry *entry = &page_tables[pid][virtual_page];
+    PageTableEntry *entry = &m->page_tables[pid][virtual_page];
 
     if (entry->valid) {
         // PAGE HIT
         entry->last_accessed = now_ms();
-        frame_pool[entry->frame_number].last_accessed = now_ms();
+        if (write) entry->dirty = 1;
+        m->frame_pool[entry->frame_number].last_accessed = now_ms();
 
-        pthread_mutex_lock(&g_state.lock);
-        g_state.page_hits++;
-        pthread_mutex_unlock(&g_state.lock);
+        pthread_mutex_lock(&ctx->state.lock);
+        ctx->state.page_hits++;
+        pthread_mutex_unlock(&ctx->state.lock);
 
-        pthread_mutex_unlock(&mem_lock);
+        pthread_mutex_unlock(&m->mem_lock);
         return entry->frame_number;
     }
 
     // PAGE FAULT
-    pthread_mutex_lock(&g_state.lock);
-    g_state.page_faults++;
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.page_faults++;
+    pthread_mutex_unlock(&ctx->state.lock);
 
     char msg[128];
     snprintf(msg, sizeof(msg), "Page fault: PID %d page %d", pid, virtual_page);
-    log_event("WARN", "MEMORY", msg);
+    log_event(ctx, "WARN", "MEMORY", msg);
+    interrupt_raise(ctx, INT_PAGE_FAULT, pid + 1);
 
     // Find or evict a frame
-    int frame = find_free_frame();
+    int frame = find_free_frame(m);
     if (frame == -1) {
-        frame = (g_config.page_algo == LRU) ? evict_lru() : evict_fifo();
+        frame = (ctx->config.page_algo == LRU) ? evict_lru(m) : evict_fifo(m);
 
         snprintf(msg, sizeof(msg), "Evicting frame %d (%s)",
-                 frame, g_config.page_algo == LRU ? "LRU" : "FIFO");
-        log_event("INFO", "MEMORY", msg);
+                 frame, ctx->config.page_algo == LRU ? "LRU" : "FIFO");
+        log_event(ctx, "INFO", "MEMORY", msg);
     }
 
-    load_page(pid, virtual_page, frame);
+    load_page(ctx, pid, virtual_page, frame);
+    if (write) entry->dirty = 1;
 
     // Update frames_used in shared state
-    pthread_mutex_lock(&g_state.lock);
-    int used = 0;
-    for (int i = 0; i < total_frames; i++)
-        if (frame_pool[i].pid != -1) used++;
-    g_state.frames_used = used;
-    pthread_mutex_unlock(&g_state.lock);
+    publish_frames_used(ctx);
 
-    pthread_mutex_unlock(&mem_lock);
+    pthread_mutex_unlock(&m->mem_lock);
     return frame;
 }
 
 // ─── Free all frames owned by a process ──────────────────
-void memory_free_process(int pid) {
-    pthread_mutex_lock(&mem_lock);
-
-    for (int i = 0; i < total_frames; i++) {
-        if (frame_pool[i].pid == pid) {
-            int vp = frame_pool[i].virtual_page;
-            page_tables[pid][vp].valid        = 0;
-            page_tables[pid][vp].frame_number = -1;
-            frame_pool[i].pid                 = -1;
-            frame_pool[i].virtual_page        = -1;
+void memory_free_process(SimContext *ctx, int pid) {
+    Memory *m = ctx->memory;
+    pthread_mutex_lock(&m->mem_lock);
+
+    for (int i = 0; i < m->total_frames; i++) {
+        if (m->frame_pool[i].pid == pid) {
+            int vp = m->frame_pool[i].virtual_page;
+            m->page_tables[pid][vp].valid        = 0;
+            m->page_tables[pid][vp].frame_number = -1;
+            m->frame_pool[i].pid                 = -1;
+            m->frame_pool[i].virtual_page        = -1;
         }
     }
 
-    pthread_mutex_lock(&g_state.lock);
-    int used = 0;
-    for (int i = 0; i < total_frames; i++)
-        if (frame_pool[i].pid != -1) used++;
-    g_state.frames_used = used;
-    pthread_mutex_unlock(&g_state.lock);
+    publish_frames_used(ctx);
 
-    pthread_mutex_unlock(&mem_lock);
+    pthread_mutex_unlock(&m->mem_lock);
 
     char msg[64];
     snprintf(msg, sizeof(msg), "Freed all frames for PID %d", pid);
-    log_event("INFO", "MEMORY", msg);
+    log_event(ctx, "INFO", "MEMORY", msg);
 }
 
-// ─── Memory thread ────────────────────────────────────────
+// ─── Bulk free: one frame-pool pass for a whole set of pids
+void memory_free_processes(SimContext *ctx, const int *pids, int n) {
+    Memory *m = ctx->memory;
+    unsigned char doomed[MAX_STUDENTS] = {0};
+    for (int i = 0; i < n; i++)
+        if (pids[i] >= 0 && pids[i] < MAX_STUDENTS) doomed[pids[i]] = 1;
+
+    pthread_mutex_lock(&m->mem_lock);
+
+    int used = 0, freed = 0;
+    for (int i = 0; i < m->total_frames; i++) {
+        int owner = m->frame_pool[i].pid;
+        if (owner >= 0 && owner < MAX_STUDENTS && doomed[owner]) {
+            int vp = m->frame_pool[i].virtual_page;
+            m->page_tables[owner][vp].valid        = 0;
+            m->page_tables[owner][vp].frame_number = -1;
+            m->frame_pool[i].pid                   = -1;
+            m->frame_pool[i].virtual_page          = -1;
+            freed++;
+        } else if (owner != -1) {
+            used++;
+        }
+    }
+
+    pthread_mutex_lock(&ctx->state.lock);
+    ctx->state.frames_used = used;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    pthread_mutex_unlock(&m->mem_lock);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Freed %d frames for %d processes (bulk)", freed, n);
+    log_event(ctx, "INFO", "MEMORY", msg);
+}
+
+// ─── Memory phase ─────────────────────────────────────────
 // Simulates memory accesses for the currently running process
-void *memory_thread(void *arg) {
-    (void)arg;
-    log_event("INFO", "MEMORY", "Memory thread started");
-
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int running  = g_state.simulation_running;
-        int curr_pid = g_state.running_pid;
-        pthread_mutex_unlock(&g_state.lock);
-
-        if (!running) break;
-
-        if (curr_pid > 0) {
-            // Simulate 1-3 random page accesses per tick
-            int accesses = 1 + rand() % 3;
-            for (int i = 0; i < accesses; i++) {
-                int vpage = rand() % 8; // working set of 8 pages per process
-                memory_access(curr_pid - 1, vpage);
+void memory_step(SimContext *ctx, int tick) {
+    Memory *m = ctx->memory;
+    pthread_mutex_lock(&ctx->state.lock);
+    int curr_pid = ctx->state.running_pid;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    if (curr_pid > 0) {
+        // The replayed trace's next burst for this student, else drawn
+        snapshot_enter(ctx);
+        TraceAccess acc[TRACE_MAX_BURST];
+        int n = trace_accesses(ctx, curr_pid, acc);
+        if (n < 0) {
+            // 1-3 accesses in a working set of 8 pages, a quarter of them writes
+            Rng *rng = &m->rng[curr_pid - 1];
+            n = 1 + rng_below(rng, 3);
+            for (int i = 0; i < n; i++) {
+                acc[i].page  = rng_below(rng, 8);
+                acc[i].write = rng_below(rng, 4) == 0;
             }
         }
+        for (int i = 0; i < n; i++) {
+            trace_record(ctx, tick, curr_pid, TRACE_MEM,
+                         (acc[i].write ? TRACE_WRITE : 0) | (i == n - 1 ? TRACE_LAST : 0),
+                         acc[i].page, 0);
+            memory_access(ctx, curr_pid - 1, acc[i].page, acc[i].write);
+        }
+        snapshot_leave(ctx);
+    }
+}
+
+// ─── Memory thread ────────────────────────────────────────
+void *memory_thread(void *arg) {
+    SimContext *ctx = arg;
+    log_event(ctx, "INFO", "MEMORY", "Memory thread started");
 
-        usleep(TIME_TICK_MS * 1000);
+    int tick = -1;
+    while ((tick = tick_phase_begin(ctx, TICK_MEMORY, tick)) >= 0) {
+        memory_step(ctx, tick);
+        tick_phase_end(ctx, TICK_MEMORY);
     }
 
-    log_event("INFO", "MEMORY", "Memory thread exiting");
+    log_event(ctx, "INFO", "MEMORY", "Memory thread exiting");
     return NULL;
-}
\ No newline at end of file
+}
+// ─── Snapshot: frame pool + page tables ──────────────────
+// LRU timestamps are monotonic ms: shifted on restore so a page's age
+// carries over, whenever the restored run starts
+void memory_snapshot(SimContext *ctx, SnapWriter *w) {
+    Memory *m = ctx->memory;
+    pthread_mutex_lock(&m->mem_lock);
+    snap_put(w, &m->total_frames, sizeof(m->total_frames));
+    snap_put(w, &m->fifo_counter, sizeof(m->fifo_counter));
+    snap_put(w, m->frame_pool,    sizeof(Frame) * m->total_frames);
+    snap_put(w, m->page_tables,   sizeof(m->page_tables));
+    snap_put(w, m->rng,           sizeof(m->rng));
+    pthread_mutex_unlock(&m->mem_lock);
+}
+
+void memory_restore(SimContext *ctx, SnapReader *r) {
+    Memory *m = ctx->memory;
+    int frames;
+    snap_get(r, &frames, sizeof(frames));
+    if (frames != m->total_frames) r->failed = 1;
+    if (r->failed) return;
+
+    snap_get(r, &m->fifo_counter, sizeof(m->fifo_counter));
+    snap_get(r, m->frame_pool,    sizeof(Frame) * m->total_frames);
+    snap_get(r, m->page_tables,   sizeof(m->page_tables));
+    snap_get(r, m->rng,           sizeof(m->rng));
+
+    long shift = r->rebase_us / 1000;
+    for (int i = 0; i < m->total_frames; i++)
+        if (m->frame_pool[i].last_accessed) m->frame_pool[i].last_accessed += shift;
+    for (int i = 0; i < MAX_STUDENTS; i++)
+        for (int j = 0; j < MAX_PAGES; j++)
+            if (m->page_tables[i][j].last_accessed) m->page_tables[i][j].last_accessed += shift;
+
+    publish_frames_used(ctx);
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "proc_table.h"
+
+// Sweeps run in chunks: a branch-free vector pass over the chunk, and
+// only if it saw an expiry a scalar pass to collect pids. Expiries are
+// rare, so per-tick cost stays close to one streaming read of state[].
+#define SWEEP_CHUNK 256
+
+void proc_table_init(ProcTable *t, int capacity) {
+    memset(t, 0, sizeof(ProcTable));
+    t->capacity        = capacity;
+    t->state           = calloc(capacity, sizeof(unsigned char));
+    t->remaining_time  = calloc(capacity, sizeof(int));
+    t->deadline_tick   = calloc(capacity, sizeof(int));
+    t->priority        = calloc(capacity, sizeof(int));
+    t->pid             = calloc(capacity, sizeof(int));
+    t->total_time      = calloc(capacity, sizeof(int));
+    t->waiting_time    = calloc(capacity, sizeof(int));
+    t->turnaround_time = calloc(capacity, sizeof(int));
+    t->pages_used      = calloc(capacity, sizeof(int));
+}
+
+void proc_table_free(ProcTable *t) {
+    free(t->state);
+    free(t->remaining_time);
+    free(t->deadline_tick);
+    free(t->priority);
+    free(t->pid);
+    free(t->total_time);
+    free(t->waiting_time);
+    free(t->turnaround_time);
+    free(t->pages_used);
+    memset(t, 0, sizeof(ProcTable));
+}
+
+// ─── Row access ──────────────────────────────────────────
+int proc_table_append(ProcTable *t, const PCB *p) {
+    if (t->count >= t->capacity) return -1;
+    int i = t->count++;
+    t->state[i]           = (unsigned char)p->state;
+    t->remaining_time[i]  = p->remaining_time;
+    t->deadline_tick[i]   = p->deadline_tick;
+    t->priority[i]        = p->priority;
+    t->pid[i]             = p->pid;
+    t->total_time[i]      = p->total_time;
+    t->waiting_time[i]    = p->waiting_time;
+    t->turnaround_time[i] = p->turnaround_time;
+    t->pages_used[i]      = p->pages_used;
+    return i;
+}
+
+int proc_table_find(const ProcTable *t, int pid) {
+    const int *pids = t->pid;
+    for (int i = 0; i < t->count; i++)
+        if (pids[i] == pid) return i;
+    return -1;
+}
+
+void proc_table_get(const ProcTable *t, int i, PCB *out) {
+    out->pid             = t->pid[i];
+    out->state           = (ProcessState)t->state[i];
+    out->priority        = t->priority[i];
+    out->total_time      = t->total_time[i];
+    out->remaining_time  = t->remaining_time[i];
+    out->deadline_tick   = t->deadline_tick[i];
+    out->waiting_time    = t->waiting_time[i];
+    out->turnaround_time = t->turnaround_time[i];
+    out->pages_used      = t->pages_used[i];
+}
+
+// ─── Bulk: count processes in a given state ──────────────
+int proc_table_count_state(const ProcTable *t, ProcessState state) {
+    const unsigned char *restrict st = t->state;
+    unsigned char want = (unsigned char)state;
+    int n = t->count, c = 0;
+    for (int i = 0; i < n; i++)
+        c += (st[i] == want);
+    return c;
+}
+
+// ─── Bulk: decrement live processes, retire expiries ─────
+// Returns the number of processes that expired this call; at most
+// max_expired of their pids are written to expired_pids.
+int proc_table_tick(ProcTable *t, int *expired_pids, int max_expired) {
+    unsigned char *restrict st  = t->state;
+    int           *restrict rem = t->remaining_time;
+    int n = t->count, fired = 0;
+
+    for (int base = 0; base < n; base += SWEEP_CHUNK) {
+        int end  = base + SWEEP_CHUNK < n ? base + SWEEP_CHUNK : n;
+        int hits = 0;
+
+        for (int i = base; i < end; i++) {
+            int live = (st[i] == READY) | (st[i] == RUNNING);
+            rem[i] -= live;
+            hits   += live & (rem[i] <= 0);
+        }
+        if (!hits) continue;
+
+        for (int i = base; i < end; i++) {
+            if ((st[i] == READY || st[i] == RUNNING) && rem[i] <= 0) {
+                st[i] = TERMINATED;
+                if (fired < max_expired) expired_pids[fired] = t->pid[i];
+                fired++;
+            }
+        }
+    }
+    return fired;
+}
+
+// ─── Bulk: first `max` non-terminated rows, as PCBs ──────
+int proc_table_collect_active(const ProcTable *t, PCB *out, int max) {
+    int found = 0;
+    for (int i = 0; i < t->count && found < max; i++) {
+        if (t->state[i] == TERMINATED) continue;
+        proc_table_get(t, i, &out[found++]);
+    }
+    return found;
+}
+
+// ─── Snapshot: count, then each column's live rows ───────
+void proc_table_snapshot(const ProcTable *t, SnapWriter *w) {
+    int n = t->count;
+    snap_put(w, &n, sizeof(n));
+    snap_put(w, t->state,           sizeof(unsigned char) * n);
+    snap_put(w, t->remaining_time,  sizeof(int) * n);
+    snap_put(w, t->deadline_tick,   sizeof(int) * n);
+    snap_put(w, t->priority,        sizeof(int) * n);
+    snap_put(w, t->pid,             sizeof(int) * n);
+    snap_put(w, t->total_time,      sizeof(int) * n);
+    snap_put(w, t->waiting_time,    sizeof(int) * n);
+    snap_put(w, t->turnaround_time, sizeof(int) * n);
+    snap_put(w, t->pages_used,      sizeof(int) * n);
+}
+
+void proc_table_restore(ProcTable *t, SnapReader *r) {
+    int n;
+    snap_get(r, &n, sizeof(n));
+    if (n < 0 || n > t->capacity) r->failed = 1;
+    if (r->failed) return;
+    t->count = n;
+    snap_get(r, t->state,           sizeof(unsigned char) * n);
+    snap_get(r, t->remaining_time,  sizeof(int) * n);
+    snap_get(r, t->deadline_tick,   sizeof(int) * n);
+    snap_get(r, t->priority,        sizeof(int) * n);
+    snap_get(r, t->pid,             sizeof(int) * n);
+    snap_get(r, t->total_time,      sizeof(int) * n);
+    snap_get(r, t->waiting_time,    sizeof(int) * n);
+    snap_get(r, t->turnaround_time, sizeof(int) * n);
+    snap_get(r, t->pages_used,      sizeof(int) * n);
+}
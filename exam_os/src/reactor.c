@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "reactor.h"
+#include "tick_clock.h"
+#include "logger.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "io_buffer.h"
+#include "interrupt.h"
+#include "dashboard.h"
+
+#define DRAW_MS     500
+#define MAX_EVENTS  8
+
+typedef struct Reactor {
+    int epfd;
+    int tick_fd;              // timerfd: TIME_TICK_MS
+    int draw_fd;              // timerfd: dashboard refresh
+    int log_fd;               // eventfd: log_event queued an entry
+    int stop_fd;              // eventfd: reactor_stop
+    int dash_open;            // ncurses is up and stdin is watched
+    ReactorStats stats;       // reactor thread only; read after the join
+} Reactor;
+
+// Same order as TickPhase
+static const tick_phase_fn phases[TICK_PHASES] = {
+    scheduler_admit, scheduler_step, memory_step, io_buffer_step, interrupt_step
+};
+
+static int watch(Reactor *r, int fd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+    return epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void arm(int fd, long ms) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec     = ms / 1000;
+    its.it_value.tv_nsec    = (ms % 1000) * 1000000L;
+    its.it_interval         = its.it_value;
+    timerfd_settime(fd, 0, &its, NULL);   // ms == 0 disarms
+}
+
+// timerfd expirations or the eventfd counter; 0 if nothing was pending
+static uint64_t consume(int fd) {
+    uint64_t n = 0;
+    if (read(fd, &n, sizeof(n)) != sizeof(n)) return 0;
+    return n;
+}
+
+int reactor_init(SimContext *ctx) {
+    Reactor *r = calloc(1, sizeof(Reactor));
+    if (!r) return -1;
+    r->epfd    = epoll_create1(EPOLL_CLOEXEC);
+    r->tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    r->draw_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    r->log_fd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    r->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ctx->reactor = r;
+
+    if (r->epfd < 0 || r->tick_fd < 0 || r->draw_fd < 0 || r->log_fd < 0 || r->stop_fd < 0 ||
+        watch(r, r->tick_fd) || watch(r, r->draw_fd) || watch(r, r->log_fd) ||
+        watch(r, r->stop_fd)) {
+        fprintf(stderr, "  Cannot set up the event loop: %s\n", strerror(errno));
+        reactor_destroy(ctx);
+        return -1;
+    }
+
+    // Every log_event from here on bumps log_fd instead of waking the
+    // logger thread, which this runtime never starts
+    logger_notify_fd(ctx, r->log_fd);
+    return 0;
+}
+
+void reactor_stop(SimContext *ctx) {
+    uint64_t one = 1;
+    ssize_t  n   = write(ctx->reactor->stop_fd, &one, sizeof(one));
+    (void)n;
+}
+
+void reactor_destroy(SimContext *ctx) {
+    Reactor *r = ctx->reactor;
+    if (!r) return;
+    int fds[] = { r->epfd, r->tick_fd, r->draw_fd, r->log_fd, r->stop_fd };
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++)
+        if (fds[i] >= 0) close(fds[i]);
+    free(r);
+    ctx->reactor = NULL;
+}
+
+void reactor_stats(SimContext *ctx, ReactorStats *out) {
+    *out = ctx->reactor->stats;
+}
+
+// ─── Dashboard ───────────────────────────────────────────
+static void dash_start(SimContext *ctx) {
+    Reactor *r = ctx->reactor;
+    if (!ctx->dash || dashboard_open(ctx) != 0) return;
+    r->dash_open = 1;
+    // stdin may be a file or /dev/null: then there is no 'q' to read
+    watch(r, STDIN_FILENO);
+    arm(r->draw_fd, DRAW_MS);
+    dashboard_draw(ctx);
+}
+
+static void dash_stop(SimContext *ctx) {
+    Reactor *r = ctx->reactor;
+    if (!r->dash_open) return;
+    r->dash_open = 0;
+    arm(r->draw_fd, 0);
+    epoll_ctl(r->epfd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+    dashboard_close(ctx);
+}
+
+// ─── Event loop ──────────────────────────────────────────
+void *reactor_thread(void *arg) {
+    SimContext *ctx = arg;
+    Reactor    *r   = ctx->reactor;
+    log_event(ctx, "INFO", "REACTOR", "Event loop started (epoll: tick timer, log eventfd)");
+
+    dash_start(ctx);
+    // The timer keeps its grid: handling a tick late doesn't push the
+    // following ones back, and a stall of several periods is folded
+    // into one tick rather than replayed as a burst
+    arm(r->tick_fd, TIME_TICK_MS);
+    int ticking = 1, done = 0;
+
+    while (!done) {
+        struct epoll_event evs[MAX_EVENTS];
+        int n = epoll_wait(r->epfd, evs, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            log_event(ctx, "ERROR", "REACTOR", "epoll_wait failed, leaving the event loop");
+            break;
+        }
+        r->stats.wakeups++;
+
+        for (int i = 0; i < n; i++) {
+            int fd = evs[i].data.fd;
+            if (fd == r->tick_fd) {
+                uint64_t exp = consume(fd);
+                if (exp == 0 || !ticking) continue;
+                r->stats.tick_events += exp;
+                if (exp > 1) {
+                    r->stats.missed_ticks += exp - 1;
+                    tick_clock_late(ctx, (long)(exp - 1) * TIME_TICK_MS * 1000L);
+                }
+                if (tick_clock_tick(ctx, phases) < 0) {
+                    ticking = 0;
+                    arm(r->tick_fd, 0);
+                }
+                // A tick logs in bursts: write them out before the
+                // queue can fill
+                logger_drain(ctx);
+            } else if (fd == r->log_fd) {
+                if (consume(fd)) r->stats.log_events++;
+                logger_drain(ctx);
+            } else if (fd == r->draw_fd) {
+                if (consume(fd) && r->dash_open) dashboard_draw(ctx);
+            } else if (fd == STDIN_FILENO) {
+                // 'q' ends the run at the next tick, as with the thread
+                if ((evs[i].events & (EPOLLHUP | EPOLLERR)) || dashboard_input(ctx))
+                    dash_stop(ctx);
+            } else if (fd == r->stop_fd) {
+                consume(fd);
+                done = 1;
+            }
+        }
+    }
+
+    dash_stop(ctx);
+    log_event(ctx, "INFO", "REACTOR", "Event loop exiting");
+    logger_drain(ctx);
+    return NULL;
+}
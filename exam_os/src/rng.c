@@ -0,0 +1,62 @@
+#include <time.h>
+#include <unistd.h>
+#include "rng.h"
+
+// ─── SplitMix64: expands a seed into stream state ─────────
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(Rng *r, uint64_t seed, RngStream stream, uint64_t index) {
+    // Hash (stream, index) first so neighbouring pids don't start
+    // from neighbouring SplitMix states
+    uint64_t key = ((uint64_t)stream << 48) ^ index;
+    uint64_t x   = seed ^ splitmix64(&key);
+    for (int i = 0; i < 4; i++) r->s[i] = splitmix64(&x);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+uint64_t rng_next(Rng *r) {
+    uint64_t *s      = r->s;
+    uint64_t  result = rotl(s[1] * 5, 7) * 9;
+    uint64_t  t      = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = rotl(s[3], 45);
+    return result;
+}
+
+// Lemire's multiply-shift: no division, and unbiased after the
+// rare rejection
+uint32_t rng_below(Rng *r, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+    if ((uint32_t)m < n) {
+        uint32_t floor = -n % n;
+        while ((uint32_t)m < floor)
+            m = (uint64_t)(uint32_t)(rng_next(r) >> 32) * n;
+    }
+    return m >> 32;
+}
+
+double rng_unit(Rng *r) {
+    return (rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+uint64_t rng_clock_seed(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t x = ((uint64_t)ts.tv_sec << 30) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 48);
+    uint64_t seed;
+    // 32 bits: short enough to read off the summary and pass to --seed
+    do seed = splitmix64(&x) & 0xFFFFFFFFull; while (seed == 0);
+    return seed;
+}
@@ -3,230 +3,334 @@
 #include <string.h>
 #include <unistd.h>
 #include "scheduler.h"
+#include "tick_clock.h"
 #include "logger.h"
+#include "admission.h"
+#include "timer_wheel.h"
+#include "proc_table.h"
 
 // ─── Ready Queue (min-heap by priority) ──────────────────
-static PCB  ready_queue[MAX_STUDENTS];
-static int  rq_size = 0;
-static pthread_mutex_t rq_lock = PTHREAD_MUTEX_INITIALIZER;
+typedef struct Scheduler {
+    PCB             ready_queue[MAX_STUDENTS];
+    int             rq_size;
+    pthread_mutex_t rq_lock;
 
-// ─── Round Robin queue index ─────────────────────────────
-static int rr_index = 0;
+    // Round Robin queue index
+    int             rr_index;
+
+    // Last tick admission ran for: once per tick, across a restore too
+    int             admitted_tick;
+} Scheduler;
 
 // ─── Heap helpers (higher priority = lower remaining_time) 
-static void swap_pcb(int a, int b) {
-    PCB tmp = ready_queue[a];
-    ready_queue[a] = ready_queue[b];
-    ready_queue[b] = tmp;
+static void swap_pcb(Scheduler *s, int a, int b) {
+    PCB tmp = s->ready_queue[a];
+    s->ready_queue[a] = s->ready_queue[b];
+    s->ready_queue[b] = tmp;
 }
 
-static void heap_push(PCB p) {
-    ready_queue[rq_size] = p;
-    int i = rq_size++;
+static void heap_push(Scheduler *s, PCB p) {
+    s->ready_queue[s->rq_size] = p;
+    int i = s->rq_size++;
     // bubble up
     while (i > 0) {
         int parent = (i - 1) / 2;
-        if (ready_queue[parent].remaining_time > ready_queue[i].remaining_time) {
-            swap_pcb(parent, i);
+        if (s->ready_queue[parent].remaining_time > s->ready_queue[i].remaining_time) {
+            swap_pcb(s, parent, i);
             i = parent;
         } else break;
     }
 }
 
-static PCB heap_pop() {
-    PCB top = ready_queue[0];
-    ready_queue[0] = ready_queue[--rq_size];
-    // bubble down
-    int i = 0;
+static void sift_down(Scheduler *s, int i) {
+    PCB *q = s->ready_queue;
     while (1) {
         int left  = 2*i+1, right = 2*i+2, smallest = i;
-        if (left  < rq_size && ready_queue[left].remaining_time  < ready_queue[smallest].remaining_time) smallest = left;
-        if (right < rq_size && ready_queue[right].remaining_time < ready_queue[smallest].remaining_time) smallest = right;
+        if (left  < s->rq_size && q[left].remaining_time  < q[smallest].remaining_time) smallest = left;
+        if (right < s->rq_size && q[right].remaining_time < q[smallest].remaining_time) smallest = right;
         if (smallest == i) break;
-        swap_pcb(i, smallest);
+        swap_pcb(s, i, smallest);
         i = smallest;
     }
+}
+
+static PCB heap_pop(Scheduler *s) {
+    PCB top = s->ready_queue[0];
+    s->ready_queue[0] = s->ready_queue[--s->rq_size];
+    sift_down(s, 0);
     return top;
 }
 
+// Bottom-up heap construction: O(n), used after bulk removals
+static void heapify(Scheduler *s) {
+    for (int i = s->rq_size / 2 - 1; i >= 0; i--)
+        sift_down(s, i);
+}
+
 // ─── Public: add process to ready queue ──────────────────
-void scheduler_init() {
-    rq_size  = 0;
-    rr_index = 0;
-    log_event("INFO", "SCHEDULER", "Scheduler initialized");
+void scheduler_init(SimContext *ctx) {
+    Scheduler *s = calloc(1, sizeof(Scheduler));
+    ctx->sched = s;
+    pthread_mutex_init(&s->rq_lock, NULL);
+    s->admitted_tick = -1;
+    log_event(ctx, "INFO", "SCHEDULER", "Scheduler initialized");
 }
 
-void scheduler_add_process(PCB process) {
-    pthread_mutex_lock(&rq_lock);
+void scheduler_destroy(SimContext *ctx) {
+    if (!ctx->sched) return;
+    pthread_mutex_destroy(&ctx->sched->rq_lock);
+    free(ctx->sched);
+    ctx->sched = NULL;
+}
+
+void scheduler_add_process(SimContext *ctx, PCB process) {
+    Scheduler *s = ctx->sched;
+    pthread_mutex_lock(&s->rq_lock);
     process.state = READY;
 
     // Add to global state process list
-    pthread_mutex_lock(&g_state.lock);
-    g_state.processes[g_state.process_count++] = process;
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_lock(&ctx->state.lock);
+    process.deadline_tick = ctx->state.current_tick + process.remaining_time;
+    proc_table_append(&ctx->state.procs, &process);
+    pthread_mutex_unlock(&ctx->state.lock);
 
-    heap_push(process);
+    heap_push(s, process);
+
+    // Deadline is armed once; the interrupt thread is told when it fires
+    timer_wheel_arm(ctx->wheel, process.pid, process.deadline_tick);
 
     char msg[128];
     snprintf(msg, sizeof(msg), "PID %d added to ready queue (remaining=%d ticks)", 
              process.pid, process.remaining_time);
-    log_event("INFO", "SCHEDULER", msg);
-    pthread_mutex_unlock(&rq_lock);
+    log_event(ctx, "INFO", "SCHEDULER", msg);
+    pthread_mutex_unlock(&s->rq_lock);
 }
 
-void scheduler_terminate_process(int pid) {
-    pthread_mutex_lock(&g_state.lock);
-    for (int i = 0; i < g_state.process_count; i++) {
-        if (g_state.processes[i].pid == pid) {
-            g_state.processes[i].state = TERMINATED;
-            g_state.completed_processes++;
-            break;
-        }
+void scheduler_terminate_process(SimContext *ctx, int pid) {
+    timer_wheel_cancel(ctx->wheel, pid);
+
+    pthread_mutex_lock(&ctx->state.lock);
+    int idx = proc_table_find(&ctx->state.procs, pid);
+    if (idx >= 0 && ctx->state.procs.state[idx] != TERMINATED) {
+        ctx->state.procs.state[idx] = TERMINATED;
+        ctx->state.completed_processes++;
     }
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_unlock(&ctx->state.lock);
 
     char msg[64];
     snprintf(msg, sizeof(msg), "PID %d terminated", pid);
-    log_event("INFO", "SCHEDULER", msg);
+    log_event(ctx, "INFO", "SCHEDULER", msg);
+}
+
+// ─── Bulk terminate (end-of-exam deadline storms) ────────
+// One pass to drop every doomed pid from the run queue followed by a
+// single O(n) heap rebuild, and one pass over the process table —
+// instead of a linear scan per pid.
+void scheduler_terminate_processes(SimContext *ctx, const int *pids, int n) {
+    Scheduler *s = ctx->sched;
+    unsigned char doomed[MAX_STUDENTS + 1] = {0};
+    for (int i = 0; i < n; i++) {
+        if (pids[i] >= 0 && pids[i] <= MAX_STUDENTS) doomed[pids[i]] = 1;
+        timer_wheel_cancel(ctx->wheel, pids[i]);
+    }
+
+    pthread_mutex_lock(&s->rq_lock);
+    int kept = 0;
+    for (int i = 0; i < s->rq_size; i++) {
+        int pid = s->ready_queue[i].pid;
+        if (pid >= 0 && pid <= MAX_STUDENTS && doomed[pid]) continue;
+        s->ready_queue[kept++] = s->ready_queue[i];
+    }
+    s->rq_size = kept;
+    if (ctx->config.sched_algo == PRIORITY) heapify(s);
+    else if (s->rq_size > 0)                s->rr_index %= s->rq_size;
+    else                                    s->rr_index = 0;
+    pthread_mutex_unlock(&s->rq_lock);
+
+    int terminated = 0;
+    pthread_mutex_lock(&ctx->state.lock);
+    ProcTable *t = &ctx->state.procs;
+    for (int i = 0; i < t->count; i++) {
+        int pid = t->pid[i];
+        if (pid >= 0 && pid <= MAX_STUDENTS && doomed[pid] && t->state[i] != TERMINATED) {
+            t->state[i] = TERMINATED;
+            terminated++;
+        }
+    }
+    ctx->state.completed_processes += terminated;
+    pthread_mutex_unlock(&ctx->state.lock);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%d processes terminated (bulk)", terminated);
+    log_event(ctx, "INFO", "SCHEDULER", msg);
+}
+
+// A process can time out while it is off the queue running a quantum;
+// it must not be put back (or "complete" a second time) afterwards.
+static int is_terminated(SimContext *ctx, int pid) {
+    pthread_mutex_lock(&ctx->state.lock);
+    int idx  = proc_table_find(&ctx->state.procs, pid);
+    int dead = idx >= 0 && ctx->state.procs.state[idx] == TERMINATED;
+    pthread_mutex_unlock(&ctx->state.lock);
+    return dead;
 }
 
 // ─── Round Robin scheduling ───────────────────────────────
-static void run_round_robin() {
-    pthread_mutex_lock(&rq_lock);
-    if (rq_size == 0) {
-        pthread_mutex_unlock(&rq_lock);
-
-        pthread_mutex_lock(&g_state.lock);
-        g_state.running_pid    = -1;
-        g_state.cpu_utilization = 0.0f;
-        pthread_mutex_unlock(&g_state.lock);
+static void run_round_robin(SimContext *ctx) {
+    Scheduler   *s     = ctx->sched;
+    SystemState *state = &ctx->state;
+    pthread_mutex_lock(&s->rq_lock);
+    if (s->rq_size == 0) {
+        pthread_mutex_unlock(&s->rq_lock);
+
+        pthread_mutex_lock(&state->lock);
+        state->running_pid    = -1;
+        state->cpu_utilization = 0.0f;
+        pthread_mutex_unlock(&state->lock);
         return;
     }
 
     // Pick next in circular order
-    PCB current = ready_queue[rr_index % rq_size];
-    pthread_mutex_unlock(&rq_lock);
+    PCB current = s->ready_queue[s->rr_index % s->rq_size];
+    pthread_mutex_unlock(&s->rq_lock);
 
     // Simulate running for one quantum
-    pthread_mutex_lock(&g_state.lock);
-    g_state.running_pid     = current.pid;
-    g_state.cpu_utilization = 100.0f * rq_size / (rq_size + 1);
-    g_state.context_switches++;
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_lock(&state->lock);
+    state->running_pid     = current.pid;
+    state->cpu_utilization = 100.0f * s->rq_size / (s->rq_size + 1);
+    state->context_switches++;
+    pthread_mutex_unlock(&state->lock);
 
     // Tick down remaining time
-    pthread_mutex_lock(&rq_lock);
-    if (rq_size > 0) {
-        int idx = rr_index % rq_size;
-        ready_queue[idx].remaining_time -= g_config.time_quantum;
+    pthread_mutex_lock(&s->rq_lock);
+    if (s->rq_size > 0) {
+        int idx = s->rr_index % s->rq_size;
+        s->ready_queue[idx].remaining_time -= ctx->config.time_quantum;
 
-        if (ready_queue[idx].remaining_time <= 0) {
+        if (s->ready_queue[idx].remaining_time <= 0) {
             // Process finished naturally
-            PCB done = ready_queue[idx];
-            ready_queue[idx] = ready_queue[--rq_size];
-            scheduler_terminate_process(done.pid);
+            PCB done = s->ready_queue[idx];
+            s->ready_queue[idx] = s->ready_queue[--s->rq_size];
+            scheduler_terminate_process(ctx, done.pid);
 
             char msg[64];
             snprintf(msg, sizeof(msg), "PID %d completed exam (RR)", done.pid);
-            log_event("INFO", "SCHEDULER", msg);
+            log_event(ctx, "INFO", "SCHEDULER", msg);
         } else {
-            rr_index = (rr_index + 1) % rq_size;
+            s->rr_index = (s->rr_index + 1) % s->rq_size;
         }
     }
-    pthread_mutex_unlock(&rq_lock);
+    pthread_mutex_unlock(&s->rq_lock);
 }
 
 // ─── Priority scheduling ──────────────────────────────────
-static void run_priority() {
-    pthread_mutex_lock(&rq_lock);
-    if (rq_size == 0) {
-        pthread_mutex_unlock(&rq_lock);
-
-        pthread_mutex_lock(&g_state.lock);
-        g_state.running_pid     = -1;
-        g_state.cpu_utilization = 0.0f;
-        pthread_mutex_unlock(&g_state.lock);
+static void run_priority(SimContext *ctx) {
+    Scheduler   *s     = ctx->sched;
+    SystemState *state = &ctx->state;
+    pthread_mutex_lock(&s->rq_lock);
+    if (s->rq_size == 0) {
+        pthread_mutex_unlock(&s->rq_lock);
+
+        pthread_mutex_lock(&state->lock);
+        state->running_pid     = -1;
+        state->cpu_utilization = 0.0f;
+        pthread_mutex_unlock(&state->lock);
         return;
     }
 
-    PCB current = heap_pop();
-    pthread_mutex_unlock(&rq_lock);
+    PCB current = heap_pop(s);
+    pthread_mutex_unlock(&s->rq_lock);
 
     // Run it
-    pthread_mutex_lock(&g_state.lock);
-    g_state.running_pid     = current.pid;
-    g_state.cpu_utilization = 100.0f * (g_config.num_students - g_state.completed_processes)
-                              / g_config.num_students;
-    g_state.context_switches++;
-    pthread_mutex_unlock(&g_state.lock);
+    pthread_mutex_lock(&state->lock);
+    state->running_pid     = current.pid;
+    state->cpu_utilization = 100.0f * (ctx->config.num_students - state->completed_processes)
+                             / ctx->config.num_students;
+    state->context_switches++;
+    pthread_mutex_unlock(&state->lock);
 
-    // Simulate one quantum of work
-    usleep(TIME_TICK_MS * 500);
+    // The quantum is this tick: no sleeping inside the schedule phase
+    current.remaining_time -= ctx->config.time_quantum;
 
-    current.remaining_time -= g_config.time_quantum;
+    if (is_terminated(ctx, current.pid)) return;
 
     if (current.remaining_time <= 0) {
-        scheduler_terminate_process(current.pid);
+        scheduler_terminate_process(ctx, current.pid);
 
         char msg[64];
         snprintf(msg, sizeof(msg), "PID %d completed exam (PRIORITY)", current.pid);
-        log_event("INFO", "SCHEDULER", msg);
+        log_event(ctx, "INFO", "SCHEDULER", msg);
     } else {
         // Put back in heap with updated time
-        pthread_mutex_lock(&rq_lock);
-        heap_push(current);
-        pthread_mutex_unlock(&rq_lock);
+        pthread_mutex_lock(&s->rq_lock);
+        heap_push(s, current);
+        pthread_mutex_unlock(&s->rq_lock);
     }
 }
 
+// ─── Tick phases ──────────────────────────────────────────
+// Arrivals: logins arrive and are admitted
+void scheduler_admit(SimContext *ctx, int tick) {
+    Scheduler *s = ctx->sched;
+    snapshot_enter(ctx);
+    if (tick != s->admitted_tick) {    // a restored tick is not re-admitted
+        admission_tick(ctx, tick);
+        s->admitted_tick = tick;
+    }
+    snapshot_leave(ctx);
+}
+
+// Schedule: one decision, which sees this tick's admissions
+void scheduler_step(SimContext *ctx, int tick) {
+    (void)tick;
+    // A quantum in flight holds its PCB off the queue: the whole
+    // decision runs inside the snapshot gate
+    snapshot_enter(ctx);
+    if (ctx->config.sched_algo == ROUND_ROBIN)
+        run_round_robin(ctx);
+    else
+        run_priority(ctx);
+    snapshot_leave(ctx);
+}
+
 // ─── Main scheduler thread ────────────────────────────────
 void *scheduler_thread(void *arg) {
-    (void)arg;
-    log_event("INFO", "SCHEDULER", "Scheduler thread started");
-
-    while (1) {
-        pthread_mutex_lock(&g_state.lock);
-        int running = g_state.simulation_running;
-        int tick    = g_state.current_tick;
-        pthread_mutex_unlock(&g_state.lock);
-
-        if (!running) break;
-
-        // Add a new batch of student processes every 10 ticks
-        // (simulates students joining exam over time)
-        if (tick % 10 == 0) {
-            pthread_mutex_lock(&g_state.lock);
-            int added = g_state.process_count;
-            pthread_mutex_unlock(&g_state.lock);
-
-            if (added < g_config.num_students) {
-                int batch = (g_config.num_students - added < 5)
-                            ? g_config.num_students - added : 5;
-                for (int i = 0; i < batch; i++) {
-                    PCB p = {
-                        .pid            = added + i + 1,
-                        .state          = NEW,
-                        .priority       = 1,
-                        .total_time     = g_config.exam_duration,
-                        .remaining_time = g_config.exam_duration - (rand() % 10),
-                        .waiting_time   = 0,
-                        .turnaround_time = 0,
-                        .pages_used     = 0
-                    };
-                    scheduler_add_process(p);
-                }
-            }
-        }
+    SimContext *ctx = arg;
+    log_event(ctx, "INFO", "SCHEDULER", "Scheduler thread started");
 
-        // Run one scheduling decision
-        if (g_config.sched_algo == ROUND_ROBIN)
-            run_round_robin();
-        else
-            run_priority();
+    int tick = -1;
+    while ((tick = tick_phase_begin(ctx, TICK_ARRIVALS, tick)) >= 0) {
+        scheduler_admit(ctx, tick);
+        tick_phase_end(ctx, TICK_ARRIVALS);
 
-        usleep(TIME_TICK_MS * 1000);
+        if (tick_phase_begin(ctx, TICK_SCHEDULE, tick - 1) < 0) break;
+        scheduler_step(ctx, tick);
+        tick_phase_end(ctx, TICK_SCHEDULE);
     }
 
-    log_event("INFO", "SCHEDULER", "Scheduler thread exiting");
+    log_event(ctx, "INFO", "SCHEDULER", "Scheduler thread exiting");
     return NULL;
-}
\ No newline at end of file
+}
+// ─── Snapshot: the run queue as it sits, heap order included
+// Called with the world stopped (snapshot gate held exclusively)
+void scheduler_snapshot(SimContext *ctx, SnapWriter *w) {
+    Scheduler *s = ctx->sched;
+    pthread_mutex_lock(&s->rq_lock);
+    snap_put(w, &s->rq_size,       sizeof(s->rq_size));
+    snap_put(w, &s->rr_index,      sizeof(s->rr_index));
+    snap_put(w, &s->admitted_tick, sizeof(s->admitted_tick));
+    snap_put(w, s->ready_queue,    sizeof(PCB) * s->rq_size);
+    pthread_mutex_unlock(&s->rq_lock);
+}
+
+void scheduler_restore(SimContext *ctx, SnapReader *r) {
+    Scheduler *s = ctx->sched;
+    int n;
+    snap_get(r, &n, sizeof(n));
+    if (n < 0 || n > MAX_STUDENTS) r->failed = 1;
+    if (r->failed) return;
+    s->rq_size = n;
+    snap_get(r, &s->rr_index,      sizeof(s->rr_index));
+    snap_get(r, &s->admitted_tick, sizeof(s->admitted_tick));
+    snap_get(r, s->ready_queue,    sizeof(PCB) * s->rq_size);
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "sim.h"
+#include "proc_table.h"
+#include "logger.h"
+#include "scheduler.h"
+#include "admission.h"
+#include "memory.h"
+#include "io_buffer.h"
+#include "interrupt.h"
+#include "workqueue.h"
+#include "dashboard.h"
+#include "snapshot.h"
+#include "histogram.h"
+#include "tick_clock.h"
+#include "reactor.h"
+#include "trace.h"
+
+static int mkdir_p(const char *path) {
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        mkdir(tmp, 0755);
+        *p = '/';
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+// ─── Init simulation state ────────────────────────────────
+static void state_init(SystemState *state) {
+    memset(state, 0, sizeof(SystemState));
+    state->running_pid        = -1;
+    state->simulation_running =  1;
+    state->current_tick       =  0;
+    for (int i = 0; i < 3; i++)
+        strncpy(state->recent_logs[i], "--- no events yet ---", 255);
+    proc_table_init(&state->procs, MAX_STUDENTS);
+    pthread_mutex_init(&state->lock, NULL);
+}
+
+SimContext *sim_create(const Config *cfg) {
+    if (mkdir_p(cfg->output_dir) != 0) {
+        fprintf(stderr, "  Cannot create output directory %s\n", cfg->output_dir);
+        return NULL;
+    }
+    SimContext *ctx = calloc(1, sizeof(SimContext));
+    if (!ctx) return NULL;
+    ctx->config = *cfg;
+
+    // ─── Init all subsystems ──────────────────────────────
+    state_init(&ctx->state);
+    if (trace_init(ctx) != 0) {
+        proc_table_free(&ctx->state.procs);
+        pthread_mutex_destroy(&ctx->state.lock);
+        free(ctx);
+        return NULL;
+    }
+    tick_clock_init(ctx);
+    logger_init(ctx);
+    if (ctx->config.runtime == RUNTIME_REACTOR && reactor_init(ctx) != 0) {
+        logger_destroy(ctx);
+        tick_clock_destroy(ctx);
+        trace_destroy(ctx);
+        proc_table_free(&ctx->state.procs);
+        pthread_mutex_destroy(&ctx->state.lock);
+        free(ctx);
+        return NULL;
+    }
+    snapshot_init(ctx);
+    scheduler_init(ctx);
+    admission_init(ctx);
+    memory_init(ctx);
+    io_buffer_init(ctx);
+    interrupt_init(ctx);
+    workqueue_init(ctx, ctx->config.bh_workers);
+    if (!ctx->config.headless) dashboard_init(ctx);
+    return ctx;
+}
+
+// ─── RUNTIME = REACTOR ────────────────────────────────────
+// The event loop runs the ticks, the log and the dashboard; only the
+// I/O lifecycle thread (flushers, compactor) and snapshots are spawned
+static void run_reactor(SimContext *ctx) {
+    const Config *cfg = &ctx->config;
+    pthread_t t_reactor, t_io, t_snapshot;
+
+    pthread_create(&t_reactor, NULL, reactor_thread,   ctx);
+    pthread_create(&t_io,      NULL, io_buffer_thread, ctx);
+    if (cfg->snapshot_ticks > 0)
+        pthread_create(&t_snapshot, NULL, snapshot_thread, ctx);
+
+    // ─── Run until exam_duration ticks or 'q' pressed ────
+    for (int tick = 0; (tick = tick_clock_wait(ctx, tick)) >= 0; ) ;
+
+    // ─── Shutdown sequence ────────────────────────────────
+    // Same order as the threaded runtime; the event loop goes last
+    // so it can write out everything the others logged
+    if (cfg->snapshot_ticks > 0) pthread_join(t_snapshot, NULL);
+    workqueue_shutdown(ctx);
+    io_buffer_shutdown(ctx);
+    pthread_join(t_io, NULL);
+    logger_shutdown(ctx);
+    reactor_stop(ctx);
+    pthread_join(t_reactor, NULL);
+}
+
+static void run_threads(SimContext *ctx) {
+    const Config *cfg = &ctx->config;
+
+    // ─── Spawn all threads ────────────────────────────────
+    pthread_t t_tick, t_logger, t_scheduler, t_memory, t_io,
+              t_interrupt, t_dashboard, t_snapshot;
+
+    pthread_create(&t_tick,      NULL, tick_clock_thread, ctx);
+    pthread_create(&t_logger,    NULL, logger_thread,     ctx);
+    pthread_create(&t_scheduler, NULL, scheduler_thread,  ctx);
+    pthread_create(&t_memory,    NULL, memory_thread,     ctx);
+    pthread_create(&t_io,        NULL, io_buffer_thread,  ctx);
+    pthread_create(&t_interrupt, NULL, interrupt_thread,  ctx);
+    if (ctx->dash)
+        pthread_create(&t_dashboard, NULL, dashboard_thread, ctx);
+    if (cfg->snapshot_ticks > 0)
+        pthread_create(&t_snapshot, NULL, snapshot_thread, ctx);
+
+    // ─── Run until exam_duration ticks or 'q' pressed ────
+    // The clock ends the run between two ticks, then wakes every
+    // thread waiting on it
+    pthread_join(t_tick, NULL);
+
+    // ─── Shutdown sequence ────────────────────────────────
+    // No snapshot of a half-stopped world
+    if (cfg->snapshot_ticks > 0) pthread_join(t_snapshot, NULL);
+
+    // Stop the dispatcher first so nothing new is deferred, then drain
+    // bottom halves (partial submissions) before the final I/O flush
+    pthread_join(t_interrupt, NULL);
+    workqueue_shutdown(ctx);
+
+    // The I/O thread logs its final drain and merge: join it while
+    // the logger is still running
+    io_buffer_shutdown(ctx);
+    pthread_join(t_io, NULL);
+    logger_shutdown(ctx);
+    if (ctx->dash) dashboard_shutdown(ctx);
+
+    // Wait for all threads
+    if (ctx->dash) pthread_join(t_dashboard, NULL);
+    pthread_join(t_memory,    NULL);
+    pthread_join(t_scheduler, NULL);
+    pthread_join(t_logger,    NULL);
+}
+
+void sim_run(SimContext *ctx) {
+    if (ctx->config.runtime == RUNTIME_REACTOR)
+        run_reactor(ctx);
+    else
+        run_threads(ctx);
+
+    // ─── Write final report ───────────────────────────────
+    trace_write(ctx);
+    logger_write_report(ctx);
+}
+
+void sim_metrics(SimContext *ctx, SimMetrics *out) {
+    SystemState *state = &ctx->state;
+    memset(out, 0, sizeof(*out));
+
+    pthread_mutex_lock(&state->lock);
+    out->ticks            = state->current_tick;
+    out->completed        = state->completed_processes;
+    out->timeouts         = state->timeouts_fired;
+    out->context_switches = state->context_switches;
+    out->page_hits        = state->page_hits;
+    out->page_faults      = state->page_faults;
+    pthread_mutex_unlock(&state->lock);
+
+    IOSubmitStats io;
+    io_buffer_submit_stats(ctx, &io);
+    out->submitted     = io.submitted;
+    out->dropped       = io.dropped;
+    out->submit_p50_ns = io.p50_ns;
+    out->submit_p99_ns = io.p99_ns;
+
+    IOPhaseStats ph[IO_PHASES];
+    io_buffer_phase_stats(ctx, ph);
+    out->durable_p50_us = ph[PHASE_TOTAL].p50_us;
+    out->durable_p99_us = ph[PHASE_TOTAL].p99_us;
+
+    out->login_wait_p99 = hist_percentile(admission_wait_hist(ctx), 99.0);
+}
+
+void sim_destroy(SimContext *ctx) {
+    if (!ctx) return;
+    interrupt_shutdown(ctx);
+    io_buffer_destroy(ctx);
+    memory_destroy(ctx);
+    admission_destroy(ctx);
+    scheduler_destroy(ctx);
+    if (ctx->dash) dashboard_destroy(ctx);
+    snapshot_destroy(ctx);
+    logger_destroy(ctx);
+    reactor_destroy(ctx);
+    tick_clock_destroy(ctx);
+    trace_destroy(ctx);
+    proc_table_free(&ctx->state.procs);
+    pthread_mutex_destroy(&ctx->state.lock);
+    free(ctx);
+}
@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+#include "tick_clock.h"
+#include "logger.h"
+#include "proc_table.h"
+#include "scheduler.h"
+#include "admission.h"
+#include "memory.h"
+#include "timer_wheel.h"
+#include "interrupt.h"
+#include "io_buffer.h"
+#include "histogram.h"
+#include "submission_store.h"
+
+
+typedef struct Snapshotter {
+    // The gate. Default rwlock: readers never wait behind a pending
+    // writer, so a thread holding the gate while it waits on another
+    // one (a BLOCK submit on its flusher) cannot deadlock against a
+    // snapshot.
+    pthread_rwlock_t gate;
+
+    // Accounting
+    long      taken;
+    int       last_tick;
+    long      last_bytes;
+    int       restored_tick;
+    Histogram pause_hist;       // gate held exclusively, µs
+    Histogram write_hist;       // serialize + write + fsync, ms
+} Snapshotter;
+
+struct Snapshot {
+    SnapshotHeader hdr;
+    char          *payload;
+    SnapReader     sections[SNAP_SECTIONS];   // by id, data NULL if absent
+    char           path[256];
+};
+
+// ─── Timestamps ──────────────────────────────────────────
+static long now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+static long wall_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+// ─── Buffers ─────────────────────────────────────────────
+void snap_put(SnapWriter *w, const void *p, size_t n) {
+    if (w->failed || n == 0) return;
+    if (w->len + n > w->cap) {
+        size_t cap = w->cap ? w->cap : 64 * 1024;
+        while (cap < w->len + n) cap *= 2;
+        char *data = realloc(w->data, cap);
+        if (!data) {
+            w->failed = 1;
+            return;
+        }
+        w->data = data;
+        w->cap  = cap;
+    }
+    memcpy(w->data + w->len, p, n);
+    w->len += n;
+}
+
+void snap_get(SnapReader *r, void *p, size_t n) {
+    if (r->failed || n > r->len - r->pos) {
+        r->failed = 1;
+        memset(p, 0, n);
+        return;
+    }
+    memcpy(p, r->data + r->pos, n);
+    r->pos += n;
+}
+
+// Sizes of the structs written raw: a snapshot from a build where any
+// of them differ is refused instead of misread
+static uint32_t layout_signature() {
+    size_t sizes[] = { sizeof(SystemState), sizeof(PCB), sizeof(PageTableEntry),
+                       sizeof(Histogram), sizeof(Submission) };
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        h = (h ^ (uint32_t)sizes[i]) * 16777619u;
+    return h;
+}
+
+void snapshot_init(SimContext *ctx) {
+    Snapshotter *sn = calloc(1, sizeof(Snapshotter));
+    ctx->snap = sn;
+    pthread_rwlock_init(&sn->gate, NULL);
+    sn->last_tick     = -1;
+    sn->restored_tick = -1;
+}
+
+void snapshot_destroy(SimContext *ctx) {
+    if (!ctx->snap) return;
+    pthread_rwlock_destroy(&ctx->snap->gate);
+    free(ctx->snap);
+    ctx->snap = NULL;
+}
+
+void snapshot_enter(SimContext *ctx) {
+    pthread_rwlock_rdlock(&ctx->snap->gate);
+}
+
+void snapshot_leave(SimContext *ctx) {
+    pthread_rwlock_unlock(&ctx->snap->gate);
+}
+
+// ─── SystemState: everything but its lock and the table pointers
+static void state_snapshot(SimContext *ctx, SnapWriter *w) {
+    SystemState s;
+    pthread_mutex_lock(&ctx->state.lock);
+    memcpy(&s, &ctx->state, sizeof(s));
+    pthread_mutex_unlock(&ctx->state.lock);
+    memset(&s.procs, 0, sizeof(s.procs));
+    memset(&s.lock,  0, sizeof(s.lock));
+    snap_put(w, &s, sizeof(s));
+}
+
+// No other thread is running yet
+static void state_restore(SimContext *ctx, SnapReader *r) {
+    SystemState s;
+    snap_get(r, &s, sizeof(s));
+    if (r->failed) return;
+
+    ProcTable       procs = ctx->state.procs;
+    pthread_mutex_t lock  = ctx->state.lock;
+    memcpy(&ctx->state, &s, sizeof(s));
+    ctx->state.procs = procs;
+    ctx->state.lock  = lock;
+    ctx->state.simulation_running = 1;
+}
+
+static void procs_snapshot(SimContext *ctx, SnapWriter *w) {
+    pthread_mutex_lock(&ctx->state.lock);
+    proc_table_snapshot(&ctx->state.procs, w);
+    pthread_mutex_unlock(&ctx->state.lock);
+}
+
+static void procs_restore(SimContext *ctx, SnapReader *r) {
+    proc_table_restore(&ctx->state.procs, r);
+}
+
+static void timers_snapshot(SimContext *ctx, SnapWriter *w) {
+    timer_wheel_snapshot(ctx->wheel, w);
+}
+
+static void timers_restore(SimContext *ctx, SnapReader *r) {
+    timer_wheel_restore(ctx->wheel, r);
+}
+
+// ─── Capture ─────────────────────────────────────────────
+static void put_section(SimContext *ctx, SnapWriter *w, SnapSection id,
+                        void (*save)(SimContext *, SnapWriter *)) {
+    SnapSectionHeader sh = { (uint32_t)id, 0 };
+    size_t at = w->len;
+    snap_put(w, &sh, sizeof(sh));
+    save(ctx, w);
+    if (w->failed) return;
+    sh.len = (uint32_t)(w->len - at - sizeof(sh));
+    memcpy(w->data + at, &sh, sizeof(sh));
+}
+
+static int write_file(const char *path, const char *data, size_t len) {
+    char tmp[300];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(fd, data + done, len - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            unlink(tmp);
+            return -1;
+        }
+        done += n;
+    }
+    // A snapshot replaces nothing, but a torn one must never be visible
+    if (fdatasync(fd) != 0 || close(fd) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+// Stop the world just long enough to copy every subsystem, then
+// serialize the rest and write the file with everything running
+static void snapshot_take(SimContext *ctx) {
+    Snapshotter   *sn = ctx->snap;
+    SnapWriter     w;
+    SnapshotHeader h;
+    memset(&w, 0, sizeof(w));
+    memset(&h, 0, sizeof(h));
+    snap_put(&w, &h, sizeof(h));
+
+    pthread_rwlock_wrlock(&sn->gate);
+    long t0 = now_us();
+    pthread_mutex_lock(&ctx->state.lock);
+    h.tick = ctx->state.current_tick;
+    pthread_mutex_unlock(&ctx->state.lock);
+    h.mono_us = t0;
+
+    put_section(ctx, &w, SNAP_STATE,      state_snapshot);
+    put_section(ctx, &w, SNAP_PROCS,      procs_snapshot);
+    put_section(ctx, &w, SNAP_SCHEDULER,  scheduler_snapshot);
+    put_section(ctx, &w, SNAP_ADMISSION,  admission_snapshot);
+    put_section(ctx, &w, SNAP_MEMORY,     memory_snapshot);
+    put_section(ctx, &w, SNAP_TIMERS,     timers_snapshot);
+    put_section(ctx, &w, SNAP_INTERRUPTS, interrupt_snapshot);
+    put_section(ctx, &w, SNAP_IO,         io_buffer_snapshot);
+    pthread_rwlock_unlock(&sn->gate);
+    long pause = now_us() - t0;
+
+    // Segment prefixes recorded above are immutable: copy them now
+    put_section(ctx, &w, SNAP_SEGMENTS, io_buffer_snapshot_segments);
+
+    char msg[192];
+    if (w.failed) {
+        free(w.data);
+        log_event(ctx, "ERROR", "SNAPSHOT", "Snapshot skipped: state could not be captured");
+        return;
+    }
+
+    h.magic         = SNAPSHOT_MAGIC;
+    h.version       = SNAPSHOT_VERSION;
+    h.layout        = layout_signature();
+    h.payload_bytes = w.len - sizeof(h);
+    h.crc           = store_crc32(0, w.data + sizeof(h), h.payload_bytes);
+    h.created_ms    = wall_ms();
+    h.num_students  = ctx->config.num_students;
+    h.memory_frames = ctx->config.memory_frames;
+    h.io_shards     = ctx->config.io_shards;
+    h.seed          = ctx->config.seed;
+    memcpy(w.data, &h, sizeof(h));
+
+    char dir[160], path[192];
+    snprintf(dir,  sizeof(dir),  "%s/" SNAPSHOT_DIR, ctx->config.output_dir);
+    snprintf(path, sizeof(path), "%s/snap-%06d.bin", dir, h.tick);
+    mkdir(dir, 0755);
+    int rc = write_file(path, w.data, w.len);
+    long took_ms = (now_us() - t0 - pause) / 1000;
+    free(w.data);
+
+    if (rc != 0) {
+        snprintf(msg, sizeof(msg), "Snapshot at tick %d could not be written to %.128s", h.tick, path);
+        log_event(ctx, "ERROR", "SNAPSHOT", msg);
+        return;
+    }
+    hist_record(&sn->pause_hist, pause);
+    hist_record(&sn->write_hist, took_ms);
+    sn->taken++;
+    sn->last_tick  = h.tick;
+    sn->last_bytes = (long)w.len;
+
+    snprintf(msg, sizeof(msg), "Snapshot at tick %d: %ld KB, world stopped %ld us, written in %ld ms",
+             h.tick, sn->last_bytes / 1024, pause, took_ms);
+    log_event(ctx, "INFO", "SNAPSHOT", msg);
+}
+
+// ─── Snapshot thread ─────────────────────────────────────
+// Every SNAPSHOT_TICKS ticks, counted from tick 0 — a restored run
+// keeps the original schedule rather than re-taking its start tick
+void *snapshot_thread(void *arg) {
+    SimContext *ctx = arg;
+    int every = ctx->config.snapshot_ticks;
+    int next  = -1;
+
+    // Woken as each tick completes, so a snapshot always sits between
+    // two ticks; a slow one can skip a boundary but never shifts it
+    int tick = -1;
+    while ((tick = tick_clock_wait(ctx, tick)) >= 0) {
+        if (next < 0) next = (tick / every + 1) * every;
+        if (tick >= next) {
+            snapshot_take(ctx);
+            next = (tick / every + 1) * every;
+        }
+    }
+    return NULL;
+}
+
+void snapshot_stats(SimContext *ctx, SnapshotStats *out) {
+    Snapshotter *sn = ctx->snap;
+    out->taken         = sn->taken;
+    out->last_tick     = sn->last_tick;
+    out->last_bytes    = sn->last_bytes;
+    out->pause_p50_us  = hist_percentile(&sn->pause_hist, 50.0);
+    out->pause_max_us  = sn->pause_hist.max;
+    out->write_p99_ms  = hist_percentile(&sn->write_hist, 99.0);
+    out->restored_tick = sn->restored_tick;
+}
+
+// ─── Restore ─────────────────────────────────────────────
+static Snapshot *refuse(Snapshot *s, FILE *f, const char *why) {
+    fprintf(stderr, "  Cannot restore %s: %s\n", s->path, why);
+    if (f) fclose(f);
+    free(s->payload);
+    free(s);
+    return NULL;
+}
+
+// Everything is checked before any subsystem is touched: a bad file
+// leaves the previous run's outputs alone
+Snapshot *snapshot_load(const char *path, const Config *cfg) {
+    Snapshot *s = calloc(1, sizeof(Snapshot));
+    if (!s) return NULL;
+    snprintf(s->path, sizeof(s->path), "%s", path);
+
+    FILE *f = fopen(path, "rb");
+    if (!f) return refuse(s, NULL, strerror(errno));
+
+    SnapshotHeader *h = &s->hdr;
+    if (fread(h, sizeof(*h), 1, f) != 1 || h->magic != SNAPSHOT_MAGIC)
+        return refuse(s, f, "not a snapshot file");
+    if (h->version != SNAPSHOT_VERSION)
+        return refuse(s, f, "unsupported snapshot version");
+    if (h->layout != layout_signature())
+        return refuse(s, f, "written by an incompatible build");
+
+    s->payload = malloc(h->payload_bytes ? h->payload_bytes : 1);
+    if (!s->payload || fread(s->payload, 1, h->payload_bytes, f) != h->payload_bytes)
+        return refuse(s, f, "file is truncated");
+    fclose(f);
+    if (store_crc32(0, s->payload, h->payload_bytes) != h->crc)
+        return refuse(s, NULL, "checksum mismatch");
+
+    char why[128];
+    if (h->num_students != cfg->num_students || h->memory_frames != cfg->memory_frames ||
+        h->io_shards != cfg->io_shards) {
+        snprintf(why, sizeof(why),
+                 "taken with %d students, %d frames, %d I/O shards (this run: %d, %d, %d)",
+                 h->num_students, h->memory_frames, h->io_shards,
+                 cfg->num_students, cfg->memory_frames, cfg->io_shards);
+        return refuse(s, NULL, why);
+    }
+
+    size_t pos = 0;
+    while (pos + sizeof(SnapSectionHeader) <= h->payload_bytes) {
+        SnapSectionHeader sh;
+        memcpy(&sh, s->payload + pos, sizeof(sh));
+        pos += sizeof(sh);
+        if (sh.len > h->payload_bytes - pos)
+            return refuse(s, NULL, "section runs past the end of the file");
+        if (sh.id > 0 && sh.id < SNAP_SECTIONS) {
+            s->sections[sh.id].data = s->payload + pos;
+            s->sections[sh.id].len  = sh.len;
+        }
+        pos += sh.len;
+    }
+    for (int id = 1; id < SNAP_SECTIONS; id++) {
+        if (s->sections[id].data) continue;
+        snprintf(why, sizeof(why), "section %d is missing", id);
+        return refuse(s, NULL, why);
+    }
+    return s;
+}
+
+int snapshot_tick(const Snapshot *s) {
+    return s->hdr.tick;
+}
+
+uint64_t snapshot_seed(const Snapshot *s) {
+    return s->hdr.seed;
+}
+
+// Sections go back in dependency order, not file order: the segments
+// before the I/O section re-queues what was still in the rings
+int snapshot_apply(SimContext *ctx, Snapshot *s) {
+    static const struct {
+        SnapSection id;
+        void      (*restore)(SimContext *, SnapReader *);
+    } order[] = {
+        { SNAP_STATE,      state_restore },
+        { SNAP_PROCS,      procs_restore },
+        { SNAP_SCHEDULER,  scheduler_restore },
+        { SNAP_ADMISSION,  admission_restore },
+        { SNAP_MEMORY,     memory_restore },
+        { SNAP_TIMERS,     timers_restore },
+        { SNAP_INTERRUPTS, interrupt_restore },
+        { SNAP_SEGMENTS,   io_buffer_restore_segments },
+        { SNAP_IO,         io_buffer_restore },
+    };
+
+    long rebase = now_us() - s->hdr.mono_us;
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        SnapReader r = s->sections[order[i].id];
+        r.rebase_us = rebase;
+        order[i].restore(ctx, &r);
+        if (r.failed) {
+            fprintf(stderr, "  Cannot restore %s: section %d is malformed\n",
+                    s->path, order[i].id);
+            return -1;
+        }
+    }
+    ctx->snap->restored_tick = s->hdr.tick;
+
+    char msg[192];
+    snprintf(msg, sizeof(msg), "Restored tick %d from %.128s (%lu KB)",
+             s->hdr.tick, s->path, (unsigned long)(s->hdr.payload_bytes / 1024));
+    log_event(ctx, "WARN", "SNAPSHOT", msg);
+    return 0;
+}
+
+void snapshot_free(Snapshot *s) {
+    if (!s) return;
+    free(s->payload);
+    free(s);
+}
@@ -0,0 +1,670 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include "submission_store.h"
+
+#define INDEX_MIN_CAPACITY 1024
+#define STORE_IOV          1024     // iovecs per writev (IOV_MAX on Linux)
+#define COPY_BUFFER        (64 * 1024)
+
+// Per-segment bookkeeping, indexed by segment id
+typedef struct {
+    uint32_t live;       // index slots pointing into it
+    uint32_t total;      // records written to it
+    uint32_t bytes;      // file size
+    int      present;    // on disk
+} SegInfo;
+
+struct SubmissionStore {
+    char               dir[128];
+    long               segment_bytes;
+    int                fd;            // active segment: appender only
+    uint32_t           active;
+    uint32_t           active_bytes;  // appender's copy of segs[active].bytes
+    uint32_t           next_id;
+    uint64_t           seq;
+    StoreIndexSlot    *slots;
+    uint32_t           capacity, count;
+    SegInfo           *segs;
+    uint32_t           segs_cap;
+    pthread_mutex_t    lock;          // index + segs: appender vs compactor
+    pthread_mutex_t    compact_lock;  // one compaction at a time
+    StoreRecordHeader *hdrs;          // append scratch
+    uint32_t          *offsets;
+    struct iovec      *iov;
+    int                scratch_cap;
+    long               records, compactions, reclaimed;
+};
+
+// ─── CRC-32 (IEEE, reflected) ────────────────────────────
+static uint32_t crc_table[256];
+
+static void crc_init() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crc_table[i] = c;
+    }
+}
+
+uint32_t store_crc32(uint32_t crc, const void *data, size_t len) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, crc_init);
+    const unsigned char *p = data;
+    crc = ~crc;
+    while (len--) crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// CRC covers everything in the header after the crc field, then the answer
+static uint32_t record_crc(const StoreRecordHeader *h, const void *answer) {
+    const size_t skip = offsetof(StoreRecordHeader, pid);
+    uint32_t crc = store_crc32(0, (const char *)h + skip, sizeof(*h) - skip);
+    return store_crc32(crc, answer, h->len);
+}
+
+// ─── Helpers ──────────────────────────────────────────────
+static long now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+static int write_all(int fd, struct iovec *iov, int cnt) {
+    while (cnt > 0) {
+        ssize_t w = writev(fd, iov, cnt > STORE_IOV ? STORE_IOV : cnt);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (cnt > 0 && (size_t)w >= iov->iov_len) {
+            w -= iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + w;
+            iov->iov_len -= w;
+        }
+    }
+    return 0;
+}
+
+static void segment_path(char *out, size_t len, const char *dir, uint32_t id) {
+    snprintf(out, len, "%s/seg-%06u.dat", dir, id);
+}
+
+static int mkdir_p(const char *path) {
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        mkdir(tmp, 0755);
+        *p = '/';
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+// ─── Index: open addressing, linear probing ──────────────
+static uint32_t key_hash(int pid, int qid) {
+    uint32_t h = (uint32_t)pid * 0x9E3779B1u ^ (uint32_t)qid * 0x85EBCA77u;
+    return h ^ (h >> 15);
+}
+
+// Slot holding (pid, qid), or the empty slot where it would go
+static uint32_t probe(const StoreIndexSlot *slots, uint32_t mask, int pid, int qid) {
+    uint32_t i = key_hash(pid, qid) & mask;
+    while (slots[i].pid != 0 &&
+           (slots[i].pid != pid || slots[i].question_id != qid))
+        i = (i + 1) & mask;
+    return i;
+}
+
+static void index_grow(SubmissionStore *s) {
+    uint32_t        cap   = s->capacity * 2;
+    StoreIndexSlot *slots = calloc(cap, sizeof(StoreIndexSlot));
+    if (!slots) return;
+    for (uint32_t i = 0; i < s->capacity; i++) {
+        if (s->slots[i].pid == 0) continue;
+        slots[probe(slots, cap - 1, s->slots[i].pid, s->slots[i].question_id)] = s->slots[i];
+    }
+    free(s->slots);
+    s->slots    = slots;
+    s->capacity = cap;
+}
+
+// Caller holds s->lock
+static int ensure_seg(SubmissionStore *s, uint32_t id) {
+    if (id < s->segs_cap) return 0;
+    uint32_t cap = s->segs_cap ? s->segs_cap : 16;
+    while (cap <= id) cap *= 2;
+    SegInfo *segs = realloc(s->segs, sizeof(SegInfo) * cap);
+    if (!segs) return -1;
+    memset(segs + s->segs_cap, 0, sizeof(SegInfo) * (cap - s->segs_cap));
+    s->segs     = segs;
+    s->segs_cap = cap;
+    return 0;
+}
+
+// Write index.tmp, sync it, rename over index.dat: readers see either
+// the old index or the new one, never a torn one
+static int persist_index(SubmissionStore *s) {
+    pthread_mutex_lock(&s->lock);
+    StoreIndexHeader hdr = { STORE_INDEX_MAGIC, STORE_VERSION, s->capacity, s->count, 0, s->seq };
+    for (uint32_t i = 0; i < s->segs_cap; i++)
+        if (s->segs[i].present) hdr.data_bytes += s->segs[i].bytes;
+    size_t          len  = sizeof(StoreIndexSlot) * s->capacity;
+    StoreIndexSlot *copy = malloc(len);
+    if (copy) memcpy(copy, s->slots, len);
+    pthread_mutex_unlock(&s->lock);
+    if (!copy) return -1;
+
+    char tmp[160], path[160];
+    snprintf(tmp,  sizeof(tmp),  "%s/index.tmp", s->dir);
+    snprintf(path, sizeof(path), "%s/index.dat", s->dir);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int rc = -1;
+    if (fd >= 0) {
+        struct iovec iov[2] = { { &hdr, sizeof(hdr) }, { copy, len } };
+        if (write_all(fd, iov, 2) == 0 && fdatasync(fd) == 0) rc = 0;
+        close(fd);
+        if (rc == 0) rc = rename(tmp, path);
+    }
+    free(copy);
+    return rc;
+}
+
+// ─── Segments ────────────────────────────────────────────
+static int open_segment(SubmissionStore *s, uint32_t id) {
+    char path[160];
+    segment_path(path, sizeof(path), s->dir, id);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) return -1;
+    StoreSegmentHeader hdr = { STORE_MAGIC, STORE_VERSION, id, 0, now_ms() };
+    if (write(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Seal the active segment and start the next one (appender only)
+static void roll_segment(SubmissionStore *s) {
+    pthread_mutex_lock(&s->lock);
+    uint32_t id = s->next_id++;
+    int ok = ensure_seg(s, id) == 0;
+    pthread_mutex_unlock(&s->lock);
+    if (!ok) return;
+
+    int fd = open_segment(s, id);
+    if (fd < 0) return;   // keep appending to the old one
+    close(s->fd);
+
+    pthread_mutex_lock(&s->lock);
+    s->fd           = fd;
+    s->active       = id;
+    s->active_bytes = sizeof(StoreSegmentHeader);
+    s->segs[id].present = 1;
+    s->segs[id].bytes   = s->active_bytes;
+    pthread_mutex_unlock(&s->lock);
+
+    persist_index(s);
+}
+
+static const StoreRecordHeader *record_at(const StoreReader *r, uint32_t seg, uint32_t off);
+
+// ─── Writer ──────────────────────────────────────────────
+// Resume: adopt the segments already in dir. Keys come from the index
+// (or a rebuild when it is stale); per-segment counts from a scan.
+static void resume_segments(SubmissionStore *s) {
+    StoreReader r;
+    if (store_reader_open(&r, s->dir) != 0) return;
+
+    for (uint32_t id = 0; id < r.nsegs; id++) {
+        if (!r.seg_base[id] || ensure_seg(s, id) != 0) continue;
+        s->segs[id].present = 1;
+        s->segs[id].bytes   = r.seg_len[id];
+        s->next_id = id + 1;
+        size_t at = sizeof(StoreSegmentHeader);
+        const StoreRecordHeader *h;
+        while ((h = record_at(&r, id, at)) && record_crc(h, h + 1) == h->crc) {
+            s->segs[id].total++;
+            if (h->seq > s->seq) s->seq = h->seq;
+            at += sizeof(*h) + h->len;
+        }
+    }
+    for (uint32_t i = 0; i <= r.mask; i++) {
+        const StoreIndexSlot *slot = &r.slots[i];
+        if (slot->pid == 0 || slot->segment >= s->segs_cap || !s->segs[slot->segment].present)
+            continue;
+        if ((s->count + 1) * 2 > s->capacity) index_grow(s);
+        s->slots[probe(s->slots, s->capacity - 1, slot->pid, slot->question_id)] = *slot;
+        s->segs[slot->segment].live++;
+        s->count++;
+    }
+    store_reader_close(&r);
+}
+
+// A fresh store removes anything an earlier run left in dir; resume
+// keeps it and appends to a new segment after the existing ones
+SubmissionStore *store_open(const char *dir, long segment_bytes, int resume) {
+    if (mkdir_p(dir) != 0) return NULL;
+
+    DIR *d = resume ? NULL : opendir(dir);
+    if (d) {
+        struct dirent *e;
+        while ((e = readdir(d))) {
+            if (strncmp(e->d_name, "seg-", 4) != 0 && strncmp(e->d_name, "index.", 6) != 0)
+                continue;
+            char path[400];
+            snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+            unlink(path);
+        }
+        closedir(d);
+    }
+
+    SubmissionStore *s = calloc(1, sizeof(SubmissionStore));
+    if (!s) return NULL;
+    snprintf(s->dir, sizeof(s->dir), "%s", dir);
+    s->segment_bytes = segment_bytes > 4096 ? segment_bytes : 4096;
+    s->capacity      = INDEX_MIN_CAPACITY;
+    s->slots         = calloc(s->capacity, sizeof(StoreIndexSlot));
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_mutex_init(&s->compact_lock, NULL);
+
+    if (s->slots && resume) resume_segments(s);
+
+    uint32_t id = s->next_id;
+    s->fd = open_segment(s, id);
+    if (s->fd < 0 || !s->slots || ensure_seg(s, id) != 0) {
+        store_close(s);
+        return NULL;
+    }
+    s->active       = id;
+    s->next_id      = id + 1;
+    s->active_bytes = sizeof(StoreSegmentHeader);
+    s->segs[id].present = 1;
+    s->segs[id].bytes   = s->active_bytes;
+    return s;
+}
+
+// Append n records with one writev, then point their keys at them.
+// answers[i] holds subs[i].answer.len bytes.
+int store_append(SubmissionStore *s, const Submission *subs,
+                 const char *const *answers, int n) {
+    if (!s || n <= 0) return 0;
+    if (n > s->scratch_cap) {
+        free(s->hdrs);
+        free(s->offsets);
+        free(s->iov);
+        s->hdrs    = malloc(sizeof(StoreRecordHeader) * n);
+        s->offsets = malloc(sizeof(uint32_t) * n);
+        s->iov     = malloc(sizeof(struct iovec) * 2 * n);
+        s->scratch_cap = (s->hdrs && s->offsets && s->iov) ? n : 0;
+        if (!s->scratch_cap) return -1;
+    }
+
+    uint32_t off = s->active_bytes;
+    for (int i = 0; i < n; i++) {
+        StoreRecordHeader *h = &s->hdrs[i];
+        memset(h, 0, sizeof(*h));
+        h->len         = subs[i].answer.len;
+        h->pid         = subs[i].pid;
+        h->question_id = subs[i].question_id;
+        h->timestamp   = subs[i].timestamp;
+        h->seq         = ++s->seq;
+        h->flags       = subs[i].is_partial ? STORE_PARTIAL : 0;
+        h->crc         = record_crc(h, answers[i]);
+
+        s->offsets[i]         = off;
+        s->iov[2 * i]     = (struct iovec){ h, sizeof(*h) };
+        s->iov[2 * i + 1] = (struct iovec){ (void *)answers[i], h->len };
+        off += sizeof(*h) + h->len;
+    }
+    if (write_all(s->fd, s->iov, 2 * n) != 0) return -1;
+    s->active_bytes = off;
+    s->records     += n;
+
+    pthread_mutex_lock(&s->lock);
+    for (int i = 0; i < n; i++) {
+        if ((s->count + 1) * 2 > s->capacity) index_grow(s);
+        StoreIndexSlot *slot = &s->slots[probe(s->slots, s->capacity - 1,
+                                               subs[i].pid, subs[i].question_id)];
+        if (slot->pid != 0) s->segs[slot->segment].live--;
+        else                s->count++;
+        slot->pid         = subs[i].pid;
+        slot->question_id = subs[i].question_id;
+        slot->segment     = s->active;
+        slot->offset      = s->offsets[i];
+    }
+    s->segs[s->active].live  += n;
+    s->segs[s->active].total += n;
+    s->segs[s->active].bytes  = off;
+    pthread_mutex_unlock(&s->lock);
+
+    if ((long)off >= s->segment_bytes) roll_segment(s);
+    return 0;
+}
+
+int store_sync(SubmissionStore *s) {
+    return s ? fdatasync(s->fd) : 0;
+}
+
+// ─── Compaction ──────────────────────────────────────────
+// Sealed segments that are at least half dead are rewritten into one
+// new segment holding only the records their keys still point at.
+// Appends continue meanwhile: a key overwritten during the copy keeps
+// its newer slot, and the stale copy is simply dead in the output.
+typedef struct {
+    int32_t  pid, qid;
+    uint32_t from_seg, from_off, to_off;
+} MovedRecord;
+
+int store_compact(SubmissionStore *s) {
+    if (!s) return 0;
+    pthread_mutex_lock(&s->compact_lock);
+
+    pthread_mutex_lock(&s->lock);
+    uint32_t *victims = malloc(sizeof(uint32_t) * (s->segs_cap ? s->segs_cap : 1));
+    int       nvict   = 0;
+    for (uint32_t id = 0; victims && id < s->segs_cap; id++) {
+        SegInfo *g = &s->segs[id];
+        if (id != s->active && g->present && g->total > 0 && g->live * 2 <= g->total)
+            victims[nvict++] = id;
+    }
+    uint32_t out_id = s->next_id;
+    int ok = nvict > 0 && ensure_seg(s, out_id) == 0;
+    if (ok) s->next_id++;
+    pthread_mutex_unlock(&s->lock);
+    if (!ok) {
+        free(victims);
+        pthread_mutex_unlock(&s->compact_lock);
+        return 0;
+    }
+
+    int          out    = open_segment(s, out_id);
+    uint32_t     out_at = sizeof(StoreSegmentHeader);
+    MovedRecord *moved  = NULL;
+    int          nmoved = 0, cap_moved = 0;
+    char        *buf    = malloc(COPY_BUFFER);
+    size_t       buffered = 0;
+
+    for (int v = 0; out >= 0 && buf && v < nvict; v++) {
+        char path[160];
+        segment_path(path, sizeof(path), s->dir, victims[v]);
+        int fd = open(path, O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) close(fd);
+            continue;
+        }
+        char *map = st.st_size > 0
+                    ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (map == MAP_FAILED) continue;
+
+        size_t at = sizeof(StoreSegmentHeader);
+        while (at + sizeof(StoreRecordHeader) <= (size_t)st.st_size) {
+            const StoreRecordHeader *h = (const StoreRecordHeader *)(map + at);
+            size_t rec = sizeof(*h) + h->len;
+            if (at + rec > (size_t)st.st_size || record_crc(h, h + 1) != h->crc) break;
+
+            pthread_mutex_lock(&s->lock);
+            const StoreIndexSlot *slot = &s->slots[probe(s->slots, s->capacity - 1,
+                                                         h->pid, h->question_id)];
+            int live = slot->segment == victims[v] && slot->offset == at;
+            pthread_mutex_unlock(&s->lock);
+
+            if (live) {
+                if (nmoved == cap_moved) {
+                    cap_moved = cap_moved ? cap_moved * 2 : 256;
+                    MovedRecord *m = realloc(moved, sizeof(MovedRecord) * cap_moved);
+                    if (!m) break;
+                    moved = m;
+                }
+                moved[nmoved++] = (MovedRecord){ h->pid, h->question_id,
+                                                 victims[v], (uint32_t)at, out_at };
+                if (buffered + rec > COPY_BUFFER) {
+                    if (write(out, buf, buffered) != (ssize_t)buffered) out_at = 0;
+                    buffered = 0;
+                }
+                if (rec > COPY_BUFFER) {
+                    if (write(out, h, rec) != (ssize_t)rec) out_at = 0;
+                } else {
+                    memcpy(buf + buffered, h, rec);
+                    buffered += rec;
+                }
+                out_at += rec;
+            }
+            at += rec;
+        }
+        munmap(map, st.st_size);
+    }
+    if (out >= 0 && buffered > 0 && write(out, buf, buffered) != (ssize_t)buffered) out_at = 0;
+    free(buf);
+
+    // A failed copy leaves everything as it was
+    if (out < 0 || out_at == 0 || fdatasync(out) != 0) {
+        if (out >= 0) close(out);
+        char path[160];
+        segment_path(path, sizeof(path), s->dir, out_id);
+        unlink(path);
+        free(moved);
+        free(victims);
+        pthread_mutex_unlock(&s->compact_lock);
+        return 0;
+    }
+    close(out);
+
+    long reclaimed = 0;
+    pthread_mutex_lock(&s->lock);
+    for (int i = 0; i < nmoved; i++) {
+        StoreIndexSlot *slot = &s->slots[probe(s->slots, s->capacity - 1,
+                                               moved[i].pid, moved[i].qid)];
+        if (slot->segment != moved[i].from_seg || slot->offset != moved[i].from_off)
+            continue;   // overwritten during the copy
+        slot->segment = out_id;
+        slot->offset  = moved[i].to_off;
+        s->segs[moved[i].from_seg].live--;
+        s->segs[out_id].live++;
+    }
+    s->segs[out_id].present = 1;
+    s->segs[out_id].total   = nmoved;
+    s->segs[out_id].bytes   = out_at;
+    for (int v = 0; v < nvict; v++) {
+        reclaimed += s->segs[victims[v]].bytes;
+        memset(&s->segs[victims[v]], 0, sizeof(SegInfo));
+    }
+    reclaimed -= out_at;
+    s->reclaimed += reclaimed;
+    s->compactions++;
+    pthread_mutex_unlock(&s->lock);
+
+    // Unlink first, then persist: an index written before the unlink
+    // would cover bytes no longer on disk and look stale to readers
+    for (int v = 0; v < nvict; v++) {
+        char path[160];
+        segment_path(path, sizeof(path), s->dir, victims[v]);
+        unlink(path);
+    }
+    persist_index(s);
+
+    free(moved);
+    free(victims);
+    pthread_mutex_unlock(&s->compact_lock);
+    return 1;
+}
+
+void store_stats(SubmissionStore *s, StoreStats *out) {
+    memset(out, 0, sizeof(StoreStats));
+    if (!s) return;
+    pthread_mutex_lock(&s->lock);
+    out->records         = s->records;
+    out->live            = s->count;
+    out->compactions     = s->compactions;
+    out->reclaimed_bytes = s->reclaimed;
+    for (uint32_t i = 0; i < s->segs_cap; i++) out->segments += s->segs[i].present;
+    pthread_mutex_unlock(&s->lock);
+}
+
+void store_close(SubmissionStore *s) {
+    if (!s) return;
+    pthread_mutex_lock(&s->compact_lock);   // let a running compaction finish
+    if (s->fd >= 0) {
+        fdatasync(s->fd);
+        close(s->fd);
+        if (s->slots) persist_index(s);
+    }
+    pthread_mutex_unlock(&s->compact_lock);
+
+    pthread_mutex_destroy(&s->lock);
+    pthread_mutex_destroy(&s->compact_lock);
+    free(s->slots);
+    free(s->segs);
+    free(s->hdrs);
+    free(s->offsets);
+    free(s->iov);
+    free(s);
+}
+
+// ─── Reader ──────────────────────────────────────────────
+static const StoreRecordHeader *record_at(const StoreReader *r, uint32_t seg, uint32_t off) {
+    if (seg >= r->nsegs || !r->seg_base[seg]) return NULL;
+    if ((size_t)off + sizeof(StoreRecordHeader) > r->seg_len[seg]) return NULL;
+    const StoreRecordHeader *h = (const StoreRecordHeader *)(r->seg_base[seg] + off);
+    if ((size_t)off + sizeof(*h) + h->len > r->seg_len[seg]) return NULL;
+    return h;
+}
+
+// index.dat missing or stale (crash since the last persist): rebuild
+// from the segments, keeping the highest seq per key and stopping at
+// the first torn or corrupt record of each segment
+static int rebuild_index(StoreReader *r) {
+    size_t records = 0;
+    for (uint32_t id = 0; id < r->nsegs; id++)
+        if (r->seg_base[id]) records += r->seg_len[id] / sizeof(StoreRecordHeader);
+    uint32_t cap = INDEX_MIN_CAPACITY;
+    while (cap < records * 2) cap *= 2;
+    r->rebuilt = calloc(cap, sizeof(StoreIndexSlot));
+    if (!r->rebuilt) return -1;
+    r->mask = cap - 1;
+
+    for (uint32_t id = 0; id < r->nsegs; id++) {
+        if (!r->seg_base[id]) continue;
+        size_t at = sizeof(StoreSegmentHeader);
+        const StoreRecordHeader *h;
+        while ((h = record_at(r, id, at)) && record_crc(h, h + 1) == h->crc) {
+            StoreIndexSlot *slot = &r->rebuilt[probe(r->rebuilt, r->mask, h->pid, h->question_id)];
+            const StoreRecordHeader *cur = slot->pid ? record_at(r, slot->segment, slot->offset) : NULL;
+            if (!cur || h->seq > cur->seq)
+                *slot = (StoreIndexSlot){ h->pid, h->question_id, id, (uint32_t)at };
+            at += sizeof(*h) + h->len;
+        }
+    }
+    r->slots = r->rebuilt;
+    return 0;
+}
+
+static void *map_file(const char *path, size_t *len) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    *len = st.st_size;
+    return map;
+}
+
+int store_reader_open(StoreReader *r, const char *dir) {
+    memset(r, 0, sizeof(StoreReader));
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+
+    // Map every segment, by id
+    struct dirent *e;
+    uint64_t total = 0;
+    while ((e = readdir(d))) {
+        unsigned id;
+        if (sscanf(e->d_name, "seg-%u.dat", &id) != 1) continue;
+        if (id >= r->nsegs) {
+            uint32_t n = id + 16;
+            const char **base = realloc(r->seg_base, sizeof(char *) * n);
+            size_t      *len  = base ? realloc(r->seg_len, sizeof(size_t) * n) : NULL;
+            if (base) r->seg_base = base;
+            if (!len) continue;
+            r->seg_len = len;
+            for (uint32_t i = r->nsegs; i < n; i++) {
+                r->seg_base[i] = NULL;
+                r->seg_len[i]  = 0;
+            }
+            r->nsegs = n;
+        }
+        char path[400];
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        size_t len = 0;
+        const char *map = map_file(path, &len);
+        if (!map) continue;
+        const StoreSegmentHeader *sh = (const StoreSegmentHeader *)map;
+        if (len < sizeof(*sh) || sh->magic != STORE_MAGIC || sh->version != STORE_VERSION) {
+            munmap((void *)map, len);
+            continue;
+        }
+        r->seg_base[id] = map;
+        r->seg_len[id]  = len;
+        total += len;
+    }
+    closedir(d);
+
+    char path[400];
+    snprintf(path, sizeof(path), "%s/index.dat", dir);
+    r->index_map = map_file(path, &r->index_len);
+    const StoreIndexHeader *ih = r->index_map;
+    if (ih && r->index_len >= sizeof(*ih) && ih->magic == STORE_INDEX_MAGIC &&
+        ih->version == STORE_VERSION && ih->data_bytes == total &&
+        r->index_len == sizeof(*ih) + sizeof(StoreIndexSlot) * (size_t)ih->capacity) {
+        r->slots = (const StoreIndexSlot *)(ih + 1);
+        r->mask  = ih->capacity - 1;
+        return 0;
+    }
+    return rebuild_index(r);
+}
+
+int store_lookup(const StoreReader *r, int pid, int question_id, StoreRecord *out) {
+    if (!r->slots) return -1;
+    const StoreIndexSlot *slot = &r->slots[probe(r->slots, r->mask, pid, question_id)];
+    if (slot->pid == 0) return -1;
+    const StoreRecordHeader *h = record_at(r, slot->segment, slot->offset);
+    if (!h || record_crc(h, h + 1) != h->crc) return -2;
+
+    out->pid         = h->pid;
+    out->question_id = h->question_id;
+    out->timestamp   = h->timestamp;
+    out->seq         = h->seq;
+    out->is_partial  = (h->flags & STORE_PARTIAL) != 0;
+    out->answer      = (const char *)(h + 1);
+    out->len         = h->len;
+    return 0;
+}
+
+void store_reader_close(StoreReader *r) {
+    for (uint32_t i = 0; i < r->nsegs; i++)
+        if (r->seg_base[i]) munmap((void *)r->seg_base[i], r->seg_len[i]);
+    if (r->index_map) munmap(r->index_map, r->index_len);
+    free(r->seg_base);
+    free(r->seg_len);
+    free(r->rebuilt);
+    memset(r, 0, sizeof(StoreReader));
+}
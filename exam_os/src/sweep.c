@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "sweep.h"
+#include "config.h"
+#include "sim.h"
+
+typedef struct {
+    char key[64];
+    char values[SWEEP_MAX_VALUES][64];
+    int  count;
+} SweepAxis;
+
+typedef struct {
+    Config     cfg;
+    char       label[256];        // "KEY=value KEY=value"
+    int        value_idx[SWEEP_MAX_KEYS];
+    int        ok;
+    long       wall_ms;
+    SimMetrics m;
+} SweepRun;
+
+typedef struct {
+    const SweepAxis *axes;
+    int              naxes;
+    SweepRun        *runs;
+    int              nruns;
+    int              next;        // atomic: next run to start
+    int              finished;
+    pthread_mutex_t  print_lock;
+} Sweep;
+
+// ─── Timestamp ────────────────────────────────────────────
+static long now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+// ─── Grid file: KEY = v1, v2, ... ─────────────────────────
+static int parse_grid(const char *path, SweepAxis *axes) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "  Cannot open sweep grid %s\n", path);
+        return -1;
+    }
+    char line[1024];
+    int  n = 0, lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *eq = strchr(line, '=');
+        if (!eq) {
+            if (*trim(line)) goto bad;
+            continue;
+        }
+        *eq = '\0';
+        char *key = trim(line);
+        if (n == SWEEP_MAX_KEYS) {
+            fprintf(stderr, "  %s:%d: at most %d keys\n", path, lineno, SWEEP_MAX_KEYS);
+            goto fail;
+        }
+
+        // Unknown keys, and ones a sweep sets itself, are mistakes
+        Config scratch;
+        config_load_defaults(&scratch);
+        if (!*key || strcmp(key, "OUTPUT_DIR") == 0 || strcmp(key, "SWEEP_JOBS") == 0 ||
+            !config_set(&scratch, key, "0")) {
+            fprintf(stderr, "  %s:%d: cannot sweep '%s'\n", path, lineno, key);
+            goto fail;
+        }
+
+        SweepAxis *a = &axes[n];
+        snprintf(a->key, sizeof(a->key), "%s", key);
+        a->count = 0;
+        char *save = NULL;
+        for (char *v = strtok_r(eq + 1, ",", &save); v; v = strtok_r(NULL, ",", &save)) {
+            v = trim(v);
+            if (!*v) continue;
+            if (a->count == SWEEP_MAX_VALUES) {
+                fprintf(stderr, "  %s:%d: at most %d values\n", path, lineno, SWEEP_MAX_VALUES);
+                goto fail;
+            }
+            snprintf(a->values[a->count++], sizeof(a->values[0]), "%s", v);
+        }
+        if (a->count == 0) goto bad;
+        n++;
+    }
+    fclose(f);
+    if (n == 0) fprintf(stderr, "  %s: no KEY = values lines\n", path);
+    return n > 0 ? n : -1;
+
+bad:
+    fprintf(stderr, "  %s:%d: expected KEY = value, value, ...\n", path, lineno);
+fail:
+    fclose(f);
+    return -1;
+}
+
+// ─── Worker: take the next combination until none are left ─
+static void *sweep_worker(void *arg) {
+    Sweep *sw = arg;
+    while (1) {
+        int i = __atomic_fetch_add(&sw->next, 1, __ATOMIC_RELAXED);
+        if (i >= sw->nruns) break;
+        SweepRun *r = &sw->runs[i];
+
+        long t0 = now_ms();
+        SimContext *ctx = sim_create(&r->cfg);
+        if (ctx) {
+            sim_run(ctx);
+            sim_metrics(ctx, &r->m);
+            sim_destroy(ctx);
+            r->ok = 1;
+        }
+        r->wall_ms = now_ms() - t0;
+
+        pthread_mutex_lock(&sw->print_lock);
+        sw->finished++;
+        if (r->ok) {
+            int total = r->m.page_hits + r->m.page_faults;
+            printf("  [%3d/%d] run-%03d  %-40s %3d exams  %5.1f%% hits  %ld dropped  (%.1f s)\n",
+                   sw->finished, sw->nruns, i, r->label, r->m.completed,
+                   total > 0 ? r->m.page_hits * 100.0 / total : 0.0,
+                   r->m.dropped, r->wall_ms / 1000.0);
+        } else {
+            printf("  [%3d/%d] run-%03d  %-40s FAILED\n",
+                   sw->finished, sw->nruns, i, r->label);
+        }
+        fflush(stdout);
+        pthread_mutex_unlock(&sw->print_lock);
+    }
+    return NULL;
+}
+
+// ─── Report ───────────────────────────────────────────────
+static double hit_rate(const SimMetrics *m) {
+    int total = m->page_hits + m->page_faults;
+    return total > 0 ? m->page_hits * 100.0 / total : 0.0;
+}
+
+static double drop_rate(const SimMetrics *m) {
+    long total = m->submitted + m->dropped;
+    return total > 0 ? m->dropped * 100.0 / total : 0.0;
+}
+
+static double subs_per_s(const SweepRun *r) {
+    return r->wall_ms > 0 ? r->m.submitted * 1000.0 / r->wall_ms : 0.0;
+}
+
+static void write_csv(FILE *f, const Sweep *sw) {
+    fprintf(f, "run");
+    for (int k = 0; k < sw->naxes; k++) fprintf(f, ",%s", sw->axes[k].key);
+    fprintf(f, ",ticks,exams,submitted,subs_per_s,hit_rate_pct,page_faults,"
+               "dropped,drop_pct,submit_p50_ns,submit_p99_ns,durable_p50_ms,"
+               "durable_p99_ms,login_wait_p99_ticks,context_switches,timeouts,wall_s\n");
+    for (int i = 0; i < sw->nruns; i++) {
+        const SweepRun   *r = &sw->runs[i];
+        const SimMetrics *m = &r->m;
+        fprintf(f, "%d", i);
+        for (int k = 0; k < sw->naxes; k++)
+            fprintf(f, ",%s", sw->axes[k].values[r->value_idx[k]]);
+        if (!r->ok) {
+            fprintf(f, ",,,,,,,,,,,,,,,,\n");
+            continue;
+        }
+        fprintf(f, ",%d,%d,%ld,%.1f,%.1f,%d,%ld,%.2f,%ld,%ld,%.1f,%.1f,%ld,%d,%d,%.1f\n",
+                m->ticks, m->completed, m->submitted, subs_per_s(r), hit_rate(m),
+                m->page_faults, m->dropped, drop_rate(m),
+                m->submit_p50_ns, m->submit_p99_ns,
+                m->durable_p50_us / 1000.0, m->durable_p99_us / 1000.0,
+                m->login_wait_p99, m->context_switches, m->timeouts,
+                r->wall_ms / 1000.0);
+    }
+}
+
+static void write_markdown(FILE *f, const Sweep *sw) {
+    fprintf(f, "| run |");
+    for (int k = 0; k < sw->naxes; k++) fprintf(f, " %s |", sw->axes[k].key);
+    fprintf(f, " ticks | exams | subs/s | hit %% | dropped | submit p50 / p99 (ns) |"
+               " durable p50 / p99 (ms) | login wait p99 | switches | timeouts |\n|---|");
+    for (int k = 0; k < sw->naxes; k++) fprintf(f, "---|");
+    fprintf(f, "--:|--:|--:|--:|--:|--:|--:|--:|--:|--:|\n");
+    for (int i = 0; i < sw->nruns; i++) {
+        const SweepRun   *r = &sw->runs[i];
+        const SimMetrics *m = &r->m;
+        fprintf(f, "| %03d |", i);
+        for (int k = 0; k < sw->naxes; k++)
+            fprintf(f, " %s |", sw->axes[k].values[r->value_idx[k]]);
+        if (!r->ok) {
+            fprintf(f, " failed | | | | | | | | | |\n");
+            continue;
+        }
+        fprintf(f, " %d | %d | %.1f | %.1f | %ld (%.1f%%) | %ld / %ld | %.1f / %.1f |"
+                   " %ld | %d | %d |\n",
+                m->ticks, m->completed, subs_per_s(r), hit_rate(m),
+                m->dropped, drop_rate(m), m->submit_p50_ns, m->submit_p99_ns,
+                m->durable_p50_us / 1000.0, m->durable_p99_us / 1000.0,
+                m->login_wait_p99, m->context_switches, m->timeouts);
+    }
+}
+
+int sweep_run(const Config *base, const char *grid_path) {
+    SweepAxis axes[SWEEP_MAX_KEYS];
+    int naxes = parse_grid(grid_path, axes);
+    if (naxes < 0) return -1;
+
+    int nruns = 1;
+    for (int k = 0; k < naxes; k++) {
+        nruns *= axes[k].count;
+        if (nruns > SWEEP_MAX_RUNS) {
+            fprintf(stderr, "  Sweep grid has more than %d combinations\n", SWEEP_MAX_RUNS);
+            return -1;
+        }
+    }
+
+    Sweep sw = { .axes = axes, .naxes = naxes, .nruns = nruns };
+    sw.runs = calloc(nruns, sizeof(SweepRun));
+    if (!sw.runs) return -1;
+    pthread_mutex_init(&sw.print_lock, NULL);
+
+    // Combination i: the last key varies fastest
+    for (int i = 0; i < nruns; i++) {
+        SweepRun *r = &sw.runs[i];
+        r->cfg = *base;
+        size_t len = 0;
+        for (int k = naxes - 1, rest = i; k >= 0; k--) {
+            r->value_idx[k] = rest % axes[k].count;
+            rest /= axes[k].count;
+        }
+        for (int k = 0; k < naxes; k++) {
+            const char *val = axes[k].values[r->value_idx[k]];
+            config_set(&r->cfg, axes[k].key, val);
+            len += snprintf(r->label + len, sizeof(r->label) - len, "%s%s=%s",
+                            k ? " " : "", axes[k].key, val);
+            if (len >= sizeof(r->label)) len = sizeof(r->label) - 1;
+        }
+        if (config_check(&r->cfg) != 0) {
+            fprintf(stderr, "  in sweep run %d: %s\n", i, r->label);
+            pthread_mutex_destroy(&sw.print_lock);
+            free(sw.runs);
+            return -1;
+        }
+        r->cfg.headless        = 1;
+        r->cfg.restore_path[0] = '\0';
+        snprintf(r->cfg.output_dir, sizeof(r->cfg.output_dir), "%.100s/sweep/run-%03d",
+                 base->output_dir, i);
+    }
+
+    int jobs = base->sweep_jobs > 0 ? base->sweep_jobs : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (jobs < 1)     jobs = 1;
+    if (jobs > nruns) jobs = nruns;
+
+    printf("  Sweep: %d runs from %s, %d at a time, %d ticks each at most, seed %llu\n\n",
+           nruns, grid_path, jobs, base->exam_duration, (unsigned long long)base->seed);
+
+    long t0 = now_ms();
+    pthread_t *workers = malloc(sizeof(pthread_t) * jobs);
+    for (int j = 0; j < jobs; j++)
+        pthread_create(&workers[j], NULL, sweep_worker, &sw);
+    for (int j = 0; j < jobs; j++)
+        pthread_join(workers[j], NULL);
+    free(workers);
+
+    // ─── Comparison tables ────────────────────────────────
+    int failed = 0;
+    for (int i = 0; i < nruns; i++) failed += !sw.runs[i].ok;
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/sweep/results.csv", base->output_dir);
+    FILE *csv = fopen(path, "w");
+    if (csv) {
+        write_csv(csv, &sw);
+        fclose(csv);
+    }
+    snprintf(path, sizeof(path), "%s/sweep/results.md", base->output_dir);
+    FILE *md = fopen(path, "w");
+    if (md) {
+        write_markdown(md, &sw);
+        fclose(md);
+    }
+
+    printf("\n");
+    write_markdown(stdout, &sw);
+    printf("\n  %d runs (%d failed) in %.1f s\n", nruns, failed, (now_ms() - t0) / 1000.0);
+    printf("    %s/sweep/results.csv\n", base->output_dir);
+    printf("    %s/sweep/results.md\n", base->output_dir);
+    printf("    %s/sweep/run-NNN/     — each run's log, submissions and summary\n\n",
+           base->output_dir);
+
+    pthread_mutex_destroy(&sw.print_lock);
+    free(sw.runs);
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "tick_clock.h"
+
+typedef struct TickClock {
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;      // phase opened/ended, tick completed, stop
+    int       tick;               // tick whose phases are running
+    int       open;               // TickPhase open now, -1 if none
+    int       completed;          // last tick with every phase done
+    int       stopped;
+    long      ticks;
+    long      overruns;
+    long      max_lag_us;
+    Histogram busy_hist;
+    Histogram phase_hist[TICK_PHASES];
+} TickClock;
+
+static const char *phase_names[TICK_PHASES] = {
+    "arrivals", "schedule", "memory", "I/O", "interrupts"
+};
+
+// ─── Timestamp ────────────────────────────────────────────
+static long now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+static long ts_us(const struct timespec *ts) {
+    return ts->tv_sec * 1000000L + ts->tv_nsec / 1000L;
+}
+
+static void ts_add_ms(struct timespec *ts, long ms) {
+    ts->tv_nsec += ms * 1000000L;
+    ts->tv_sec  += ts->tv_nsec / 1000000000L;
+    ts->tv_nsec %= 1000000000L;
+}
+
+void tick_clock_init(SimContext *ctx) {
+    TickClock *c = calloc(1, sizeof(TickClock));
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->changed, NULL);
+    c->open = -1;
+    hist_reset(&c->busy_hist);
+    for (int p = 0; p < TICK_PHASES; p++) hist_reset(&c->phase_hist[p]);
+    ctx->clock = c;
+}
+
+void tick_clock_destroy(SimContext *ctx) {
+    TickClock *c = ctx->clock;
+    pthread_cond_destroy(&c->changed);
+    pthread_mutex_destroy(&c->lock);
+    free(c);
+    ctx->clock = NULL;
+}
+
+static void stop(TickClock *c) {
+    pthread_mutex_lock(&c->lock);
+    c->stopped = 1;
+    pthread_cond_broadcast(&c->changed);
+    pthread_mutex_unlock(&c->lock);
+}
+
+// ─── One tick ─────────────────────────────────────────────
+int tick_clock_tick(SimContext *ctx, const tick_phase_fn run[TICK_PHASES]) {
+    TickClock    *c     = ctx->clock;
+    SystemState  *state = &ctx->state;
+    const Config *cfg   = &ctx->config;
+
+    // 'q' on the dashboard stops the run between ticks
+    pthread_mutex_lock(&state->lock);
+    int running = state->simulation_running;
+    int tick    = running ? ++state->current_tick : state->current_tick;
+    pthread_mutex_unlock(&state->lock);
+    if (!running) {
+        stop(c);
+        return -1;
+    }
+
+    long start = now_us();
+    pthread_mutex_lock(&c->lock);
+    c->tick = tick;
+    for (int p = 0; p < TICK_PHASES; p++) {
+        long phase_start = now_us();
+        if (run) {
+            pthread_mutex_unlock(&c->lock);
+            run[p](ctx, tick);
+            pthread_mutex_lock(&c->lock);
+        } else {
+            c->open = p;
+            pthread_cond_broadcast(&c->changed);
+            while (c->open == p) pthread_cond_wait(&c->changed, &c->lock);
+        }
+        hist_record(&c->phase_hist[p], now_us() - phase_start);
+    }
+    c->completed = tick;
+    c->ticks++;
+    pthread_cond_broadcast(&c->changed);
+    pthread_mutex_unlock(&c->lock);
+    hist_record(&c->busy_hist, now_us() - start);
+
+    // End of the exam, decided between ticks: a run is exactly
+    // EXAM_DURATION ticks unless everyone finishes first
+    pthread_mutex_lock(&state->lock);
+    if (tick >= cfg->exam_duration ||
+        state->completed_processes >= cfg->num_students)
+        state->simulation_running = 0;
+    running = state->simulation_running;
+    pthread_mutex_unlock(&state->lock);
+    if (!running) {
+        stop(c);
+        return -1;
+    }
+    return 0;
+}
+
+void tick_clock_late(SimContext *ctx, long lag_us) {
+    TickClock *c = ctx->clock;
+    pthread_mutex_lock(&c->lock);
+    c->overruns++;
+    if (lag_us > c->max_lag_us) c->max_lag_us = lag_us;
+    pthread_mutex_unlock(&c->lock);
+}
+
+// ─── Tick thread ──────────────────────────────────────────
+// Deadlines are absolute, so time spent in the phases never pushes
+// later ticks back. A tick whose phases overran the next deadline
+// starts at once; one that fell a whole tick behind restarts the
+// schedule from now instead of firing a burst of catch-up ticks.
+void *tick_clock_thread(void *arg) {
+    SimContext *ctx = arg;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    do {
+        ts_add_ms(&next, TIME_TICK_MS);
+        long lag = now_us() - ts_us(&next);
+        if (lag > 0) {
+            tick_clock_late(ctx, lag);
+            if (lag >= TIME_TICK_MS * 1000L) clock_gettime(CLOCK_MONOTONIC, &next);
+        } else {
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) ;
+        }
+    } while (tick_clock_tick(ctx, NULL) == 0);
+    return NULL;
+}
+
+// ─── Phase threads ───────────────────────────────────────
+int tick_phase_begin(SimContext *ctx, TickPhase phase, int last) {
+    TickClock *c = ctx->clock;
+    pthread_mutex_lock(&c->lock);
+    while (!c->stopped && !(c->open == (int)phase && c->tick > last))
+        pthread_cond_wait(&c->changed, &c->lock);
+    int tick = c->stopped ? -1 : c->tick;
+    pthread_mutex_unlock(&c->lock);
+    return tick;
+}
+
+void tick_phase_end(SimContext *ctx, TickPhase phase) {
+    TickClock *c = ctx->clock;
+    pthread_mutex_lock(&c->lock);
+    if (c->open == (int)phase) c->open = -1;
+    pthread_cond_broadcast(&c->changed);
+    pthread_mutex_unlock(&c->lock);
+}
+
+// ─── Observers ───────────────────────────────────────────
+int tick_clock_wait(SimContext *ctx, int last) {
+    TickClock *c = ctx->clock;
+    pthread_mutex_lock(&c->lock);
+    while (!c->stopped && c->completed <= last)
+        pthread_cond_wait(&c->changed, &c->lock);
+    int tick = c->stopped ? -1 : c->completed;
+    pthread_mutex_unlock(&c->lock);
+    return tick;
+}
+
+void tick_clock_stats(SimContext *ctx, TickClockStats *out) {
+    TickClock *c = ctx->clock;
+    pthread_mutex_lock(&c->lock);
+    out->ticks      = c->ticks;
+    out->overruns   = c->overruns;
+    out->max_lag_us = c->max_lag_us;
+    pthread_mutex_unlock(&c->lock);
+    out->busy_p50_us = hist_percentile(&c->busy_hist, 50.0);
+    out->busy_p99_us = hist_percentile(&c->busy_hist, 99.0);
+    for (int p = 0; p < TICK_PHASES; p++)
+        out->phase_p99_us[p] = hist_percentile(&c->phase_hist[p], 99.0);
+}
+
+const char *tick_phase_name(TickPhase phase) {
+    return phase >= 0 && phase < TICK_PHASES ? phase_names[phase] : "?";
+}
@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timer_wheel.h"
+
+#define TW_LEVELS 4
+#define TW_BITS   6
+#define TW_SLOTS  (1 << TW_BITS)
+#define TW_MASK   (TW_SLOTS - 1)
+
+// ─── Intrusive timer node (one per pid) ──────────────────
+typedef struct TimerNode {
+    long               expires;
+    struct TimerNode **home;        // list this node sits on (NULL = disarmed)
+    struct TimerNode  *prev, *next;
+} TimerNode;
+
+struct TimerWheel {
+    TimerNode  nodes[MAX_STUDENTS + 1];      // indexed by pid
+    TimerNode *wheel[TW_LEVELS][TW_SLOTS];   // list heads
+    long       wheel_now;                    // next tick to process
+    int        armed_count;
+    pthread_mutex_t tw_lock;
+};
+
+// ─── List helpers ────────────────────────────────────────
+static void list_push(TimerNode **head, TimerNode *n) {
+    n->home = head;
+    n->prev = NULL;
+    n->next = *head;
+    if (*head) (*head)->prev = n;
+    *head = n;
+}
+
+static void list_unlink(TimerNode *n) {
+    if (n->prev) n->prev->next = n->next;
+    else         *n->home      = n->next;
+    if (n->next) n->next->prev = n->prev;
+    n->home = NULL;
+    n->prev = n->next = NULL;
+}
+
+// Which list a node with this expiry belongs on, relative to wheel_now
+static TimerNode **slot_for(TimerWheel *tw, long expires) {
+    long delta = expires - tw->wheel_now;
+    if (delta < 0) return &tw->wheel[0][tw->wheel_now & TW_MASK];   // overdue: fire next
+
+    for (int level = 0; level < TW_LEVELS; level++) {
+        if (delta < (1L << (TW_BITS * (level + 1))))
+            return &tw->wheel[level][(expires >> (TW_BITS * level)) & TW_MASK];
+    }
+    // Beyond the horizon: park in the top-level slot cascaded last,
+    // it gets re-filed (and eventually lands lower) on each lap
+    long top = (tw->wheel_now >> (TW_BITS * (TW_LEVELS - 1))) - 1;
+    return &tw->wheel[TW_LEVELS - 1][top & TW_MASK];
+}
+
+TimerWheel *timer_wheel_create(long start_tick) {
+    TimerWheel *tw = calloc(1, sizeof(TimerWheel));
+    if (!tw) return NULL;
+    pthread_mutex_init(&tw->tw_lock, NULL);
+    tw->wheel_now = start_tick;
+    return tw;
+}
+
+void timer_wheel_reset(TimerWheel *tw, long start_tick) {
+    pthread_mutex_lock(&tw->tw_lock);
+    memset(tw->nodes, 0, sizeof(tw->nodes));
+    memset(tw->wheel, 0, sizeof(tw->wheel));
+    tw->wheel_now   = start_tick;
+    tw->armed_count = 0;
+    pthread_mutex_unlock(&tw->tw_lock);
+}
+
+void timer_wheel_destroy(TimerWheel *tw) {
+    if (!tw) return;
+    pthread_mutex_destroy(&tw->tw_lock);
+    free(tw);
+}
+
+// ─── Arm (or re-arm) a pid's deadline ────────────────────
+void timer_wheel_arm(TimerWheel *tw, int pid, long expires_tick) {
+    if (pid < 0 || pid > MAX_STUDENTS) return;
+
+    pthread_mutex_lock(&tw->tw_lock);
+    TimerNode *n = &tw->nodes[pid];
+    if (n->home) list_unlink(n);
+    else         tw->armed_count++;
+    n->expires = expires_tick;
+    list_push(slot_for(tw, expires_tick), n);
+    pthread_mutex_unlock(&tw->tw_lock);
+}
+
+void timer_wheel_cancel(TimerWheel *tw, int pid) {
+    if (pid < 0 || pid > MAX_STUDENTS) return;
+
+    pthread_mutex_lock(&tw->tw_lock);
+    TimerNode *n = &tw->nodes[pid];
+    if (n->home) {
+        list_unlink(n);
+        tw->armed_count--;
+    }
+    pthread_mutex_unlock(&tw->tw_lock);
+}
+
+// Re-file every node of a higher-level slot one level down
+static int cascade(TimerWheel *tw, int level, int slot) {
+    TimerNode *n = tw->wheel[level][slot];
+    tw->wheel[level][slot] = NULL;
+
+    while (n) {
+        TimerNode *next = n->next;
+        n->home = NULL;
+        list_push(slot_for(tw, n->expires), n);
+        n = next;
+    }
+    return slot;
+}
+
+// ─── Advance to now_tick, firing everything due ──────────
+// Expired pids are collected under the lock and reported after it is
+// released, so on_expire may freely call back into arm/cancel.
+int timer_wheel_advance(TimerWheel *tw, long now_tick,
+                        timer_expire_fn on_expire, void *arg) {
+    int expired[MAX_STUDENTS + 1];
+    int fired = 0;
+
+    pthread_mutex_lock(&tw->tw_lock);
+    while (tw->wheel_now <= now_tick) {
+        int index = tw->wheel_now & TW_MASK;
+
+        // Slot 0 of a level means the next level's current slot is due
+        if (index == 0) {
+            for (int level = 1; level < TW_LEVELS; level++) {
+                int slot = (tw->wheel_now >> (TW_BITS * level)) & TW_MASK;
+                if (cascade(tw, level, slot) != 0) break;
+            }
+        }
+
+        TimerNode *n = tw->wheel[0][index];
+        tw->wheel[0][index] = NULL;
+        while (n) {
+            TimerNode *next = n->next;
+            n->home = NULL;
+            n->prev = n->next = NULL;
+            tw->armed_count--;
+            expired[fired++] = (int)(n - tw->nodes);
+            n = next;
+        }
+        tw->wheel_now++;
+    }
+    pthread_mutex_unlock(&tw->tw_lock);
+
+    for (int i = 0; i < fired; i++)
+        on_expire(arg, expired[i]);
+    return fired;
+}
+
+int timer_wheel_armed(TimerWheel *tw) {
+    pthread_mutex_lock(&tw->tw_lock);
+    int n = tw->armed_count;
+    pthread_mutex_unlock(&tw->tw_lock);
+    return n;
+}
+
+// ─── Snapshot ────────────────────────────────────────────
+// Slots are a function of wheel_now and each expiry, so the lists
+// themselves are not saved: re-arming every deadline rebuilds them
+void timer_wheel_snapshot(TimerWheel *tw, SnapWriter *w) {
+    pthread_mutex_lock(&tw->tw_lock);
+    snap_put(w, &tw->wheel_now,   sizeof(tw->wheel_now));
+    snap_put(w, &tw->armed_count, sizeof(tw->armed_count));
+    for (int pid = 0; pid <= MAX_STUDENTS; pid++) {
+        if (!tw->nodes[pid].home) continue;
+        snap_put(w, &pid, sizeof(pid));
+        snap_put(w, &tw->nodes[pid].expires, sizeof(tw->nodes[pid].expires));
+    }
+    pthread_mutex_unlock(&tw->tw_lock);
+}
+
+void timer_wheel_restore(TimerWheel *tw, SnapReader *r) {
+    long now;
+    int  armed;
+    snap_get(r, &now,   sizeof(now));
+    snap_get(r, &armed, sizeof(armed));
+    if (armed < 0 || armed > MAX_STUDENTS + 1) r->failed = 1;
+    if (r->failed) return;
+
+    timer_wheel_reset(tw, now);
+    for (int i = 0; i < armed; i++) {
+        int  pid;
+        long expires;
+        snap_get(r, &pid,     sizeof(pid));
+        snap_get(r, &expires, sizeof(expires));
+        if (r->failed) return;
+        timer_wheel_arm(tw, pid, expires);
+    }
+}
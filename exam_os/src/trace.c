@@ -0,0 +1,457 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "trace.h"
+
+// Capture appends from whichever phase generated the event and replay
+// cursors are read by the phase that owns them. Phases never overlap
+// (the tick clock runs them one after another), so neither needs a lock.
+typedef struct Trace {
+    // ─── Capture ─────────────────────────────────────────
+    int          capturing;
+    TraceRecord *cap;
+    long         cap_len, cap_size;
+
+    // ─── Replay ──────────────────────────────────────────
+    int          replaying;
+    TraceHeader  hdr;
+    TraceRecord *rec;
+    long        *logins, n_logins, login_pos;     // by tick
+    long        *storms, n_storms, storm_pos;
+    long        *owned;                           // MEM + SUBMIT, grouped by pid
+    long         pid_off[MAX_STUDENTS + 2];       // owned[pid_off[p] .. pid_off[p+1])
+    long         pid_pos[MAX_STUDENTS + 1];
+    int          spent[MAX_STUDENTS + 1];         // this run tick fell back
+    long         replayed, fallback_ticks;
+    char         path[256];
+} Trace;
+
+// ─── Reading a trace: binary or text ─────────────────────
+typedef struct {
+    TraceHeader  hdr;
+    TraceRecord *rec;
+    long         n, size;
+} TraceFile;
+
+static int push(TraceFile *tf, const TraceRecord *r) {
+    if (tf->n == tf->size) {
+        long size = tf->size ? tf->size * 2 : 1024;
+        TraceRecord *rec = realloc(tf->rec, size * sizeof(TraceRecord));
+        if (!rec) return -1;
+        tf->rec  = rec;
+        tf->size = size;
+    }
+    tf->rec[tf->n++] = *r;
+    return 0;
+}
+
+static const char *check_record(const TraceRecord *r) {
+    if (r->tick < 0) return "negative tick";
+    switch (r->type) {
+    case TRACE_LOGIN:
+        if (r->pid < 1 || r->pid > MAX_STUDENTS) return "pid out of range";
+        if (r->a < 1) return "exam length must be positive";
+        return NULL;
+    case TRACE_MEM:
+        if (r->pid < 1 || r->pid > MAX_STUDENTS) return "pid out of range";
+        if (r->a < 0 || r->a >= MAX_PAGES) return "page out of range";
+        return NULL;
+    case TRACE_SUBMIT:
+        if (r->pid < 1 || r->pid > MAX_STUDENTS) return "pid out of range";
+        if (r->a < 1 || r->a > 10) return "question must be 1-10";
+        if (r->b < 1 || r->b > MAX_ANSWER_BYTES) return "answer size out of range";
+        if (r->flags >= 30) return "roll must be 0-29";
+        return NULL;
+    case TRACE_STORM:
+        if (r->a < 1 || r->a > MAX_STUDENTS) return "storm size out of range";
+        return NULL;
+    }
+    return "unknown event";
+}
+
+static char *next_word(char **s) {
+    while (isspace((unsigned char)**s)) (*s)++;
+    if (!**s) return NULL;
+    char *w = *s;
+    while (**s && !isspace((unsigned char)**s)) (*s)++;
+    if (**s) *(*s)++ = '\0';
+    return w;
+}
+
+static int reject(const char *path, long lineno, const char *why) {
+    fprintf(stderr, "  %s:%ld: %s\n", path, lineno, why);
+    return -1;
+}
+
+static int parse_text(FILE *f, const char *path, TraceFile *tf) {
+    char line[1024];
+    long lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *s = line, *tick = next_word(&s), *event = next_word(&s);
+        if (!tick) continue;
+        if (!event) goto bad;
+        // SEED <n>: what the trace doesn't hold (storm questions, answer
+        // text) is drawn from the streams of this seed
+        if (strcmp(tick, "SEED") == 0) {
+            char *end;
+            tf->hdr.seed = strtoull(event, &end, 10);
+            if (*end || next_word(&s)) goto bad;
+            continue;
+        }
+
+        TraceRecord r = { .tick = atoi(tick) };
+        char *w;
+        if (strcmp(event, "STORM") == 0) {
+            r.type = TRACE_STORM;
+            if (!(w = next_word(&s))) goto bad;
+            r.a = atoi(w);
+        } else {
+            if (!(w = next_word(&s))) goto bad;
+            r.pid = atoi(w);
+            if (strcmp(event, "LOGIN") == 0) {
+                r.type = TRACE_LOGIN;
+                if (!(w = next_word(&s))) goto bad;
+                r.a = atoi(w);
+            } else if (strcmp(event, "SUBMIT") == 0) {
+                r.type = TRACE_SUBMIT;
+                char *q = next_word(&s), *bytes = next_word(&s), *roll = next_word(&s);
+                if (!q || !bytes) goto bad;
+                r.a     = atoi(q);
+                r.b     = atoi(bytes);
+                r.flags = roll ? atoi(roll) : 0;
+            } else if (strcmp(event, "MEM") == 0) {
+                // One line is one run tick: its pages, each optionally 'w'
+                r.type = TRACE_MEM;
+                int n = 0;
+                while ((w = next_word(&s))) {
+                    if (n == TRACE_MAX_BURST)
+                        return reject(path, lineno, "too many pages on one MEM line");
+                    size_t len = strlen(w);
+                    r.flags = len > 1 && w[len - 1] == 'w' ? TRACE_WRITE : 0;
+                    r.a     = atoi(w);
+                    const char *why = check_record(&r);
+                    if (why) return reject(path, lineno, why);
+                    if (n++ > 0) tf->rec[tf->n - 1].flags &= ~TRACE_LAST;
+                    r.flags |= TRACE_LAST;
+                    if (push(tf, &r) != 0) return -1;
+                }
+                if (n == 0) goto bad;
+                continue;
+            } else {
+                goto bad;
+            }
+        }
+        const char *why = check_record(&r);
+        if (why) return reject(path, lineno, why);
+        if (push(tf, &r) != 0) return -1;
+        continue;
+bad:
+        return reject(path, lineno, "expected SEED <n> or <tick> LOGIN|MEM|SUBMIT|STORM ...");
+    }
+    return 0;
+}
+
+static void free_file(TraceFile *tf) {
+    free(tf->rec);
+    tf->rec = NULL;
+}
+
+// Binary if it starts with the magic, otherwise the text form
+static int load(const char *path, TraceFile *tf) {
+    memset(tf, 0, sizeof(*tf));
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "  Cannot open trace %s\n", path);
+        return -1;
+    }
+
+    int rc = 0;
+    if (fread(&tf->hdr, sizeof(tf->hdr), 1, f) == 1 && tf->hdr.magic == TRACE_MAGIC) {
+        if (tf->hdr.version != TRACE_VERSION) {
+            fprintf(stderr, "  %s: unsupported trace version %u\n", path, tf->hdr.version);
+            rc = -1;
+        }
+        for (long i = 0; rc == 0 && i < tf->hdr.records; i++) {
+            TraceRecord r;
+            const char *why = NULL;
+            if (fread(&r, sizeof(r), 1, f) != 1) why = "file ends early";
+            else why = check_record(&r);
+            if (why) {
+                fprintf(stderr, "  %s: record %ld: %s\n", path, i, why);
+                rc = -1;
+            } else if (push(tf, &r) != 0) {
+                rc = -1;
+            }
+        }
+    } else {
+        rewind(f);
+        memset(&tf->hdr, 0, sizeof(tf->hdr));
+        rc = parse_text(f, path, tf);
+        // Imported traces: the students are the ones that log in
+        for (long i = 0; i < tf->n; i++)
+            if (tf->rec[i].type == TRACE_LOGIN && tf->rec[i].pid > tf->hdr.num_students)
+                tf->hdr.num_students = tf->rec[i].pid;
+    }
+    fclose(f);
+
+    // A pid logs in once; nothing else refers to a pid that never does
+    int seen[MAX_STUDENTS + 1] = { 0 };
+    for (long i = 0; rc == 0 && i < tf->n; i++)
+        if (tf->rec[i].type == TRACE_LOGIN && seen[tf->rec[i].pid]++) {
+            fprintf(stderr, "  %s: PID %d logs in twice\n", path, tf->rec[i].pid);
+            rc = -1;
+        }
+    for (long i = 0; rc == 0 && i < tf->n; i++)
+        if (tf->rec[i].type != TRACE_LOGIN && tf->rec[i].type != TRACE_STORM &&
+            !seen[tf->rec[i].pid]) {
+            fprintf(stderr, "  %s: PID %d never logs in\n", path, tf->rec[i].pid);
+            rc = -1;
+        }
+    if (rc == 0 && tf->hdr.num_students < 1) {
+        fprintf(stderr, "  %s: no LOGIN events\n", path);
+        rc = -1;
+    }
+    if (rc != 0) free_file(tf);
+    return rc;
+}
+
+int trace_check(const char *path, Config *cfg) {
+    TraceFile tf;
+    if (load(path, &tf) != 0) return -1;
+    cfg->num_students = tf.hdr.num_students;
+    if (tf.hdr.seed) cfg->seed = tf.hdr.seed;
+    free_file(&tf);
+    return 0;
+}
+
+// ─── Text dump ───────────────────────────────────────────
+int trace_dump(const char *path) {
+    TraceFile tf;
+    if (load(path, &tf) != 0) return -1;
+    printf("# %s: %ld events, %d students\n", path, tf.n, tf.hdr.num_students);
+    printf("# SEED <n> | <tick> LOGIN <pid> <exam_ticks> | MEM <pid> <page>[w]... |"
+           " SUBMIT <pid> <question> <bytes> <roll> | STORM <submissions>\n");
+    if (tf.hdr.seed) printf("SEED %llu\n", (unsigned long long)tf.hdr.seed);
+
+    for (long i = 0; i < tf.n; i++) {
+        const TraceRecord *r = &tf.rec[i];
+        switch (r->type) {
+        case TRACE_LOGIN:
+            printf("%6d LOGIN  %3d %d\n", r->tick, r->pid, r->a);
+            break;
+        case TRACE_SUBMIT:
+            printf("%6d SUBMIT %3d %d %d %d\n", r->tick, r->pid, r->a, r->b, r->flags);
+            break;
+        case TRACE_STORM:
+            printf("%6d STORM  %d\n", r->tick, r->a);
+            break;
+        case TRACE_MEM:
+            // A burst is contiguous: the memory phase records it in one go
+            printf("%6d MEM    %3d", r->tick, r->pid);
+            for (int n = 0; ; n++) {
+                printf(" %d%s", tf.rec[i].a, tf.rec[i].flags & TRACE_WRITE ? "w" : "");
+                if ((tf.rec[i].flags & TRACE_LAST) || n + 1 == TRACE_MAX_BURST || i + 1 == tf.n ||
+                    tf.rec[i + 1].type != TRACE_MEM || tf.rec[i + 1].pid != r->pid)
+                    break;
+                i++;
+            }
+            printf("\n");
+            break;
+        }
+    }
+    free_file(&tf);
+    return 0;
+}
+
+// ─── Lifecycle ───────────────────────────────────────────
+// Stable insertion sort: captured traces are in tick order already,
+// imported ones nearly so
+static void sort_by_tick(long *idx, long n, const TraceRecord *rec) {
+    for (long i = 1; i < n; i++) {
+        long v = idx[i], j = i;
+        for (; j > 0 && rec[idx[j - 1]].tick > rec[v].tick; j--) idx[j] = idx[j - 1];
+        idx[j] = v;
+    }
+}
+
+int trace_init(SimContext *ctx) {
+    const Config *cfg = &ctx->config;
+    Trace *t = calloc(1, sizeof(Trace));
+    if (!t) return -1;
+    ctx->trace = t;
+    t->capturing = cfg->trace_capture;
+    snprintf(t->path, sizeof(t->path), "%s", cfg->replay_path);
+    if (!cfg->replay_path[0]) return 0;
+
+    TraceFile tf;
+    if (load(cfg->replay_path, &tf) != 0) {
+        trace_destroy(ctx);
+        return -1;
+    }
+    t->replaying = 1;
+    t->hdr       = tf.hdr;
+    t->rec       = tf.rec;
+    long n = tf.n;
+
+    // Logins and storms go by tick; the rest by pid, in file order
+    t->logins = malloc(sizeof(long) * (n + 1));
+    t->storms = malloc(sizeof(long) * (n + 1));
+    t->owned  = malloc(sizeof(long) * (n + 1));
+    for (long i = 0; i < n; i++) {
+        if      (t->rec[i].type == TRACE_LOGIN) t->logins[t->n_logins++] = i;
+        else if (t->rec[i].type == TRACE_STORM) t->storms[t->n_storms++] = i;
+        else t->pid_off[t->rec[i].pid + 1]++;
+    }
+    sort_by_tick(t->logins, t->n_logins, t->rec);
+    sort_by_tick(t->storms, t->n_storms, t->rec);
+    for (int p = 1; p <= MAX_STUDENTS + 1; p++) t->pid_off[p] += t->pid_off[p - 1];
+    for (int p = 0; p <= MAX_STUDENTS; p++) t->pid_pos[p] = t->pid_off[p];
+    for (long i = 0; i < n; i++)
+        if (t->rec[i].type == TRACE_MEM || t->rec[i].type == TRACE_SUBMIT)
+            t->owned[t->pid_pos[t->rec[i].pid]++] = i;
+    for (int p = 0; p <= MAX_STUDENTS; p++) t->pid_pos[p] = t->pid_off[p];
+    return 0;
+}
+
+void trace_write(SimContext *ctx) {
+    Trace *t = ctx->trace;
+    if (!t->capturing) return;
+
+    char path[192];
+    snprintf(path, sizeof(path), "%s/" TRACE_FILE, ctx->config.output_dir);
+    TraceHeader h = {
+        .magic         = TRACE_MAGIC,
+        .version       = TRACE_VERSION,
+        .seed          = ctx->config.seed,
+        .num_students  = ctx->config.num_students,
+        .exam_duration = ctx->config.exam_duration,
+        .records       = t->cap_len
+    };
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(&h, sizeof(h), 1, f) != 1 ||
+        (t->cap_len && fwrite(t->cap, sizeof(TraceRecord), t->cap_len, f) != (size_t)t->cap_len) ||
+        fclose(f) != 0) {
+        fprintf(stderr, "  Cannot write trace %s\n", path);
+        return;
+    }
+    snprintf(t->path, sizeof(t->path), "%s", path);
+}
+
+void trace_destroy(SimContext *ctx) {
+    Trace *t = ctx->trace;
+    if (!t) return;
+    free(t->cap);
+    free(t->rec);
+    free(t->logins);
+    free(t->storms);
+    free(t->owned);
+    free(t);
+    ctx->trace = NULL;
+}
+
+void trace_stats(SimContext *ctx, TraceStats *out) {
+    Trace *t = ctx->trace;
+    memset(out, 0, sizeof(*out));
+    out->capturing      = t->capturing;
+    out->replaying      = t->replaying;
+    out->captured       = t->cap_len;
+    out->replayed       = t->replayed;
+    out->fallback_ticks = t->fallback_ticks;
+    snprintf(out->path, sizeof(out->path), "%s", t->path);
+}
+
+// ─── Capture ─────────────────────────────────────────────
+void trace_record(SimContext *ctx, int tick, int pid, TraceEventType type,
+                  int flags, int a, int b) {
+    Trace *t = ctx->trace;
+    if (!t->capturing) return;
+    if (t->cap_len == t->cap_size) {
+        long size = t->cap_size ? t->cap_size * 2 : 4096;
+        TraceRecord *cap = realloc(t->cap, size * sizeof(TraceRecord));
+        if (!cap) return;            // the trace ends short, the run goes on
+        t->cap      = cap;
+        t->cap_size = size;
+    }
+    t->cap[t->cap_len++] = (TraceRecord){
+        .tick = tick, .pid = pid, .type = type, .flags = flags, .a = a, .b = b
+    };
+}
+
+// ─── Replay ──────────────────────────────────────────────
+int trace_replaying(SimContext *ctx) {
+    return ctx->trace->replaying;
+}
+
+// Every login due by this tick, oldest first
+int trace_logins(SimContext *ctx, int tick, int *pids, int *exam_ticks, int max) {
+    Trace *t = ctx->trace;
+    int n = 0;
+    while (n < max && t->login_pos < t->n_logins &&
+           t->rec[t->logins[t->login_pos]].tick <= tick) {
+        const TraceRecord *r = &t->rec[t->logins[t->login_pos++]];
+        pids[n]       = r->pid;
+        exam_ticks[n] = r->a;
+        n++;
+    }
+    t->replayed += n;
+    return n;
+}
+
+int trace_storm(SimContext *ctx, int tick) {
+    Trace *t = ctx->trace;
+    int n = 0;
+    while (t->storm_pos < t->n_storms && t->rec[t->storms[t->storm_pos]].tick <= tick) {
+        n += t->rec[t->storms[t->storm_pos++]].a;
+        t->replayed++;
+    }
+    return n;
+}
+
+int trace_accesses(SimContext *ctx, int pid, TraceAccess *out) {
+    Trace *t = ctx->trace;
+    if (!t->replaying || pid < 1 || pid > MAX_STUDENTS) return -1;
+    long end = t->pid_off[pid + 1];
+
+    // A submission without a burst before it is dropped, not shifted
+    // onto a later tick
+    while (t->pid_pos[pid] < end && t->rec[t->owned[t->pid_pos[pid]]].type == TRACE_SUBMIT)
+        t->pid_pos[pid]++;
+    t->spent[pid] = t->pid_pos[pid] == end;
+    if (t->spent[pid]) {
+        t->fallback_ticks++;
+        return -1;
+    }
+
+    int n = 0;
+    while (n < TRACE_MAX_BURST && t->pid_pos[pid] < end) {
+        const TraceRecord *r = &t->rec[t->owned[t->pid_pos[pid]]];
+        if (r->type != TRACE_MEM) break;
+        out[n].page  = r->a;
+        out[n].write = r->flags & TRACE_WRITE;
+        n++;
+        t->pid_pos[pid]++;
+        if (r->flags & TRACE_LAST) break;
+    }
+    t->replayed += n;
+    return n;
+}
+
+int trace_submission(SimContext *ctx, int pid, TraceSubmit *out) {
+    Trace *t = ctx->trace;
+    if (!t->replaying || pid < 1 || pid > MAX_STUDENTS || t->spent[pid]) return -1;
+    long pos = t->pid_pos[pid];
+    if (pos == t->pid_off[pid + 1] || t->rec[t->owned[pos]].type != TRACE_SUBMIT)
+        return 0;
+
+    const TraceRecord *r = &t->rec[t->owned[pos]];
+    out->question = r->a;
+    out->bytes    = r->b;
+    out->roll     = r->flags;
+    t->pid_pos[pid]++;
+    t->replayed++;
+    return 1;
+}
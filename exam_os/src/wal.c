@@ -0,0 +1,486 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "wal.h"
+#include "histogram.h"
+#include "submission_store.h"   // store_crc32
+
+typedef struct {
+    uint32_t id;
+    uint64_t max_lsn;         // highest SUBMIT in the segment
+} SealedSegment;
+
+struct Wal {
+    char            dir[128];
+    int             commit_ms;
+    int             fd;              // active segment: committer only
+    uint32_t        seg_id;
+    long            seg_bytes;
+    uint64_t        seg_max_lsn;
+
+    // Appenders fill buf[active]; the committer writes the other one
+    char           *buf[2];
+    size_t          cap[2];
+    size_t          len;             // bytes in buf[active]
+    int             active;
+    uint64_t        appended_lsn;    // highest SUBMIT appended
+    uint64_t        durable_lsn;     // highest SUBMIT on disk
+    int             error;           // errno of the first failure; sticky
+    long            first_us;        // when the pending group opened
+    int             wanted;          // a group is open
+    int             stop;
+    pthread_mutex_t lock;
+    pthread_cond_t  work, done;
+    pthread_t       committer;
+
+    SealedSegment  *sealed;          // guarded by lock
+    int             nsealed, sealed_cap;
+    uint64_t        checkpoint;
+
+    long            records, commits, bytes, dropped_segments;
+    Histogram       commit_hist;     // write + fdatasync, µs
+};
+
+// ─── Helpers ──────────────────────────────────────────────
+static long now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+}
+
+static void segment_path(char *out, size_t len, const char *dir, uint32_t id) {
+    snprintf(out, len, "%s/wal-%06u.log", dir, id);
+}
+
+static int mkdir_p(const char *path) {
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        mkdir(tmp, 0755);
+        *p = '/';
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST ? 0 : -1;
+}
+
+// CRC covers the header from `type` on, then the answer
+static uint32_t record_crc(const WalRecordHeader *h, const void *answer) {
+    const size_t skip = offsetof(WalRecordHeader, type);
+    uint32_t crc = store_crc32(0, (const char *)h + skip, sizeof(*h) - skip);
+    return store_crc32(crc, answer, h->len);
+}
+
+static int write_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p   += w;
+        len -= w;
+    }
+    return 0;
+}
+
+// Caller holds w->lock. -1 if the record could not be buffered: the
+// log has a hole from here on, so it fails
+static int buf_put(Wal *w, const WalRecordHeader *h, const char *answer) {
+    size_t need = w->len + sizeof(*h) + h->len;
+    int    a    = w->active;
+    if (need > w->cap[a]) {
+        size_t cap = w->cap[a] ? w->cap[a] * 2 : 64 * 1024;
+        while (cap < need) cap *= 2;
+        char *p = realloc(w->buf[a], cap);
+        if (!p) {
+            if (!w->error) w->error = ENOMEM;
+            return -1;
+        }
+        w->buf[a] = p;
+        w->cap[a] = cap;
+    }
+    memcpy(w->buf[a] + w->len, h, sizeof(*h));
+    memcpy(w->buf[a] + w->len + sizeof(*h), answer, h->len);
+    w->len = need;
+    return 0;
+}
+
+static void control_record(Wal *w, WalRecordType type, uint64_t lsn) {
+    WalRecordHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = WAL_MAGIC;
+    h.type  = type;
+    h.lsn   = lsn;
+    h.crc   = record_crc(&h, "");
+    buf_put(w, &h, "");
+}
+
+// Caller holds w->lock
+static void open_group(Wal *w) {
+    if (w->wanted) return;
+    w->wanted   = 1;
+    w->first_us = now_us();
+    pthread_cond_signal(&w->work);
+}
+
+static int open_segment(Wal *w, uint32_t id) {
+    char path[160];
+    segment_path(path, sizeof(path), w->dir, id);
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+}
+
+// ─── Committer: one write + fdatasync per group ──────────
+// A group opens with the first record after a commit and closes
+// commit_ms later; everything appended meanwhile shares its sync.
+static void *committer_thread(void *arg) {
+    Wal *w = arg;
+
+    pthread_mutex_lock(&w->lock);
+    while (1) {
+        while (!w->wanted && !w->stop) pthread_cond_wait(&w->work, &w->lock);
+        if (!w->wanted && w->len == 0) break;   // stopping, nothing left
+
+        if (w->commit_ms > 0 && !w->stop) {
+            long wait_us = w->first_us + w->commit_ms * 1000L - now_us();
+            if (wait_us > 0) {
+                pthread_mutex_unlock(&w->lock);
+                usleep(wait_us);
+                pthread_mutex_lock(&w->lock);
+            }
+        }
+        int      a    = w->active;
+        size_t   len  = w->len;
+        uint64_t upto = w->appended_lsn;
+        w->active = !a;
+        w->len    = 0;
+        w->wanted = 0;
+        pthread_mutex_unlock(&w->lock);
+
+        long t0 = now_us();
+        int  rc = 0;
+        if (write_all(w->fd, w->buf[a], len) != 0 || fdatasync(w->fd) != 0)
+            rc = errno ? errno : EIO;
+        hist_record(&w->commit_hist, now_us() - t0);
+        w->seg_bytes  += len;
+        w->seg_max_lsn = upto;
+
+        // Roll: seal the segment, the checkpoint will delete it
+        if (w->seg_bytes >= WAL_SEGMENT_BYTES) {
+            int fd = open_segment(w, w->seg_id + 1);
+            if (fd >= 0) {
+                pthread_mutex_lock(&w->lock);
+                if (w->nsealed == w->sealed_cap) {
+                    int cap = w->sealed_cap ? w->sealed_cap * 2 : 8;
+                    SealedSegment *s = realloc(w->sealed, sizeof(SealedSegment) * cap);
+                    if (s) {
+                        w->sealed     = s;
+                        w->sealed_cap = cap;
+                    }
+                }
+                if (w->nsealed < w->sealed_cap)
+                    w->sealed[w->nsealed++] = (SealedSegment){ w->seg_id, w->seg_max_lsn };
+                pthread_mutex_unlock(&w->lock);
+                close(w->fd);
+                w->fd = fd;
+                w->seg_id++;
+                w->seg_bytes = 0;
+            }
+        }
+
+        // After a failure the segment may hold a torn record, which
+        // recovery stops at: no later group is durable either
+        pthread_mutex_lock(&w->lock);
+        if (rc && !w->error) w->error = rc;
+        if (!w->error) {
+            w->durable_lsn = upto;
+            w->commits++;
+            w->bytes += len;
+        }
+        pthread_cond_broadcast(&w->done);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+// ─── Writer ──────────────────────────────────────────────
+Wal *wal_open(const char *dir, int commit_ms) {
+    if (mkdir_p(dir) != 0) return NULL;
+    wal_remove(dir);
+
+    Wal *w = calloc(1, sizeof(Wal));
+    if (!w) return NULL;
+    snprintf(w->dir, sizeof(w->dir), "%s", dir);
+    w->commit_ms = commit_ms > 0 ? commit_ms : 0;
+    w->fd        = open_segment(w, 0);
+    if (w->fd < 0) {
+        free(w);
+        return NULL;
+    }
+    hist_reset(&w->commit_hist);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->work, NULL);
+    pthread_cond_init(&w->done, NULL);
+    pthread_create(&w->committer, NULL, committer_thread, w);
+    return w;
+}
+
+void wal_append(Wal *w, uint64_t lsn, uint64_t carrier, const Submission *s, const char *answer) {
+    if (!w) return;
+    WalRecordHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic       = WAL_MAGIC;
+    h.len         = s->answer.len;
+    h.type        = WAL_SUBMIT;
+    h.lsn         = lsn;
+    h.pid         = s->pid;
+    h.question_id = s->question_id;
+    h.timestamp   = s->timestamp;
+    h.is_partial  = s->is_partial;
+    h.carrier_lsn = carrier;
+    h.crc         = record_crc(&h, answer);
+
+    pthread_mutex_lock(&w->lock);
+    if (buf_put(w, &h, answer) == 0) {
+        if (lsn > w->appended_lsn) w->appended_lsn = lsn;
+        w->records++;
+    }
+    open_group(w);
+    pthread_mutex_unlock(&w->lock);
+}
+
+int wal_wait(Wal *w, uint64_t lsn) {
+    if (!w) return 0;
+    pthread_mutex_lock(&w->lock);
+    while (w->durable_lsn < lsn && !w->error) pthread_cond_wait(&w->done, &w->lock);
+    int rc = w->durable_lsn >= lsn ? 0 : -1;
+    pthread_mutex_unlock(&w->lock);
+    return rc;
+}
+
+int wal_error(Wal *w) {
+    if (!w) return 0;
+    pthread_mutex_lock(&w->lock);
+    int err = w->error;
+    pthread_mutex_unlock(&w->lock);
+    return err;
+}
+
+void wal_checkpoint(Wal *w, uint64_t lsn) {
+    if (!w) return;
+    uint32_t drop[64];
+    int      ndrop = 0;
+
+    pthread_mutex_lock(&w->lock);
+    if (lsn <= w->checkpoint) {
+        pthread_mutex_unlock(&w->lock);
+        return;
+    }
+    w->checkpoint = lsn;
+    control_record(w, WAL_CHECKPOINT, lsn);
+    open_group(w);   // an idle shard must not keep a stale checkpoint
+    int keep = 0;
+    for (int i = 0; i < w->nsealed; i++) {
+        if (w->sealed[i].max_lsn <= lsn && ndrop < 64) drop[ndrop++] = w->sealed[i].id;
+        else                                           w->sealed[keep++] = w->sealed[i];
+    }
+    w->nsealed = keep;
+    w->dropped_segments += ndrop;
+    pthread_mutex_unlock(&w->lock);
+
+    for (int i = 0; i < ndrop; i++) {
+        char path[160];
+        segment_path(path, sizeof(path), w->dir, drop[i]);
+        unlink(path);
+    }
+}
+
+void wal_stats(Wal *w, WalStats *out) {
+    memset(out, 0, sizeof(WalStats));
+    if (!w) return;
+    pthread_mutex_lock(&w->lock);
+    out->records          = w->records;
+    out->commits          = w->commits;
+    out->bytes            = w->bytes;
+    out->segments_dropped = w->dropped_segments;
+    pthread_mutex_unlock(&w->lock);
+    out->commit_p99_us = hist_percentile(&w->commit_hist, 99.0);
+}
+
+void wal_close(Wal *w) {
+    if (!w) return;
+    pthread_mutex_lock(&w->lock);
+    control_record(w, WAL_CLOSE, w->appended_lsn);
+    w->stop = 1;
+    pthread_cond_signal(&w->work);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->committer, NULL);
+
+    close(w->fd);
+    pthread_cond_destroy(&w->done);
+    pthread_cond_destroy(&w->work);
+    pthread_mutex_destroy(&w->lock);
+    free(w->buf[0]);
+    free(w->buf[1]);
+    free(w->sealed);
+    free(w);
+}
+
+// ─── Recovery ────────────────────────────────────────────
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Segment ids in dir, ascending; caller frees
+static int list_segments(const char *dir, uint32_t **out) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    uint32_t *ids = NULL;
+    int       n = 0, cap = 0;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        unsigned id;
+        if (sscanf(e->d_name, "wal-%u.log", &id) != 1) continue;
+        if (n == cap) {
+            cap = cap ? cap * 2 : 16;
+            uint32_t *p = realloc(ids, sizeof(uint32_t) * cap);
+            if (!p) break;
+            ids = p;
+        }
+        ids[n++] = id;
+    }
+    closedir(d);
+    if (n > 1) qsort(ids, n, sizeof(uint32_t), cmp_u32);
+    *out = ids;
+    return n;
+}
+
+typedef void (*record_fn)(void *ctx, const WalRecordHeader *h, const char *answer);
+
+// Walk one segment's valid records; returns bytes mapped
+static long walk_segment(const char *dir, uint32_t id, record_fn fn, void *ctx) {
+    char path[160];
+    segment_path(path, sizeof(path), dir, id);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    char *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    size_t at = 0;
+    while (at + sizeof(WalRecordHeader) <= (size_t)st.st_size) {
+        const WalRecordHeader *h = (const WalRecordHeader *)(map + at);
+        if (h->magic != WAL_MAGIC || at + sizeof(*h) + h->len > (size_t)st.st_size) break;
+        const char *answer = (const char *)(h + 1);
+        if (record_crc(h, answer) != h->crc) break;   // torn tail
+        fn(ctx, h, answer);
+        at += sizeof(*h) + h->len;
+    }
+    munmap(map, st.st_size);
+    return st.st_size;
+}
+
+typedef struct {
+    WalScan *scan;
+    uint32_t last_type;
+    long     submits;
+} ScanState;
+
+static void scan_record(void *ctx, const WalRecordHeader *h, const char *answer) {
+    (void)answer;
+    ScanState *st = ctx;
+    st->last_type = h->type;
+    if (h->type == WAL_CHECKPOINT && h->lsn > st->scan->checkpoint) st->scan->checkpoint = h->lsn;
+    if (h->type == WAL_SUBMIT) {
+        st->submits++;
+        if (h->lsn > st->scan->max_lsn) st->scan->max_lsn = h->lsn;
+    }
+}
+
+// A SUBMIT still to apply past checkpoint `after`: its own LSN is above
+// it, and no applied submission carried its answer out
+static int unapplied(const WalRecordHeader *h, uint64_t after) {
+    return h->type == WAL_SUBMIT && h->lsn > after &&
+           (h->carrier_lsn == 0 || h->carrier_lsn > after);
+}
+
+typedef struct {
+    uint64_t after;
+    long     pending;
+} PendingCount;
+
+static void count_pending(void *ctx, const WalRecordHeader *h, const char *answer) {
+    (void)answer;
+    PendingCount *pc = ctx;
+    if (unapplied(h, pc->after)) pc->pending++;
+}
+
+int wal_scan(const char *dir, WalScan *out) {
+    memset(out, 0, sizeof(WalScan));
+    uint32_t *ids;
+    int n = list_segments(dir, &ids);
+    if (n <= 0) return -1;
+
+    ScanState st = { out, 0, 0 };
+    for (int i = 0; i < n; i++) out->bytes += walk_segment(dir, ids[i], scan_record, &st);
+    out->segments = n;
+    out->crashed  = st.last_type != WAL_CLOSE;
+
+    // The checkpoint may be logged after the records it covers
+    PendingCount pc = { out->checkpoint, 0 };
+    for (int i = 0; i < n; i++) walk_segment(dir, ids[i], count_pending, &pc);
+    out->pending = pc.pending;
+    free(ids);
+    return 0;
+}
+
+typedef struct {
+    uint64_t      after;
+    wal_replay_fn fn;
+    void         *ctx;
+    long          replayed;
+} ReplayState;
+
+static void replay_record(void *ctx, const WalRecordHeader *h, const char *answer) {
+    ReplayState *st = ctx;
+    if (!unapplied(h, st->after)) return;
+    st->fn(st->ctx, h, answer);
+    st->replayed++;
+}
+
+long wal_replay(const char *dir, uint64_t after, wal_replay_fn fn, void *ctx) {
+    uint32_t *ids;
+    int n = list_segments(dir, &ids);
+    if (n <= 0) return 0;
+    ReplayState st = { after, fn, ctx, 0 };
+    for (int i = 0; i < n; i++) walk_segment(dir, ids[i], replay_record, &st);
+    free(ids);
+    return st.replayed;
+}
+
+void wal_remove(const char *dir) {
+    uint32_t *ids;
+    int n = list_segments(dir, &ids);
+    if (n < 0) return;
+    for (int i = 0; i < n; i++) {
+        char path[160];
+        segment_path(path, sizeof(path), dir, ids[i]);
+        unlink(path);
+    }
+    free(ids);
+}
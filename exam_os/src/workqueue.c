@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workqueue.h"
+#include "logger.h"
+#include "snapshot.h"
+
+typedef struct {
+    work_fn fn;
+    int     pid;
+    long    raised_us;
+} WorkItem;
+
+typedef struct WorkQueue {
+    WorkItem  work_queue[WORKQ_CAPACITY];
+    int       wq_head, wq_tail, wq_count;
+    pthread_mutex_t wq_lock;
+    sem_t     wq_ready;
+    int       wq_running;
+
+    pthread_t workers[MAX_BH_WORKERS];
+    int       num_workers;
+} WorkQueue;
+
+// ─── Worker: drain deferred work until shut down + empty ─
+static void *worker_thread(void *arg) {
+    SimContext *ctx = arg;
+    WorkQueue  *q   = ctx->wq;
+
+    while (1) {
+        sem_wait(&q->wq_ready);
+
+        pthread_mutex_lock(&q->wq_lock);
+        if (q->wq_count == 0) {
+            int stop = !q->wq_running;
+            pthread_mutex_unlock(&q->wq_lock);
+            if (stop) break;
+            continue;
+        }
+        WorkItem w = q->work_queue[q->wq_head];
+        q->wq_head = (q->wq_head + 1) % WORKQ_CAPACITY;
+        q->wq_count--;
+        pthread_mutex_unlock(&q->wq_lock);
+
+        snapshot_enter(ctx);
+        w.fn(ctx, w.pid, w.raised_us);
+        snapshot_leave(ctx);
+    }
+    return NULL;
+}
+
+void workqueue_init(SimContext *ctx, int workers_wanted) {
+    if (workers_wanted < 1)              workers_wanted = 1;
+    if (workers_wanted > MAX_BH_WORKERS) workers_wanted = MAX_BH_WORKERS;
+
+    WorkQueue *q = calloc(1, sizeof(WorkQueue));
+    ctx->wq = q;
+    pthread_mutex_init(&q->wq_lock, NULL);
+    q->wq_running  = 1;
+    q->num_workers = workers_wanted;
+    sem_init(&q->wq_ready, 0, 0);
+
+    for (int i = 0; i < q->num_workers; i++)
+        pthread_create(&q->workers[i], NULL, worker_thread, ctx);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Bottom-half work queue started (%d workers)", q->num_workers);
+    log_event(ctx, "INFO", "INTERRUPT", msg);
+}
+
+void workqueue_shutdown(SimContext *ctx) {
+    WorkQueue *q = ctx->wq;
+    if (!q) return;
+
+    pthread_mutex_lock(&q->wq_lock);
+    q->wq_running = 0;
+    pthread_mutex_unlock(&q->wq_lock);
+
+    // One extra wake-up per worker so each sees the empty queue and exits
+    for (int i = 0; i < q->num_workers; i++) sem_post(&q->wq_ready);
+    for (int i = 0; i < q->num_workers; i++) pthread_join(q->workers[i], NULL);
+    q->num_workers = 0;
+    sem_destroy(&q->wq_ready);
+    pthread_mutex_destroy(&q->wq_lock);
+    free(q);
+    ctx->wq = NULL;
+}
+
+// ─── Defer work (never blocks, never drops) ──────────────
+// If the queue is full or already shut down the work runs inline:
+// slower for the caller, but a timeout's bottom half is never lost.
+void workqueue_defer(SimContext *ctx, work_fn fn, int pid, long raised_us) {
+    WorkQueue *q = ctx->wq;
+    if (q) {
+        pthread_mutex_lock(&q->wq_lock);
+        if (q->wq_running && q->wq_count < WORKQ_CAPACITY) {
+            WorkItem *w  = &q->work_queue[q->wq_tail];
+            w->fn        = fn;
+            w->pid       = pid;
+            w->raised_us = raised_us;
+            q->wq_tail = (q->wq_tail + 1) % WORKQ_CAPACITY;
+            q->wq_count++;
+            pthread_mutex_unlock(&q->wq_lock);
+            sem_post(&q->wq_ready);
+            return;
+        }
+        pthread_mutex_unlock(&q->wq_lock);
+    }
+
+    fn(ctx, pid, raised_us);
+}
+
+int workqueue_depth(SimContext *ctx) {
+    WorkQueue *q = ctx->wq;
+    if (!q) return 0;
+    pthread_mutex_lock(&q->wq_lock);
+    int n = q->wq_count;
+    pthread_mutex_unlock(&q->wq_lock);
+    return n;
+}